@@ -0,0 +1,112 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "autosave.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t edits = 20000;
+
+    struct Latency
+    {
+        std::chrono::nanoseconds mean;
+        std::chrono::nanoseconds p50;
+        std::chrono::nanoseconds p99;
+    };
+
+    // small inserts & erases at random positions, every one timed on its own
+    Latency edit(Document& doc, size_t count, const std::function<void()>& after_edit = {})
+    {
+        std::mt19937 rng{1};
+        std::vector<std::chrono::nanoseconds> samples;
+        samples.reserve(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t pos = std::uniform_int_distribution<size_t>{0, doc.length() - 10}(rng);
+
+            const auto start = std::chrono::steady_clock::now();
+            (i % 2 == 0) ? doc.insert(pos, "inserted text") : doc.erase(pos, 10);
+            if (after_edit)
+                after_edit();
+            samples.push_back(std::chrono::steady_clock::now() - start);
+        }
+
+        std::chrono::nanoseconds total{0};
+        for (auto sample : samples)
+            total += sample;
+
+        std::sort(samples.begin(), samples.end());
+        return {total / count, samples[count / 2], samples[count * 99 / 100]};
+    }
+
+    void print(const char* name, Latency latency)
+    {
+        cout << "  " << name << ": mean " << latency.mean.count() << " ns, p50 " << latency.p50.count() << " ns, p99 "
+             << latency.p99.count() << " ns\n";
+    }
+
+    void remove_files(const std::filesystem::path& path)
+    {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+        std::filesystem::remove(Autosave::lock_path(path), ignored);
+        for (const auto& segment : Journal::segments(Autosave::journal_base(path)))
+            std::filesystem::remove(segment, ignored);
+    }
+} // namespace
+
+int main()
+{
+    const std::string text(4 * 1024 * 1024, 'a');
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "document-editor-bench.autosave";
+
+    cout << edits << " edits of a 4 MiB document, latency per edit\n";
+
+    {
+        Document doc{text};
+        print("no autosave", edit(doc, edits));
+    }
+
+    remove_files(path);
+    {
+        Document doc{text};
+        Autosave autosave{doc, path, std::chrono::milliseconds{100}};
+
+        const Latency latency = edit(doc, edits);
+        autosave.sync();
+
+        const AutosaveStats stats = autosave.stats();
+        print("autosave", latency);
+        cout << "    " << stats.journal_records << " records in " << stats.journal_commits << " group commits, "
+             << stats.snapshots << " snapshots\n";
+    }
+
+    // what the journal would cost without group commit - one fsync per edit
+    remove_files(path);
+    {
+        Document doc{text};
+        Autosave autosave{doc, path, std::chrono::hours{1}};
+
+        print("autosave, fsync every edit", edit(doc, edits / 20, [&] { autosave.sync(); }));
+    }
+
+    {
+        Document doc;
+        const double seconds = best_time([&] { do_not_optimize(Autosave::recover(doc, path)); }, 1);
+        cout << "recovery of " << edits / 20 << " journaled edits: " << seconds * 1e3 << " ms\n";
+    }
+
+    remove_files(path);
+}
@@ -0,0 +1,131 @@
+#include "benchmark.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "application.hpp"
+#include "batch_console.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t script_commands = 1'000'000;
+
+    // 8 commands per cycle - Clear keeps the document small
+    std::string make_script()
+    {
+        const std::string cycle = "AddText\nhello world\nAddText\n - second line\nToUpper\nCopy\nPaste\nToLower\nPrint\nClear\n";
+
+        std::string script;
+        for (size_t i = 0; i < script_commands / 8; ++i)
+            script += cycle;
+
+        return script;
+    }
+
+    // console working like Terminal before batch mode - std::getline & std::endl on every line
+    class LineConsole : public Console
+    {
+        std::istream& in_;
+        std::ostream& out_;
+
+    public:
+        LineConsole(std::istream& in, std::ostream& out)
+            : in_{in}
+            , out_{out}
+        {
+        }
+
+        std::string get_line() override
+        {
+            std::string line;
+            if (!std::getline(in_, line))
+                throw EndOfInput{};
+
+            return line;
+        }
+
+        void print(const std::string& line) override
+        {
+            out_ << line << std::endl;
+        }
+    };
+
+    template <typename TConsole>
+    void report(const char* name, const std::string& script, const std::filesystem::path& output_path)
+    {
+        size_t executed = 0;
+
+        const double seconds = best_time([&] {
+            std::istringstream in{script};
+            std::ofstream out{output_path, std::ios::binary};
+            TConsole console{in, out};
+
+            Document doc;
+            SharedClipboard clipboard;
+            Application app{console};
+            add_editor_commands(app, doc, clipboard);
+
+            executed = app.run();
+        }, 3);
+
+        cout << name << ": " << executed / seconds / 1e6 << "M commands/s (" << executed << " commands in " << seconds << " s)\n";
+    }
+
+    // name -> command lookup alone, names as returned by Console::get_line()
+    template <typename Lookup>
+    void report_dispatch(const char* name, const std::vector<std::string>& names, Lookup lookup)
+    {
+        const double seconds = best_time([&] {
+            size_t sum = 0;
+            for (const std::string& command_name : names)
+                sum += lookup(command_name);
+            do_not_optimize(sum);
+        });
+
+        cout << name << ": " << seconds / names.size() * 1e9 << " ns per lookup\n";
+    }
+
+    std::vector<std::string> script_command_names()
+    {
+        std::vector<std::string> names;
+        names.reserve(script_commands);
+        for (size_t i = 0; i < script_commands / 8; ++i)
+            for (const char* command_name : {"AddText", "AddText", "ToUpper", "Copy", "Paste", "ToLower", "Print", "Clear"})
+                names.emplace_back(command_name);
+
+        return names;
+    }
+} // namespace
+
+int main()
+{
+    const std::string script = make_script();
+    const auto output_path = std::filesystem::temp_directory_path() / "document-editor-batch-output.txt";
+
+    report<LineConsole>("std::getline + std::endl", script, output_path);
+    report<BatchConsole>("BatchConsole", script, output_path);
+
+    std::filesystem::remove(output_path);
+
+    const std::vector<std::string> names = script_command_names();
+
+    std::map<std::string, size_t> command_map;
+    for (size_t i = 0; i < Application::command_names.size(); ++i)
+        command_map.emplace(Application::command_names[i], i);
+
+    report_dispatch("std::map<std::string, ...>", names, [&](const std::string& command_name) {
+        return command_map.find(command_name)->second;
+    });
+
+    static constexpr PerfectHashTable<Application::command_names.size()> command_table{Application::command_names};
+    report_dispatch("PerfectHashTable", names, [](const std::string& command_name) {
+        return command_table.find(command_name);
+    });
+}
@@ -0,0 +1,39 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+// runs f repeatedly and returns the best time of a single run in seconds
+template <typename F>
+double best_time(F f, int repetitions = 5)
+{
+    double best = std::numeric_limits<double>::max();
+
+    for (int i = 0; i < repetitions; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+        best = std::min(best, elapsed.count());
+    }
+
+    return best;
+}
+
+inline const void* volatile benchmark_sink;
+
+// keeps the optimizer from dropping the computation of a value
+template <typename T>
+void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    benchmark_sink = &value;
+#endif
+}
+
+#endif // BENCHMARK_HPP
@@ -0,0 +1,64 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "case_conversion.hpp"
+#include "document.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t text_size = 256 * 1024 * 1024;
+
+    // mostly ASCII text with some Polish UTF-8 letters
+    std::string sample_text()
+    {
+        const std::string words[] = {"Lorem ", "ipsum ", "dolor ", "sit ", "amet, ", "zażółć ", "gęślą ", "jaźń. ", "\n"};
+
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<size_t> word_distr(0, std::size(words) - 1);
+
+        std::string text;
+        text.reserve(text_size + 16);
+        while (text.size() < text_size)
+            text += words[word_distr(gen)];
+
+        return text;
+    }
+
+    void report(const char* name, double seconds)
+    {
+        cout << name << ": " << text_size / seconds / 1e9 << " GB/s\n";
+    }
+} // namespace
+
+int main()
+{
+    const std::string text = sample_text();
+    std::string out(text.size(), '\0');
+
+    report("std::toupper (per char)", best_time([&] {
+        std::transform(text.begin(), text.end(), out.begin(), [](auto c) { return std::toupper(c); });
+        do_not_optimize(out);
+    }));
+
+    for (auto [level, name] : {std::pair{SimdLevel::Scalar, "ascii_to_upper (scalar)"},
+             std::pair{SimdLevel::SSE2, "ascii_to_upper (SSE2)"}, std::pair{SimdLevel::AVX2, "ascii_to_upper (AVX2)"}})
+    {
+        if (level > detect_simd_level())
+            continue;
+
+        report(name, best_time([&, level = level] {
+            ascii_to_upper(text, out.data(), level);
+            do_not_optimize(out);
+        }));
+    }
+
+    Document doc{text};
+    report("Document::to_upper", best_time([&] { doc.to_upper(); }));
+}
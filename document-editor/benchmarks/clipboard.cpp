@@ -0,0 +1,56 @@
+#include "benchmark.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clipboard.hpp"
+#include "command.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t clip_size = 16 * 1024 * 1024;
+    constexpr int reads_per_thread = 1'000;
+
+    template <typename Read>
+    void report(const char* name, Read read)
+    {
+        for (unsigned threads : {1u, 4u, std::max(1u, std::thread::hardware_concurrency())})
+        {
+            const double seconds = best_time([&] {
+                std::vector<std::jthread> readers;
+                for (unsigned i = 0; i < threads; ++i)
+                    readers.emplace_back([&] {
+                        for (int j = 0; j < reads_per_thread; ++j)
+                            read();
+                    });
+            }, 3);
+
+            cout << name << " (" << threads << " threads): " << seconds / (threads * reads_per_thread) * 1e9 << " ns/read\n";
+        }
+    }
+} // namespace
+
+int main()
+{
+    SharedClipboard::instance().set_content(std::string(clip_size, 'c'));
+
+    report("content() handle", [] { do_not_optimize(SharedClipboard::instance().content()); });
+
+    report("content() copied to std::string", [] {
+        std::string copy = *SharedClipboard::instance().content();
+        do_not_optimize(copy);
+    });
+
+    SharedClipboard::instance().set_content(std::string(512 * 1024 * 1024, 'p'));
+    Document doc{"pasted: "};
+
+    cout << "PasteCmd (512 MiB clip): " << best_time([&] { PasteCmd{doc, SharedClipboard::instance()}.execute(); }) * 1e6 << " us\n";
+
+    cout << "Document::add_text with a copy (512 MiB clip): " << best_time([&] {
+        doc.add_text(*SharedClipboard::instance().content());
+    }, 1) * 1e6 << " us\n";
+}
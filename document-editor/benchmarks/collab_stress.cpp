@@ -0,0 +1,174 @@
+#include "benchmark.hpp"
+
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "collab_hub.hpp"
+#include "sequence_crdt.hpp"
+
+using namespace std;
+
+namespace
+{
+    const std::string base_text(64 * 1024, 'a');
+
+    // small insert or erase at a random position
+    void random_edit(Document& doc, std::mt19937& rng)
+    {
+        const size_t pos = std::uniform_int_distribution<size_t>{0, doc.length()}(rng);
+        if (rng() % 3 == 0 && pos < doc.length())
+            doc.erase(pos, 1 + rng() % 8);
+        else
+            doc.insert(pos, std::string(1 + rng() % 8, static_cast<char>('a' + rng() % 26)));
+    }
+
+    // merge cost per op of one replica merging the ops of another - as the sequence grows
+    void merge_cost(size_t op_count)
+    {
+        Document source_doc{base_text};
+        SequenceCrdt source{source_doc, 1};
+        std::mt19937 rng{1};
+
+        std::vector<std::string> batches;
+        size_t ops = 0;
+        for (size_t i = 0; i < op_count; ++i)
+        {
+            random_edit(source_doc, rng);
+            const auto taken = source.take_local_ops();
+            ops += taken.size();
+            batches.push_back(encode_ops(taken));
+        }
+
+        Document doc{base_text};
+        SequenceCrdt replica{doc, 2};
+
+        const auto start = std::chrono::steady_clock::now();
+        for (const std::string& batch : batches)
+            replica.merge(batch);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        // the same edits made on a document directly - the cost of the edits without the CRDT
+        Document direct_doc{base_text};
+        rng.seed(1);
+        const auto direct_start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < op_count; ++i)
+            random_edit(direct_doc, rng);
+        const std::chrono::duration<double> direct = std::chrono::steady_clock::now() - direct_start;
+
+        cout << "  " << op_count << " edits (" << ops << " ops, " << replica.run_count() << " runs): "
+             << elapsed.count() / op_count * 1e9 << " ns per merged edit, " << direct.count() / op_count * 1e9
+             << " ns per direct edit" << (doc.text() == source_doc.text() ? "" : " - DIVERGED") << '\n';
+    }
+
+    // clients edit concurrently, every one sends a frame per edits_per_frame edits & merges what it receives
+    void stress(const std::filesystem::path& socket, int client_count, size_t edits, size_t edits_per_frame)
+    {
+        CollabHub hub{socket};
+
+        std::atomic<uint64_t> frames_sent = 0;
+        std::atomic<uint64_t> ops_sent = 0;
+        std::atomic<uint64_t> bytes_sent = 0;
+        std::atomic<bool> diverged = false;
+        std::vector<std::string> texts(client_count);
+        std::chrono::steady_clock::time_point edits_done;
+        std::chrono::steady_clock::time_point converged;
+
+        std::barrier connected{client_count};
+        std::barrier edited{client_count, [&]() noexcept { edits_done = std::chrono::steady_clock::now(); }};
+        std::barrier merged{client_count, [&]() noexcept { converged = std::chrono::steady_clock::now(); }};
+
+        const auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::jthread> clients;
+            for (int c = 0; c < client_count; ++c)
+            {
+                clients.emplace_back([&, c] {
+                    CollabClient client{socket};
+                    Document doc{base_text};
+                    SequenceCrdt crdt{doc, client.site()};
+                    std::mt19937 rng{static_cast<unsigned>(c)};
+                    uint64_t received = 0;
+                    uint64_t own_frames = 0;
+
+                    auto merge_received = [&](std::chrono::milliseconds timeout) {
+                        for (const std::string& frame : client.receive(timeout))
+                        {
+                            crdt.merge(frame);
+                            ++received;
+                        }
+                    };
+
+                    auto send_local = [&] {
+                        const auto ops = crdt.take_local_ops();
+                        const std::string batch = encode_ops(ops);
+                        client.send(batch);
+                        ops_sent += ops.size();
+                        bytes_sent += batch.size();
+                        ++own_frames;
+                        ++frames_sent;
+                    };
+
+                    connected.arrive_and_wait();
+
+                    for (size_t i = 0; i < edits; ++i)
+                    {
+                        random_edit(doc, rng);
+                        if ((i + 1) % edits_per_frame == 0)
+                        {
+                            send_local();
+                            merge_received(std::chrono::milliseconds{0});
+                        }
+                    }
+                    if (crdt.has_local_ops())
+                        send_local();
+
+                    edited.arrive_and_wait(); // frames_sent is final
+
+                    while (received < frames_sent - own_frames)
+                        merge_received(std::chrono::milliseconds{1});
+
+                    merged.arrive_and_wait();
+
+                    if (crdt.waiting_ops() > 0)
+                        diverged = true;
+                    texts[c] = doc.text();
+                });
+            }
+        }
+        const std::chrono::duration<double> total = std::chrono::steady_clock::now() - start;
+        const std::chrono::duration<double> convergence = converged - edits_done;
+
+        for (const std::string& text : texts)
+        {
+            if (text != texts[0])
+                diverged = true;
+        }
+
+        const uint64_t merged_ops = ops_sent * (client_count - 1);
+        cout << "  " << client_count << " clients x " << edits << " edits, " << edits_per_frame
+             << " per frame: " << merged_ops / total.count() / 1e6 << "M merged ops/s, "
+             << static_cast<double>(bytes_sent) / ops_sent << " bytes per op, converged "
+             << convergence.count() * 1e3 << " ms after the last edit" << (diverged ? " - DIVERGED" : "") << '\n';
+    }
+} // namespace
+
+int main()
+{
+    cout << "Merging the ops of another replica, 64 KiB base text\n";
+    for (size_t op_count : {1'000, 10'000, 100'000})
+        merge_cost(op_count);
+
+    const auto socket = std::filesystem::temp_directory_path() / "document-editor-collab-stress.sock";
+
+    cout << "Local clients editing through the hub, " << std::thread::hardware_concurrency() << " hardware threads\n";
+    for (int client_count : {2, 8, 32})
+        stress(socket, client_count, 1'000, 8);
+    stress(socket, 32, 1'000, 1);
+}
@@ -0,0 +1,65 @@
+#include "benchmark.hpp"
+
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "diff.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t text_size = 50 * 1024 * 1024;
+    constexpr size_t edits = 10;
+
+    std::string sample_text()
+    {
+        std::mt19937 gen{42};
+        std::string text;
+        text.reserve(text_size + 64);
+        for (size_t i = 0; text.size() < text_size; ++i)
+            text += "line " + std::to_string(i) + ": value " + std::to_string(gen() % 100000) + "\n";
+
+        return text;
+    }
+
+    void report(const std::string& name, const Rope& old_text, const Rope& new_text)
+    {
+        std::vector<DiffHunk> hunks;
+        const double seconds = best_time([&] { hunks = diff(old_text, new_text); });
+
+        cout << name << ": " << seconds * 1e3 << " ms, " << hunks.size() << " hunks\n";
+    }
+} // namespace
+
+int main()
+{
+    const std::string text = sample_text();
+
+    Document doc{text};
+    const auto before = doc.snapshot();
+
+    // a few small edits spread over the whole document - the first one near the start, the last one near the end
+    std::mt19937 gen{1};
+    for (size_t i = 0; i < edits; ++i)
+    {
+        const size_t pos = (i * text_size / (edits - 1)) - (i == edits - 1 ? 100 : 0) + gen() % 50;
+        doc.replace(pos, 5, "EDIT");
+    }
+    const auto after = doc.snapshot();
+
+    cout << "50 MiB document, " << edits << " edits\n";
+
+    report("diff of two versions (shared chunks)", before.rope(), after.rope());
+
+    // copies share no chunks - every byte is compared and the lines between the edits are hashed
+    const Rope before_copy{before.text()};
+    const Rope after_copy{after.text()};
+    report("diff of two copies", before_copy, after_copy);
+
+    // a single edit - the common prefix & suffix of the copies cover nearly all the text
+    Document single{text};
+    single.replace(text_size / 2, 5, "EDIT");
+    report("diff of two copies, one edit", before_copy, Rope{single.text()});
+}
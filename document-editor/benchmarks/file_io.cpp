@@ -0,0 +1,60 @@
+#include "benchmark.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "document.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t file_size = 512 * 1024 * 1024;
+
+    void report(const char* name, double seconds)
+    {
+        cout << name << ": " << seconds * 1e3 << " ms (" << file_size / seconds / 1e9 << " GB/s)\n";
+    }
+} // namespace
+
+int main()
+{
+    const auto path = std::filesystem::temp_directory_path() / "document-editor-bench.txt";
+    const auto saved_path = std::filesystem::temp_directory_path() / "document-editor-bench-saved.txt";
+
+    {
+        const std::string line = "Lorem ipsum dolor sit amet, consectetur adipiscing elit\n";
+        std::ofstream out{path, std::ios::binary};
+        for (size_t written = 0; written < file_size; written += line.size())
+            out << line;
+    }
+
+    report("std::ifstream into Document", best_time([&] {
+        std::ifstream in{path, std::ios::binary};
+        Document doc{std::string{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}}};
+        do_not_optimize(doc);
+    }, 3));
+
+    report("Document::open (memory mapped)", best_time([&] {
+        Document doc;
+        doc.open(path);
+        do_not_optimize(doc);
+    }, 3));
+
+    Document doc;
+    doc.open(path);
+    doc.insert(doc.length() / 2, "edit in the middle\n");
+
+    report("Document::save (streamed)", best_time([&] { doc.save(saved_path); }, 3));
+
+    report("Document::text + std::ofstream", best_time([&] {
+        std::ofstream out{saved_path, std::ios::binary};
+        out << doc.text();
+    }, 3));
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(saved_path);
+}
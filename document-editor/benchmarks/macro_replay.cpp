@@ -0,0 +1,68 @@
+#include "benchmark.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "application.hpp"
+#include "batch_console.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t repetitions = 200'000;
+
+    struct Workload
+    {
+        const char* name;
+        std::string body; // script of one repetition
+        size_t commands;  // commands in the body
+    };
+
+    // runs script in batch mode, returns the final document length
+    size_t run_script(const std::string& script)
+    {
+        std::istringstream in{script};
+        std::ostringstream out;
+        BatchConsole console{in, out};
+
+        Document doc;
+        SharedClipboard clipboard;
+        clipboard.set_content("clipboard text\n");
+        Application app{console};
+        add_editor_commands(app, doc, clipboard);
+
+        app.run();
+
+        return doc.length();
+    }
+
+    void report(const Workload& workload)
+    {
+        std::string one_at_a_time;
+        for (size_t i = 0; i < repetitions; ++i)
+            one_at_a_time += workload.body;
+
+        const std::string replayed = "Record\n" + workload.body + "Stop\nPlay\n" + std::to_string(repetitions - 1) + "\n";
+
+        size_t length = 0, replayed_length = 0;
+        const double commands_seconds = best_time([&] { length = run_script(one_at_a_time); }, 3);
+        const double replay_seconds = best_time([&] { replayed_length = run_script(replayed); }, 3);
+
+        if (length != replayed_length)
+            cout << "length mismatch: " << length << " != " << replayed_length << "\n";
+
+        const double commands = static_cast<double>(workload.commands * repetitions);
+
+        cout << workload.name << " x " << repetitions << "\n"
+             << "  one at a time: " << commands / commands_seconds / 1e6 << "M commands/s (" << commands_seconds << " s)\n"
+             << "  macro replay:  " << commands / replay_seconds / 1e6 << "M commands/s (" << replay_seconds << " s)\n";
+    }
+} // namespace
+
+int main()
+{
+    report({"AddText, AddText", "AddText\nhello \nAddText\nworld\n", 2});
+    report({"AddText, AddText, Paste, AddText", "AddText\nline \nAddText\none\nPaste\nAddText\n - end\n", 4});
+}
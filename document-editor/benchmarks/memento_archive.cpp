@@ -0,0 +1,55 @@
+#include "benchmark.hpp"
+
+#include <iostream>
+#include <string>
+
+#include "document.hpp"
+
+using namespace std;
+
+namespace
+{
+    std::string make_text(size_t size)
+    {
+        std::string text;
+        for (size_t line = 0; text.size() < size; ++line)
+            text += "line " + std::to_string(line) + ": the quick brown fox jumps over the lazy dog\n";
+
+        return text;
+    }
+
+    template <typename TSerializer, typename TDeserializer>
+    void report(const char* name, Document& doc)
+    {
+        Document::Memento memento;
+        const double save_seconds = best_time([&] { memento = doc.template create_memento<TSerializer>(); });
+
+        // a fresh document each time - once restored, the memento belongs to its history and is not deserialized again
+        size_t restored_length = 0;
+        const double restore_seconds = best_time([&] {
+            Document other;
+            other.template set_memento<TDeserializer>(memento);
+            restored_length = other.length();
+        });
+
+        if (restored_length != doc.length())
+            cout << "length mismatch\n";
+
+        cout << name << ": create_memento " << save_seconds * 1e3 << " ms (" << doc.length() / save_seconds / 1e9
+             << " GB/s), set_memento " << restore_seconds * 1e3 << " ms (" << doc.length() / restore_seconds / 1e9 << " GB/s)\n";
+    }
+} // namespace
+
+int main()
+{
+    for (size_t size : {64 * 1024, 64 * 1024 * 1024})
+    {
+        Document doc{make_text(size)};
+        doc.set_keyframe_interval(1);
+        doc.insert(doc.length() / 2, "edit in the middle"); // text held in several chunks
+
+        cout << doc.length() / 1024 << " KiB document\n";
+        report<cereal::BinaryOutputArchive, cereal::BinaryInputArchive>("  cereal binary + stringstream", doc);
+        report<RawOutputArchive, RawInputArchive>("  RawOutputArchive", doc);
+    }
+}
@@ -0,0 +1,113 @@
+#include "benchmark.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "document.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr auto duration = std::chrono::seconds{1};
+    constexpr size_t read_size = 4096;
+
+    struct Result
+    {
+        double edits_per_second;
+        double reads_per_second;
+    };
+
+    // the writer inserts at random positions, readers read a consistent slice of some version
+    template <typename Read, typename Edit>
+    Result run(int reader_count, Read read, Edit edit)
+    {
+        std::atomic<bool> done = false;
+        std::atomic<size_t> reads = 0;
+
+        std::vector<std::jthread> readers;
+        for (int i = 0; i < reader_count; ++i)
+        {
+            readers.emplace_back([&, i] {
+                std::mt19937 rng(i);
+                size_t count = 0;
+                while (!done)
+                {
+                    do_not_optimize(read(rng));
+                    ++count;
+                }
+                reads += count;
+            });
+        }
+
+        std::mt19937 rng{42};
+        size_t edits = 0;
+        const auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < duration)
+        {
+            edit(rng);
+            ++edits;
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        done = true;
+        readers.clear();
+
+        return {edits / elapsed.count(), reads / elapsed.count()};
+    }
+
+    void print(const char* name, int reader_count, Result result)
+    {
+        cout << "  " << name << ", " << reader_count << " readers: " << result.edits_per_second / 1e3 << "k edits/s, "
+             << result.reads_per_second / 1e3 << "k reads/s\n";
+    }
+} // namespace
+
+int main()
+{
+    const std::string text(16 * 1024 * 1024, 'a');
+    cout << "16 MiB document, " << std::thread::hardware_concurrency() << " hardware threads\n";
+
+    for (int reader_count : {0, 1, 3})
+    {
+        Document doc{text};
+        std::mutex mutex;
+
+        // before MVCC - readers copy the text under a lock shared with the writer
+        const Result locked = run(
+            reader_count,
+            [&](std::mt19937& rng) {
+                std::string copy;
+                {
+                    std::lock_guard lock{mutex};
+                    copy = doc.text();
+                }
+                return copy.substr(std::uniform_int_distribution<size_t>{0, copy.size() - read_size}(rng), read_size);
+            },
+            [&](std::mt19937& rng) {
+                std::lock_guard lock{mutex};
+                doc.insert(std::uniform_int_distribution<size_t>{0, doc.length()}(rng), "edit");
+            });
+        print("mutex + text() copy", reader_count, locked);
+    }
+
+    for (int reader_count : {0, 1, 3})
+    {
+        Document doc{text};
+
+        const Result pinned = run(
+            reader_count,
+            [&](std::mt19937& rng) {
+                const auto snapshot = doc.pin();
+                return snapshot.text(std::uniform_int_distribution<size_t>{0, snapshot.length() - read_size}(rng), read_size);
+            },
+            [&](std::mt19937& rng) { doc.insert(std::uniform_int_distribution<size_t>{0, doc.length()}(rng), "edit"); });
+        print("pin()", reader_count, pinned);
+    }
+}
@@ -0,0 +1,57 @@
+#include "benchmark.hpp"
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "document.hpp"
+#include "thread_pool.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t text_size = 256 * 1024 * 1024;
+
+    std::string sample_text()
+    {
+        const std::string words[] = {"Lorem ", "ipsum ", "dolor ", "sit ", "amet, ", "zażółć ", "gęślą ", "jaźń. ", "\n"};
+
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<size_t> word_distr(0, std::size(words) - 1);
+
+        std::string text;
+        text.reserve(text_size + 16);
+        while (text.size() < text_size)
+            text += words[word_distr(gen)];
+
+        return text;
+    }
+
+    void report(const std::string& name, double seconds)
+    {
+        cout << name << ": " << text_size / seconds / 1e9 << " GB/s\n";
+    }
+} // namespace
+
+int main()
+{
+    Document doc{sample_text()};
+
+    report("Document::to_upper (sequential)", best_time([&] { doc.to_upper(); }));
+
+    for (size_t threads = 1; threads <= std::max(1u, std::thread::hardware_concurrency()); threads *= 2)
+    {
+        ThreadPool pool{threads};
+        report("Document::to_upper (" + std::to_string(threads) + " threads)", best_time([&] { doc.to_upper(pool); }));
+    }
+
+    ThreadPool pool;
+    for (size_t chunk_size : {16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024})
+    {
+        report("Document::transform (" + std::to_string(chunk_size / 1024) + " KiB chunks)", best_time([&] {
+            doc.transform([](std::string_view chunk, char* out) { ascii_to_lower(chunk, out); }, pool, chunk_size);
+        }));
+    }
+}
@@ -0,0 +1,72 @@
+#include "benchmark.hpp"
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "document.hpp"
+#include "search.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t text_size = 256 * 1024 * 1024;
+
+    // log-like text - the searched phrase occurs rarely
+    std::string sample_text()
+    {
+        const std::string lines[] = {"INFO request handled in 12 ms\n", "DEBUG cache hit for key 42\n",
+            "INFO connection accepted from 10.0.0.1\n", "WARN slow response from backend\n"};
+
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<size_t> line_distr(0, std::size(lines) - 1);
+
+        std::string text;
+        text.reserve(text_size + 64);
+        for (size_t i = 0; text.size() < text_size; ++i)
+            text += (i % 10'000 == 0) ? "ERROR disk quota exceeded\n" : lines[line_distr(gen)];
+
+        return text;
+    }
+
+    void report(const std::string& name, double seconds)
+    {
+        cout << name << ": " << text_size / seconds / 1e9 << " GB/s\n";
+    }
+} // namespace
+
+int main()
+{
+    const std::string text = sample_text();
+    const Rope rope{text};
+
+    for (const std::string pattern : {"e", "ERROR", "disk quota exceeded"})
+    {
+        report("std::string::find (\"" + pattern + "\")", best_time([&] {
+            std::vector<size_t> occurrences;
+            for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + pattern.size()))
+                occurrences.push_back(pos);
+            do_not_optimize(occurrences);
+        }));
+
+        for (auto [level, name] : {std::pair{SimdLevel::Scalar, "Horspool"}, std::pair{SimdLevel::SSE2, "SSE2"},
+                 std::pair{SimdLevel::AVX2, "AVX2"}})
+        {
+            if (level > detect_simd_level())
+                continue;
+
+            const Searcher searcher{pattern, level};
+            report("Searcher::find_all " + std::string{name} + " (\"" + pattern + "\")", best_time([&] {
+                auto occurrences = searcher.find_all(rope);
+                do_not_optimize(occurrences);
+            }));
+        }
+    }
+
+    report("Document::replace_all", best_time([&] {
+        Document doc{text};
+        doc.replace_all("disk quota", "storage limit");
+    }));
+}
@@ -0,0 +1,53 @@
+#include "benchmark.hpp"
+
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "document.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t text_size = 64 * 1024 * 1024;
+    constexpr int queries = 1'000;
+
+    std::string sample_text()
+    {
+        const std::string lines[] = {"INFO request handled in 12 ms\n", "DEBUG cache hit for key 42\n",
+            "INFO connection accepted from 10.0.0.1\n", "WARN slow response from backend\n"};
+
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<size_t> line_distr(0, std::size(lines) - 1);
+
+        std::string text;
+        text.reserve(text_size + 64);
+        for (size_t i = 0; text.size() < text_size; ++i)
+            text += (i % 10'000 == 0) ? "ERROR disk quota exceeded for user " + std::to_string(i) + "\n" : lines[line_distr(gen)];
+
+        return text;
+    }
+} // namespace
+
+int main()
+{
+    Document doc{sample_text()};
+    const std::string pattern = "disk quota exceeded for user 1230000";
+
+    const double scan_time = best_time([&] {
+        for (int i = 0; i < queries / 100; ++i)
+            do_not_optimize(doc.count(pattern));
+    }) * 100 / queries;
+    cout << "Document::count without index: " << scan_time * 1e6 << " us/query\n";
+
+    const double build_time = best_time([&] { doc.build_index(); }, 1);
+    cout << "SuffixIndex build (SA-IS): " << build_time << " s (" << text_size / build_time / 1e6 << " MB/s), "
+         << doc.index_memory() / (1024.0 * 1024.0) << " MiB\n";
+
+    const double index_time = best_time([&] {
+        for (int i = 0; i < queries; ++i)
+            do_not_optimize(doc.count(pattern));
+    }) / queries;
+    cout << "Document::count with index: " << index_time * 1e6 << " us/query\n";
+}
@@ -0,0 +1,70 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "document.hpp"
+#include "text_stats.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t text_size = 64 * 1024 * 1024;
+
+    std::string sample_text()
+    {
+        const std::string words[] = {"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "\n"};
+
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<size_t> word_distr(0, std::size(words) - 1);
+
+        std::string text;
+        text.reserve(text_size + 16);
+        while (text.size() < text_size)
+            text += words[word_distr(gen)] + ' ';
+
+        return text;
+    }
+} // namespace
+
+int main()
+{
+    const std::string text = sample_text();
+
+    for (auto [level, name] : {std::pair{SimdLevel::Scalar, "scalar"}, std::pair{SimdLevel::SSE2, "SSE2"}, std::pair{SimdLevel::AVX2, "AVX2"}})
+    {
+        if (level > detect_simd_level())
+            continue;
+
+        const double seconds = best_time([&] { do_not_optimize(count_text_stats(text, level)); });
+        cout << "count_text_stats " << name << ": " << text.size() / seconds / 1e9 << " GB/s\n";
+    }
+
+    const double build_seconds = best_time([&] { do_not_optimize(Rope{text}); });
+    cout << "Rope construction (counts every chunk): " << text.size() / build_seconds / 1e9 << " GB/s\n";
+
+    Document doc{text};
+    std::mt19937 gen{1};
+    const int edits = 10'000;
+
+    // stats after every edit - rescanning the text against the counts kept in the tree
+    const double rescan_seconds = best_time([&] {
+        doc.insert(std::uniform_int_distribution<size_t>{0, doc.length()}(gen), "new words ");
+        const std::string current = doc.text();
+        do_not_optimize(std::count(current.begin(), current.end(), '\n'));
+        do_not_optimize(count_text_stats(current, SimdLevel::Scalar));
+    }, 3);
+    cout << "edit + Stats by rescanning text(): " << rescan_seconds * 1e3 << " ms\n";
+
+    const double kept_seconds = best_time([&] {
+        for (int i = 0; i < edits; ++i)
+        {
+            doc.insert(std::uniform_int_distribution<size_t>{0, doc.length()}(gen), "new words ");
+            do_not_optimize(doc.length() + doc.word_count() + doc.line_count());
+        }
+    }, 3);
+    cout << "edit + Stats from the tree: " << kept_seconds / edits * 1e6 << " us\n";
+}
@@ -0,0 +1,99 @@
+#include "benchmark.hpp"
+
+#include <iostream>
+#include <random>
+#include <stack>
+#include <string>
+
+#include "lz_codec.hpp"
+#include "undo_history.hpp"
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t edits = 2000;
+
+    std::string make_text(size_t size)
+    {
+        std::string text;
+        for (size_t line = 0; text.size() < size; ++line)
+            text += "line " + std::to_string(line) + ": the quick brown fox jumps over the lazy dog\n";
+
+        return text;
+    }
+
+    // small inserts & erases, every 100th edit changes the whole text
+    void edit(Document& doc, std::mt19937& rng, size_t i)
+    {
+        if (i % 100 == 99)
+        {
+            (i % 200 == 199) ? doc.to_lower() : doc.to_upper();
+            return;
+        }
+
+        const size_t pos = std::uniform_int_distribution<size_t>{0, doc.length() - 100}(rng);
+        if (i % 2 == 0)
+            doc.insert(pos, "inserted text");
+        else
+            doc.erase(pos, 10);
+    }
+} // namespace
+
+int main()
+{
+    const std::string text = make_text(4 * 1024 * 1024);
+
+    {
+        std::string compressed;
+        const double seconds = best_time([&] { compressed = lz_compress(text); });
+        const double decompress_seconds = best_time([&] { do_not_optimize(lz_decompress(compressed)); });
+
+        cout << "lz_compress: " << text.size() / seconds / 1e9 << " GB/s, ratio " << static_cast<double>(text.size()) / compressed.size()
+             << ", lz_decompress: " << text.size() / decompress_seconds / 1e9 << " GB/s\n";
+    }
+
+    {
+        Document doc{text};
+        std::mt19937 rng{1};
+        std::stack<Document::Memento> stack;
+        size_t bytes = 0;
+
+        for (size_t i = 0; i < edits; ++i)
+        {
+            stack.push(doc.create_memento());
+            bytes += stack.top().memory_usage();
+            edit(doc, rng, i);
+        }
+
+        cout << "std::stack<Memento>: " << stack.size() << " entries, " << bytes / (1024.0 * 1024.0) << " MiB\n";
+    }
+
+    for (size_t budget : {16 * 1024 * 1024, 64 * 1024 * 1024})
+    {
+        Document doc{text};
+        std::mt19937 rng{1};
+        UndoHistory history{doc, budget};
+
+        const double seconds = best_time([&] {
+            for (size_t i = 0; i < edits; ++i)
+            {
+                history.checkpoint();
+                edit(doc, rng, i);
+            }
+        }, 1);
+
+        UndoHistoryStats stats = history.stats();
+        cout << "UndoHistory (" << budget / (1024 * 1024) << " MiB budget): " << stats.entries << " entries, "
+             << stats.bytes_used / (1024.0 * 1024.0) << " MiB, compression " << stats.compression_ratio << "x, "
+             << seconds / edits * 1e6 << " us per checkpoint\n";
+
+        for (int i = 0; i < 200 && history.undo(); ++i)
+        {
+        }
+
+        stats = history.stats();
+        cout << "  200 undos: p50/p90/p99 " << stats.undo_p50.count() / 1e3 << "/" << stats.undo_p90.count() / 1e3 << "/"
+             << stats.undo_p99.count() / 1e3 << " us, " << stats.bytes_used / (1024.0 * 1024.0) << " MiB\n";
+    }
+}
@@ -1,13 +1,218 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
 
 #include "application.hpp"
+#include "autosave.hpp"
+#include "batch_console.hpp"
+#include "collab_hub.hpp"
 #include "command.hpp"
-#include <boost/di.hpp>
+#include "sequence_crdt.hpp"
 
 using namespace std;
-namespace di = boost::di;
 
-int main()
+namespace
 {
-    // TODO
-}
\ No newline at end of file
+    void run_commands(Console& console, Document& doc, UndoHistory& history)
+    {
+        Application app{console};
+        add_editor_commands(app, doc, SharedClipboard::instance());
+        add_history_commands(app, history);
+
+        app.run();
+    }
+
+    // path - autosave of an interactive session, recovered by the next one after a crash
+    void run_editor(Console& console, const std::filesystem::path& autosave_path = {})
+    {
+        Document doc;
+
+        std::optional<Autosave> autosave;
+        if (!autosave_path.empty())
+        {
+            try
+            {
+                autosave.emplace(doc, autosave_path);
+                if (doc.length() > 0)
+                    console.print("Recovered " + std::to_string(doc.length()) + " characters from " + autosave_path.string());
+            }
+            catch (const std::exception& e)
+            {
+                console.print(std::string{"Autosave disabled: "} + e.what());
+            }
+        }
+
+        UndoHistory history{doc};
+        run_commands(console, doc, history);
+
+        if (autosave)
+            autosave->close(); // the session ended cleanly - nothing to recover
+    }
+
+    // sends the local edits of every command to the other editors of a collaboration session and
+    // merges theirs before the next command runs - undo reverts only the local edits made since
+    class CollabConsole : public Console
+    {
+        Console& console_;
+        CollabClient& client_;
+        SequenceCrdt& crdt_;
+        UndoHistory& history_;
+        bool disconnect_reported_ = false;
+
+    public:
+        CollabConsole(Console& console, CollabClient& client, SequenceCrdt& crdt, UndoHistory& history)
+            : console_{console}
+            , client_{client}
+            , crdt_{crdt}
+            , history_{history}
+        {
+        }
+
+        // the remote edits are merged only here - positions read by a command stay valid until it runs
+        std::string get_command() override
+        {
+            if (crdt_.has_local_ops() && client_.connected())
+            {
+                try
+                {
+                    client_.send(encode_ops(crdt_.take_local_ops()));
+                }
+                catch (const std::system_error&)
+                {
+                    // the hub has gone - reported below
+                }
+            }
+
+            std::string line = console_.get_command();
+
+            bool merged = false;
+            for (const std::string& frame : client_.receive())
+                merged = crdt_.merge(frame) || merged;
+
+            // an undo across the merged edits would send them back as local erasures
+            if (merged)
+                history_.clear();
+
+            if (!client_.connected() && !disconnect_reported_)
+            {
+                console_.print("Collaboration session closed - editing continues locally");
+                disconnect_reported_ = true;
+            }
+
+            return line;
+        }
+
+        std::string get_line() override
+        {
+            return console_.get_line();
+        }
+
+        void print(const std::string& line) override
+        {
+            console_.print(line);
+        }
+
+        void flush() override
+        {
+            console_.flush();
+        }
+    };
+
+    // joins the session at socket - the first editor hosts its hub
+    void run_collab_editor(Console& console, const std::filesystem::path& socket)
+    {
+        std::optional<CollabHub> hub;
+        std::optional<CollabClient> client;
+        try
+        {
+            client.emplace(socket);
+        }
+        catch (const std::system_error&)
+        {
+            try
+            {
+                hub.emplace(socket);
+                console.print("Hosting a collaboration session at " + socket.string() + " - the others edit locally once this editor exits");
+            }
+            catch (const std::system_error& e)
+            {
+                if (e.code() != std::errc::address_in_use)
+                    throw;
+                // another editor has started hosting meanwhile
+            }
+            client.emplace(socket);
+        }
+
+        Document doc;
+        SequenceCrdt crdt{doc, client->site()};
+
+        // edits made before joining
+        for (const std::string& frame : client->receive(std::chrono::milliseconds{100}))
+            crdt.merge(frame);
+
+        UndoHistory history{doc};
+        CollabConsole collab_console{console, *client, crdt, history};
+        run_commands(collab_console, doc, history);
+    }
+} // namespace
+
+// document-editor              - interactive
+// document-editor script.txt   - batch mode, commands read from the script
+// document-editor -            - batch mode, commands read from stdin
+// document-editor --collab sock - interactive, editing one document with the other editors using the socket;
+//                                the first editor hosts the session - when it exits, the others edit locally
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        Terminal terminal;
+        run_editor(terminal, "document-editor.autosave");
+        return 0;
+    }
+
+    if (std::string_view{argv[1]} == "--collab")
+    {
+        if (argc < 3)
+        {
+            cerr << "Usage: " << argv[0] << " --collab <socket path>\n"
+                 << "The first editor hosts the session - when it exits, the others continue editing locally.\n"
+                 << "Editors cannot join a session that has exchanged more than "
+                 << CollabHub::default_max_history / (1024 * 1024) << " MiB of edits." << endl;
+            return 1;
+        }
+
+        Terminal terminal;
+        try
+        {
+            run_collab_editor(terminal, argv[2]);
+        }
+        catch (const std::exception& e)
+        {
+            cerr << "Collaboration session failed: " << e.what() << endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    std::ios::sync_with_stdio(false);
+
+    std::ifstream script;
+    if (std::string_view{argv[1]} != "-")
+    {
+        script.open(argv[1], std::ios::binary);
+        if (!script)
+        {
+            cerr << "Cannot open script " << argv[1] << endl;
+            return 1;
+        }
+    }
+
+    BatchConsole console{script.is_open() ? script : cin, cout};
+    run_editor(console);
+}
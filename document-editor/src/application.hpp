@@ -1,10 +1,256 @@
 #ifndef APPLICATION_HPP
 #define APPLICATION_HPP
 
-#include <map>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
 #include "console.hpp"
 #include "command.hpp"
+#include "macro.hpp"
+#include "perfect_hash.hpp"
 
+// Dispatches the commands named by TCommands - a traits type with
+//   static constexpr std::array<std::string_view, N> names; // commands that can be added
+//   static constexpr std::string_view append_command;      // its one-line appends are merged by macros
+// The lookup table is generated from the names & the built-in commands at compile time.
+template <typename TCommands>
+class BasicApplication
+{
+public:
+    static constexpr auto cmd_exit = "Exit";
+
+    // built-in commands - Record starts recording a macro, Stop compiles it, Play replays it
+    static constexpr auto cmd_record = "Record";
+    static constexpr auto cmd_stop = "Stop";
+    static constexpr auto cmd_play = "Play";
+
+    // names of all commands the application can dispatch
+    static constexpr auto command_names = [] {
+        std::array<std::string_view, TCommands::names.size() + 3> names{};
+        std::copy(TCommands::names.begin(), TCommands::names.end(), names.begin());
+        names[TCommands::names.size()] = cmd_record;
+        names[TCommands::names.size() + 1] = cmd_stop;
+        names[TCommands::names.size() + 2] = cmd_play;
+        return names;
+    }();
+
+private:
+    static constexpr PerfectHashTable<command_names.size()> command_table{command_names};
+
+    MacroConsole console_;
+    std::array<std::shared_ptr<Command>, command_names.size()> commands_;
+
+    bool recording_ = false;
+    std::vector<MacroStep> recorded_;
+    Macro macro_;
+
+public:
+    explicit BasicApplication(Console& console)
+        : console_{console}
+    {
+    }
+
+    // console commands must use - it records & replays the lines they read
+    Console& console()
+    {
+        return console_;
+    }
+
+    // name must be one of TCommands::names
+    void add_command(std::string_view name, std::shared_ptr<Command> cmd)
+    {
+        const size_t index = command_table.find(name);
+        if (index == command_table.npos || is_built_in(index))
+            throw std::invalid_argument("Application - unknown command name: " + std::string(name));
+
+        commands_[index] = std::move(cmd);
+    }
+
+    // command added under name - nullptr if there is none
+    std::shared_ptr<Command> command(std::string_view name) const
+    {
+        const size_t index = command_table.find(name);
+
+        return (index != command_table.npos) ? commands_[index] : nullptr;
+    }
+
+    // runs commands until Exit or the end of the input - returns the number of executed commands
+    size_t run()
+    {
+        size_t executed = 0;
+
+        try
+        {
+            while (true)
+            {
+                console_.print("Enter command:");
+                const std::string name = console_.get_command();
+
+                if (name == cmd_exit)
+                    break;
+
+                if (execute(name))
+                    ++executed;
+                else
+                    console_.print("Unknown command: " + name);
+            }
+        }
+        catch (const EndOfInput&)
+        {
+            // a command reading its arguments is aborted
+        }
+
+        console_.flush();
+
+        return executed;
+    }
+
+    // one hash & one comparison - false if the name is unknown or has no command added
+    bool execute(std::string_view name)
+    {
+        const size_t index = command_table.find(name);
+        if (index == command_table.npos)
+            return false;
+
+        if (is_built_in(index))
+        {
+            execute_built_in(index);
+            return true;
+        }
+
+        if (!commands_[index])
+            return false;
+
+        if (!recording_)
+        {
+            commands_[index]->execute();
+            return true;
+        }
+
+        // a command that throws is not recorded - the capture ends on every path
+        struct CaptureStop
+        {
+            MacroConsole& console;
+
+            ~CaptureStop()
+            {
+                console.stop_capture();
+            }
+        } stop{console_};
+
+        console_.start_capture();
+        commands_[index]->execute();
+        recorded_.push_back({std::string(name), console_.stop_capture()});
+
+        return true;
+    }
+
+    void play(size_t count = 1)
+    {
+        macro_.play(console_, count);
+    }
+
+    const Macro& macro() const
+    {
+        return macro_;
+    }
+
+private:
+    static constexpr size_t record_index = command_table.find(cmd_record);
+    static constexpr size_t stop_index = command_table.find(cmd_stop);
+    static constexpr size_t play_index = command_table.find(cmd_play);
+
+    static constexpr bool is_built_in(size_t index)
+    {
+        return index == record_index || index == stop_index || index == play_index;
+    }
+
+    void execute_built_in(size_t index)
+    {
+        if (index == record_index)
+        {
+            recording_ = true;
+            recorded_.clear();
+        }
+        else if (index == stop_index)
+        {
+            if (!recording_)
+                return;
+
+            recording_ = false;
+            macro_ = Macro{recorded_, [this](std::string_view name) { return commands_[command_table.find(name)]; }, TCommands::append_command};
+            recorded_.clear();
+        }
+        else
+        {
+            console_.print("Enter repeat count:");
+            const std::string line = console_.get_line();
+
+            size_t count = 0;
+            const auto [last, error] = std::from_chars(line.data(), line.data() + line.size(), count);
+            if (error != std::errc{} || last != line.data() + line.size())
+            {
+                console_.print("Error: invalid repeat count " + line);
+                return;
+            }
+
+            play(count);
+        }
+    }
+};
+
+// commands of the document editor
+struct EditorCommands
+{
+    static constexpr std::array<std::string_view, 19> names = {
+        "Print", "Stats", "AddText", "ToUpper", "ToLower", "Clear", "Copy", "Paste",
+        "Open", "Save", "Diff", "Find", "FindAll", "ReplaceAll", "Index", "Flush",
+        "Undo", "Redo", "History"};
+
+    static constexpr std::string_view append_command = "AddText";
+};
+
+using Application = BasicApplication<EditorCommands>;
+
+inline void add_editor_commands(Application& app, Document& doc, SharedClipboard& clipboard)
+{
+    Console& console = app.console();
+
+    app.add_command("Print", std::make_shared<PrintCmd>(doc, console));
+    app.add_command("Stats", std::make_shared<StatsCmd>(doc, console));
+    app.add_command("AddText", std::make_shared<AddTextCmd>(doc, console));
+    app.add_command("ToUpper", std::make_shared<ToUpperCmd>(doc));
+    app.add_command("ToLower", std::make_shared<ToLowerCmd>(doc));
+    app.add_command("Clear", std::make_shared<ClearCmd>(doc));
+    app.add_command("Copy", std::make_shared<CopyCmd>(doc, clipboard));
+    app.add_command("Paste", std::make_shared<PasteCmd>(doc, clipboard));
+    app.add_command("Open", std::make_shared<OpenCmd>(doc, console));
+    app.add_command("Save", std::make_shared<SaveCmd>(doc, console));
+    app.add_command("Diff", std::make_shared<DiffCmd>(doc, console));
+    app.add_command("Find", std::make_shared<FindCmd>(doc, console));
+    app.add_command("FindAll", std::make_shared<FindAllCmd>(doc, console));
+    app.add_command("ReplaceAll", std::make_shared<ReplaceAllCmd>(doc, console));
+    app.add_command("Index", std::make_shared<IndexCmd>(doc, console));
+    app.add_command("Flush", std::make_shared<FlushCmd>(console));
+}
+
+// adds Undo, Redo & History and makes the editing commands added before checkpoint the history
+inline void add_history_commands(Application& app, UndoHistory& history)
+{
+    for (const char* name : {"AddText", "ToUpper", "ToLower", "Clear", "Paste", "Open", "ReplaceAll"})
+    {
+        if (auto cmd = app.command(name))
+            app.add_command(name, std::make_shared<CheckpointCmd>(history, std::move(cmd)));
+    }
+
+    app.add_command("Undo", std::make_shared<UndoCmd>(history, app.console()));
+    app.add_command("Redo", std::make_shared<RedoCmd>(history, app.console()));
+    app.add_command("History", std::make_shared<HistoryCmd>(history, app.console()));
+}
 
 #endif // APPLICATION_HPP
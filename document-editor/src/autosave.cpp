@@ -0,0 +1,212 @@
+#include "autosave.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "file_io.hpp"
+
+namespace
+{
+    constexpr std::string_view snapshot_magic = "DOCSNAP1";
+    constexpr size_t snapshot_header_size = snapshot_magic.size() + sizeof(uint64_t);
+
+    std::string snapshot_header(uint64_t version)
+    {
+        std::string header{snapshot_magic};
+        for (size_t i = 0; i < sizeof(version); ++i, version >>= 8)
+            header.push_back(static_cast<char>(version & 0xFF));
+
+        return header;
+    }
+} // namespace
+
+Autosave::Autosave(Document& doc, std::filesystem::path path, std::chrono::milliseconds snapshot_interval,
+    std::chrono::milliseconds commit_interval)
+    : doc_{doc}
+    , path_{std::move(path)}
+    , snapshot_interval_{snapshot_interval}
+    , lock_{lock_path(path_)}
+    , recovered_{recover(doc_, path_)}
+{
+    if (recovered_.snapshot_loaded || recovered_.last_version > 0)
+        version_offset_ = recovered_.last_version + 1;
+
+    // the recovered text becomes the new starting point - its snapshot supersedes every old journal
+    // record, the old segments are deleted only to save the space
+    write_snapshot();
+    for (const auto& segment : Journal::segments(journal_base(path_)))
+        std::filesystem::remove(segment);
+
+    journal_.emplace(journal_base(path_), commit_interval);
+    listener_ = doc_.add_edit_listener([this](uint64_t version, size_t pos, size_t count, const Rope& inserted) {
+        journal_->append(version_offset_ + version, pos, count, inserted);
+
+        if (inserted.size() >= snapshot_insert_size)
+        {
+            {
+                std::lock_guard lock{wait_mutex_};
+                snapshot_requested_ = version;
+            }
+            wake_.notify_one();
+        }
+    });
+
+    saver_ = std::jthread{[this](std::stop_token stop) { save_loop(stop); }};
+}
+
+Autosave::~Autosave()
+{
+    stop(); // the journal is synced by its own destructor
+}
+
+void Autosave::close()
+{
+    stop();
+    journal_.reset();
+
+    std::error_code ignored;
+    std::filesystem::remove(path_, ignored);
+    for (const auto& segment : Journal::segments(journal_base(path_)))
+        std::filesystem::remove(segment, ignored);
+}
+
+void Autosave::snapshot_now()
+{
+    write_snapshot();
+}
+
+void Autosave::sync()
+{
+    journal_->sync();
+}
+
+AutosaveStats Autosave::stats() const
+{
+    std::lock_guard lock{snapshot_mutex_};
+
+    return {snapshots_, snapshot_errors_, saved_version_, journal_->records(), journal_->commits()};
+}
+
+AutosaveRecovery Autosave::recover(Document& doc, const std::filesystem::path& path)
+{
+    AutosaveRecovery recovery{false, 0, 0, 0};
+
+    if (std::filesystem::exists(path))
+    {
+        const Rope file = map_file(path);
+        if (file.size() < snapshot_header_size || file.substr(0, snapshot_magic.size()) != snapshot_magic)
+            throw std::runtime_error("Not an autosave snapshot: " + path.string());
+
+        const std::string version = file.substr(snapshot_magic.size(), sizeof(uint64_t));
+        for (size_t i = sizeof(uint64_t); i-- > 0;)
+            recovery.snapshot_version = (recovery.snapshot_version << 8) | static_cast<uint8_t>(version[i]);
+
+        doc.clear();
+        doc.add_text(file.slice(snapshot_header_size));
+        recovery.snapshot_loaded = true;
+    }
+
+    recovery.last_version = recovery.snapshot_version;
+    const std::vector<JournalRecord> records = Journal::read(journal_base(path), recovery.snapshot_version);
+    for (const JournalRecord& record : records)
+        recovery.last_version = std::max(recovery.last_version, record.version);
+
+    for (const JournalRecord& record : records)
+    {
+        if (record.pos > doc.length())
+            break;
+
+        doc.replace(record.pos, record.count, record.inserted);
+        ++recovery.replayed_edits;
+    }
+
+    return recovery;
+}
+
+std::filesystem::path Autosave::journal_base(const std::filesystem::path& path)
+{
+    std::filesystem::path base = path;
+    base += ".journal";
+
+    return base;
+}
+
+std::filesystem::path Autosave::lock_path(const std::filesystem::path& path)
+{
+    std::filesystem::path lock = path;
+    lock += ".lock";
+
+    return lock;
+}
+
+void Autosave::stop()
+{
+    if (!saver_.joinable())
+        return;
+
+    doc_.remove_edit_listener(listener_);
+
+    saver_.request_stop();
+    saver_.join();
+}
+
+void Autosave::write_snapshot()
+{
+    std::lock_guard lock{snapshot_mutex_};
+
+    if (snapshots_ > 0 && doc_.pin().version() == saved_version_)
+        return;
+
+    // edits from now on go to a new segment - the older ones are all covered by the pinned version
+    // unless an edit was journaled but not yet published, then its segment is kept
+    if (journal_)
+        journal_->rotate();
+
+    const Document::Snapshot snapshot = doc_.pin();
+
+    Rope data{snapshot_header(version_offset_ + snapshot.version())};
+    data.append(snapshot.rope());
+    write_file(path_, data, true);
+
+    saved_version_ = snapshot.version();
+    ++snapshots_;
+
+    if (journal_)
+        journal_->remove_segments_up_to(version_offset_ + saved_version_);
+}
+
+void Autosave::save_loop(std::stop_token stop)
+{
+    std::unique_lock lock{wait_mutex_};
+
+    while (true)
+    {
+        wake_.wait_for(lock, stop, snapshot_interval_, [this] { return snapshot_requested_ > 0; });
+        if (stop.stop_requested())
+            break;
+
+        const uint64_t requested_version = std::exchange(snapshot_requested_, 0);
+        lock.unlock();
+
+        // the listener runs before the edit is published - the document publishes it right after
+        while (doc_.pin().version() < requested_version && !stop.stop_requested())
+            std::this_thread::yield();
+
+        try
+        {
+            write_snapshot();
+        }
+        catch (...)
+        {
+            std::lock_guard errors_lock{snapshot_mutex_};
+            ++snapshot_errors_; // retried at the next interval, the journal still holds the edits
+        }
+
+        lock.lock();
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef AUTOSAVE_HPP
+#define AUTOSAVE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "document.hpp"
+#include "file_io.hpp"
+#include "journal.hpp"
+
+struct AutosaveRecovery
+{
+    bool snapshot_loaded;     // false if there was no snapshot to start from
+    uint64_t snapshot_version; // version of the document the snapshot was written at
+    size_t replayed_edits;     // journal records applied on top of the snapshot
+    uint64_t last_version;     // highest version in the snapshot & the journal
+};
+
+struct AutosaveStats
+{
+    uint64_t snapshots;        // written since the autosave started
+    uint64_t snapshot_errors;  // failed background snapshots - the journal is kept until one succeeds
+    uint64_t saved_version;    // version of the document in the latest snapshot
+    uint64_t journal_records;  // edits appended to the journal
+    uint64_t journal_commits;  // group commits - one fsync each
+};
+
+// Crash safety of a document: every edit is appended to a write-ahead journal (group committed by
+// its background thread), and a second thread periodically writes a full snapshot from a pinned
+// version of the text - the editing thread never waits for the disk. After a snapshot the journal
+// segments it covers are deleted, so recovery replays only the edits made since. A large insert
+// (e.g. a whole document) triggers an early snapshot, so recovery does not replay it.
+//
+// Files: <path> - the latest snapshot ("DOCSNAP1", version as u64 LE, text), <path>.journal.<n> - journal.
+// Versions in the files continue after the ones of the recovered session, so its journal records
+// are covered by the first snapshot even when a crash keeps them. close() deletes the files except
+// <path>.lock, locked by the session that uses them.
+class Autosave
+{
+    Document& doc_;
+    std::filesystem::path path_;
+    std::chrono::milliseconds snapshot_interval_;
+    LockFile lock_; // one session per autosave - another one would replay & delete the files of this one
+    AutosaveRecovery recovered_;
+    uint64_t version_offset_ = 0; // added to the versions of the document in the files
+    std::optional<Journal> journal_;
+    size_t listener_ = 0;
+
+    mutable std::mutex snapshot_mutex_; // snapshots of the background thread & snapshot_now()
+    uint64_t saved_version_ = 0;
+    uint64_t snapshots_ = 0;
+    uint64_t snapshot_errors_ = 0;
+
+    std::mutex wait_mutex_;
+    std::condition_variable_any wake_;
+    uint64_t snapshot_requested_ = 0; // version of a large insert waiting for a snapshot - 0 if none
+    std::jthread saver_;
+
+public:
+    static constexpr auto default_snapshot_interval = std::chrono::milliseconds{30'000};
+    static constexpr size_t snapshot_insert_size = 1024 * 1024; // inserts from this size trigger a snapshot
+
+    // recovers the document from the files of a previous session first - the document should be empty.
+    // Throws std::runtime_error for a snapshot that is not one written by Autosave, std::system_error
+    // (resource_unavailable_try_again) if another session uses the files.
+    Autosave(Document& doc, std::filesystem::path path, std::chrono::milliseconds snapshot_interval = default_snapshot_interval,
+        std::chrono::milliseconds commit_interval = Journal::default_commit_interval);
+
+    Autosave(const Autosave&) = delete;
+    Autosave& operator=(const Autosave&) = delete;
+
+    // stops journaling the document - the edits made so far are durable when it returns and the next
+    // session recovers them
+    ~Autosave();
+
+    // ends the session cleanly - stops journaling and deletes the snapshot & the journal, so the next
+    // session starts empty. Only the destructor may be called after it.
+    void close();
+
+    // what the constructor restored
+    const AutosaveRecovery& recovered() const
+    {
+        return recovered_;
+    }
+
+    // writes a snapshot of the current version unless the latest one is up to date - rethrows write errors
+    void snapshot_now();
+
+    // waits until the edits made so far are durable
+    void sync();
+
+    AutosaveStats stats() const;
+
+    // loads the snapshot at path into doc and replays the journal on top of it - stops at the first
+    // journal record that does not fit the text (e.g. a journal left by a different snapshot)
+    static AutosaveRecovery recover(Document& doc, const std::filesystem::path& path);
+
+    static std::filesystem::path journal_base(const std::filesystem::path& path);
+
+    static std::filesystem::path lock_path(const std::filesystem::path& path);
+
+private:
+    void stop();
+    void write_snapshot();
+    void save_loop(std::stop_token stop);
+};
+
+#endif // AUTOSAVE_HPP
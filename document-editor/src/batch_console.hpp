@@ -0,0 +1,115 @@
+#ifndef BATCH_CONSOLE_HPP
+#define BATCH_CONSOLE_HPP
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "console.hpp"
+
+// Console for scripts & piped input - reads the input in large blocks and collects the output
+// in memory. The output stream is flushed only by flush() and at destruction.
+class BatchConsole : public Console
+{
+    std::istream& in_;
+    std::ostream& out_;
+
+    std::vector<char> input_;
+    size_t begin_ = 0; // unread input is [begin_, end_)
+    size_t end_ = 0;
+    bool eof_ = false;
+
+    std::string output_;
+
+public:
+    static constexpr size_t block_size = 1024 * 1024;
+
+    // after the last line of the input get_line() throws EndOfInput
+    BatchConsole(std::istream& in, std::ostream& out)
+        : in_{in}
+        , out_{out}
+        , input_(block_size)
+    {
+        output_.reserve(block_size);
+    }
+
+    BatchConsole(const BatchConsole&) = delete;
+    BatchConsole& operator=(const BatchConsole&) = delete;
+
+    ~BatchConsole() override
+    {
+        flush();
+    }
+
+    std::string get_line() override
+    {
+        while (true)
+        {
+            const char* first = input_.data() + begin_;
+            if (const void* newline = std::memchr(first, '\n', end_ - begin_))
+            {
+                const auto* last = static_cast<const char*>(newline);
+                begin_ += last - first + 1;
+
+                if (last != first && last[-1] == '\r')
+                    --last;
+
+                return std::string(first, last);
+            }
+
+            if (eof_)
+            {
+                if (begin_ == end_)
+                    throw EndOfInput{};
+
+                std::string line(first, end_ - begin_);
+                begin_ = end_;
+                return line;
+            }
+
+            read_block();
+        }
+    }
+
+    void print(const std::string& line) override
+    {
+        output_.append(line).push_back('\n');
+
+        if (output_.size() >= block_size) // bounded memory - the stream is not flushed
+            write_output();
+    }
+
+    void flush() override
+    {
+        write_output();
+        out_.flush();
+    }
+
+private:
+    void read_block()
+    {
+        // keeps the unread part of the current line - a line longer than the buffer grows it
+        std::memmove(input_.data(), input_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+
+        if (end_ == input_.size())
+            input_.resize(2 * input_.size());
+
+        in_.read(input_.data() + end_, static_cast<std::streamsize>(input_.size() - end_));
+        end_ += static_cast<size_t>(in_.gcount());
+
+        if (in_.gcount() == 0)
+            eof_ = true;
+    }
+
+    void write_output()
+    {
+        out_.write(output_.data(), static_cast<std::streamsize>(output_.size()));
+        output_.clear();
+    }
+};
+
+#endif // BATCH_CONSOLE_HPP
@@ -0,0 +1,82 @@
+#include "case_conversion.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "simd_intrinsics.hpp"
+
+namespace
+{
+    // letters differ from the other case only in bit 0x20
+    constexpr char case_bit = 0x20;
+
+    void convert_scalar(const char* first, const char* last, char* out, char from, char to)
+    {
+        std::transform(first, last, out, [from, to](char c) {
+            return (c >= from && c <= to) ? static_cast<char>(c ^ case_bit) : c;
+        });
+    }
+
+#if defined(DOCUMENT_SIMD_X86)
+    // signed byte comparisons - bytes >= 0x80 are negative and never fall into the letter range
+    size_t convert_sse2(const char* text, size_t size, char* out, char from, char to)
+    {
+        const __m128i lower_bound = _mm_set1_epi8(static_cast<char>(from - 1));
+        const __m128i upper_bound = _mm_set1_epi8(static_cast<char>(to + 1));
+        const __m128i flip = _mm_set1_epi8(case_bit);
+
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+            const __m128i is_letter = _mm_and_si128(_mm_cmpgt_epi8(c, lower_bound), _mm_cmpgt_epi8(upper_bound, c));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(c, _mm_and_si128(is_letter, flip)));
+        }
+
+        return i;
+    }
+
+    DOCUMENT_TARGET_AVX2 size_t convert_avx2(const char* text, size_t size, char* out, char from, char to)
+    {
+        const __m256i lower_bound = _mm256_set1_epi8(static_cast<char>(from - 1));
+        const __m256i upper_bound = _mm256_set1_epi8(static_cast<char>(to + 1));
+        const __m256i flip = _mm256_set1_epi8(case_bit);
+
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+            const __m256i is_letter = _mm256_and_si256(_mm256_cmpgt_epi8(c, lower_bound), _mm256_cmpgt_epi8(upper_bound, c));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(c, _mm256_and_si256(is_letter, flip)));
+        }
+
+        return i;
+    }
+#endif
+
+    void convert(std::string_view text, char* out, char from, char to, SimdLevel level)
+    {
+        level = std::min(level, detect_simd_level());
+
+        size_t done = 0;
+
+#if defined(DOCUMENT_SIMD_X86)
+        if (level == SimdLevel::AVX2)
+            done = convert_avx2(text.data(), text.size(), out, from, to);
+        else if (level == SimdLevel::SSE2)
+            done = convert_sse2(text.data(), text.size(), out, from, to);
+#endif
+
+        convert_scalar(text.data() + done, text.data() + text.size(), out + done, from, to);
+    }
+} // namespace
+
+void ascii_to_upper(std::string_view text, char* out, SimdLevel level)
+{
+    convert(text, out, 'a', 'z', level);
+}
+
+void ascii_to_lower(std::string_view text, char* out, SimdLevel level)
+{
+    convert(text, out, 'A', 'Z', level);
+}
@@ -0,0 +1,14 @@
+#ifndef CASE_CONVERSION_HPP
+#define CASE_CONVERSION_HPP
+
+#include <string_view>
+
+#include "simd.hpp"
+
+// Case conversion of ASCII letters - bytes >= 0x80 are copied unchanged, so UTF-8 multi-byte
+// sequences pass through intact. Converts 32 (AVX2) or 16 (SSE2) bytes at a time.
+// out must have room for text.size() bytes and may be equal to text.data().
+void ascii_to_upper(std::string_view text, char* out, SimdLevel level = detect_simd_level());
+void ascii_to_lower(std::string_view text, char* out, SimdLevel level = detect_simd_level());
+
+#endif // CASE_CONVERSION_HPP
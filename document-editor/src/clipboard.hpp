@@ -1,34 +1,67 @@
 #ifndef CLIPBOARD_HPP
 #define CLIPBOARD_HPP
 
-#include <mutex>
+#include <atomic>
+#include <memory>
 #include <string>
 
+#include "rope.hpp"
+
+// Content is published as immutable buffers (RCU-style) - readers take a reference to the current
+// buffer without a copy and never wait for a writer copying its text, writers build a new buffer
+// & swap it in. The swap itself is an atomic shared_ptr exchange - not lock-free in libstdc++
+// (a short internal spin lock), but held only for the pointer update. A buffer lives as long as
+// any reader (or a document it was pasted into) holds it.
 class SharedClipboard
 {
-    std::string content_;
-    mutable std::mutex content_mtx_;
+    // the rope is built once per write - its leaves point into text, so pasting copies nothing
+    struct Clip
+    {
+        std::shared_ptr<const std::string> text;
+        Rope rope;
+    };
+
+    std::atomic<std::shared_ptr<const Clip>> clip_{make_clip(std::make_shared<const std::string>())};
 
 public:
-    SharedClipboard& instance()
+    static SharedClipboard& instance()
     {
         static SharedClipboard unique_instance;
 
         return unique_instance;
     }
 
-    std::string content() const
+    // never null - later set_content() calls do not change the returned buffer
+    std::shared_ptr<const std::string> content() const
+    {
+        return clip_.load(std::memory_order_acquire)->text;
+    }
+
+    // content as a rope sharing the buffer - O(1)
+    Rope content_rope() const
+    {
+        return clip_.load(std::memory_order_acquire)->rope;
+    }
+
+    void set_content(std::string content)
+    {
+        set_content(std::make_shared<const std::string>(std::move(content)));
+    }
+
+    void set_content(std::shared_ptr<const std::string> content)
     {
-        std::lock_guard<std::mutex> lk{content_mtx_};
+        if (!content)
+            content = std::make_shared<const std::string>();
 
-        return content_;
+        clip_.store(make_clip(std::move(content)), std::memory_order_release);
     }
 
-    void set_content(const std::string& content)
+private:
+    static std::shared_ptr<const Clip> make_clip(std::shared_ptr<const std::string> text)
     {
-        std::lock_guard<std::mutex> lk{content_mtx_};
+        Rope rope{text};
 
-        content_ = content;
+        return std::make_shared<const Clip>(Clip{std::move(text), std::move(rope)});
     }
 };
 
@@ -0,0 +1,452 @@
+#include "collab_hub.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+CollabHub::CollabHub(std::filesystem::path path, size_t max_history)
+    : path_{std::move(path)}
+    , max_history_{max_history}
+{
+    throw std::runtime_error("Collaboration needs Unix domain sockets - not supported on Windows");
+}
+
+CollabHub::~CollabHub() = default;
+
+void CollabHub::relay_loop(std::stop_token)
+{
+}
+
+CollabClient::CollabClient(const std::filesystem::path&)
+{
+    throw std::runtime_error("Collaboration needs Unix domain sockets - not supported on Windows");
+}
+
+CollabClient::~CollabClient() = default;
+
+void CollabClient::send(std::string_view)
+{
+}
+
+std::vector<std::string> CollabClient::receive(std::chrono::milliseconds)
+{
+    return {};
+}
+
+#else
+
+namespace
+{
+    constexpr size_t frame_header_size = sizeof(uint32_t);
+    constexpr size_t read_block_size = 64 * 1024;
+
+    [[noreturn]] void throw_system_error(const std::string& what)
+    {
+        throw std::system_error(errno, std::system_category(), what);
+    }
+
+    void put_frame(std::string& out, std::string_view payload)
+    {
+        if (payload.size() > UINT32_MAX)
+            throw std::length_error("Frame too long");
+
+        auto size = static_cast<uint32_t>(payload.size());
+        for (size_t i = 0; i < frame_header_size; ++i, size >>= 8)
+            out.push_back(static_cast<char>(size & 0xFF));
+        out.append(payload);
+    }
+
+    // payloads of the complete frames at the start of buffer - they are removed from it
+    std::vector<std::string> take_complete_frames(std::string& buffer)
+    {
+        std::vector<std::string> frames;
+
+        size_t pos = 0;
+        while (buffer.size() - pos >= frame_header_size)
+        {
+            uint32_t size = 0;
+            for (size_t i = frame_header_size; i-- > 0;)
+                size = (size << 8) | static_cast<uint8_t>(buffer[pos + i]);
+
+            if (buffer.size() - pos - frame_header_size < size)
+                break;
+
+            frames.push_back(buffer.substr(pos + frame_header_size, size));
+            pos += frame_header_size + size;
+        }
+
+        buffer.erase(0, pos);
+        return frames;
+    }
+
+    sockaddr_un socket_address(const std::filesystem::path& path)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+
+        const std::string name = path.string();
+        if (name.size() >= sizeof(address.sun_path))
+            throw std::invalid_argument("Socket path too long: " + name);
+
+        std::memcpy(address.sun_path, name.c_str(), name.size() + 1);
+        return address;
+    }
+
+    void set_non_blocking(int fd)
+    {
+        if (::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK) < 0)
+            throw_system_error("Cannot set a socket non-blocking");
+    }
+
+    // false if the peer has gone
+    bool read_available(int fd, std::string& buffer)
+    {
+        char block[read_block_size];
+        while (true)
+        {
+            const ssize_t read = ::recv(fd, block, sizeof(block), 0);
+            if (read > 0)
+            {
+                buffer.append(block, static_cast<size_t>(read));
+                continue;
+            }
+
+            if (read < 0 && errno == EINTR)
+                continue;
+
+            return read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+
+    // false if the peer has gone
+    bool write_available(int fd, std::string& buffer)
+    {
+        size_t written = 0;
+        while (written < buffer.size())
+        {
+            const ssize_t sent = ::send(fd, buffer.data() + written, buffer.size() - written, MSG_NOSIGNAL);
+            if (sent >= 0)
+            {
+                written += static_cast<size_t>(sent);
+                continue;
+            }
+
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                return false;
+
+            break;
+        }
+
+        buffer.erase(0, written);
+        return true;
+    }
+
+    // false for the socket file of a hub that crashed - nothing accepts connections on it
+    bool hub_listening(const sockaddr_un& address)
+    {
+        const int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (probe < 0)
+            return true; // cannot tell - the file is kept
+
+        const bool refused = ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 && errno == ECONNREFUSED;
+        ::close(probe);
+
+        return !refused;
+    }
+
+    struct Peer
+    {
+        int fd;
+        std::string in;
+        std::string out;
+    };
+} // namespace
+
+CollabHub::CollabHub(std::filesystem::path path, size_t max_history)
+    : path_{std::move(path)}
+    , max_history_{max_history}
+{
+    const sockaddr_un address = socket_address(path_);
+
+    listener_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener_ < 0)
+        throw_system_error("Cannot create a socket");
+
+    const auto bind_listener = [&] { return ::bind(listener_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0; };
+
+    // the file is removed only if no hub answers on it - a live session is never taken over
+    bool bound = bind_listener();
+    if (!bound && errno == EADDRINUSE)
+    {
+        if (hub_listening(address))
+        {
+            ::close(listener_);
+            throw std::system_error(std::make_error_code(std::errc::address_in_use), "A collaboration hub listens on " + path_.string());
+        }
+
+        std::error_code ignored;
+        std::filesystem::remove(path_, ignored);
+        bound = bind_listener();
+    }
+
+    if (!bound || ::listen(listener_, SOMAXCONN) < 0 || ::pipe2(wake_, O_CLOEXEC) < 0)
+    {
+        const int error = errno;
+        ::close(listener_);
+        throw std::system_error(error, std::system_category(), "Cannot listen on " + path_.string());
+    }
+
+    set_non_blocking(listener_);
+
+    relay_ = std::jthread{[this](std::stop_token stop) { relay_loop(stop); }};
+}
+
+CollabHub::~CollabHub()
+{
+    relay_.request_stop();
+    const char wake = 0;
+    [[maybe_unused]] const ssize_t written = ::write(wake_[1], &wake, 1);
+    relay_.join();
+
+    ::close(wake_[0]);
+    ::close(wake_[1]);
+    ::close(listener_);
+
+    std::error_code ignored;
+    std::filesystem::remove(path_, ignored);
+}
+
+void CollabHub::relay_loop(std::stop_token stop)
+{
+    std::vector<Peer> peers;
+    std::string history; // every frame relayed so far (up to max_history_) - replayed to clients joining later
+    uint32_t next_site = 1;
+
+    std::vector<pollfd> fds;
+
+    while (!stop.stop_requested())
+    {
+        fds.clear();
+        fds.push_back({wake_[0], POLLIN, 0});
+        fds.push_back({listener_, POLLIN, 0});
+        for (const Peer& peer : peers)
+            fds.push_back({peer.fd, static_cast<short>(POLLIN | (peer.out.empty() ? 0 : POLLOUT)), 0});
+
+        if (::poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        std::vector<bool> gone(peers.size(), false);
+
+        // reading first - frames of this round are sent in the same round
+        for (size_t i = 0; i < peers.size(); ++i)
+        {
+            if (!(fds[i + 2].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+
+            gone[i] = !read_available(peers[i].fd, peers[i].in);
+
+            for (const std::string& frame : take_complete_frames(peers[i].in))
+            {
+                const size_t start = history.size();
+                put_frame(history, frame);
+                const std::string_view framed = std::string_view{history}.substr(start);
+
+                for (size_t j = 0; j < peers.size(); ++j)
+                {
+                    if (j != i)
+                        peers[j].out.append(framed);
+                }
+
+                if (!joinable_ || history.size() > max_history_)
+                {
+                    joinable_ = false;
+                    history = std::string{};
+                }
+
+                ++frames_;
+            }
+        }
+
+        for (size_t i = 0; i < peers.size(); ++i)
+        {
+            if (!gone[i] && !peers[i].out.empty())
+                gone[i] = !write_available(peers[i].fd, peers[i].out);
+        }
+
+        for (size_t i = peers.size(); i-- > 0;)
+        {
+            if (!gone[i])
+                continue;
+
+            ::close(peers[i].fd);
+            peers.erase(peers.begin() + static_cast<std::ptrdiff_t>(i));
+            --clients_;
+        }
+
+        if (fds[1].revents & POLLIN)
+        {
+            while (true)
+            {
+                const int fd = ::accept4(listener_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0)
+                    break;
+
+                Peer peer{fd, {}, {}};
+
+                if (!joinable_)
+                {
+                    put_frame(peer.out, {});
+                    write_available(fd, peer.out);
+                    ::close(fd);
+                    continue;
+                }
+
+                const uint32_t site = next_site++;
+                std::string site_bytes;
+                for (size_t i = 0; i < sizeof(site); ++i)
+                    site_bytes.push_back(static_cast<char>((site >> (8 * i)) & 0xFF));
+
+                put_frame(peer.out, site_bytes);
+                peer.out += history;
+
+                ++clients_; // counted before the client gets its site
+                if (!write_available(fd, peer.out))
+                {
+                    ::close(fd);
+                    --clients_;
+                    continue;
+                }
+
+                peers.push_back(std::move(peer));
+            }
+        }
+    }
+
+    for (const Peer& peer : peers)
+        ::close(peer.fd);
+    clients_ = 0;
+}
+
+CollabClient::CollabClient(const std::filesystem::path& path)
+{
+    const sockaddr_un address = socket_address(path);
+
+    socket_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (socket_ < 0)
+        throw_system_error("Cannot create a socket");
+
+    if (::connect(socket_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        const int error = errno;
+        ::close(socket_);
+        throw std::system_error(error, std::system_category(), "Cannot connect to " + path.string());
+    }
+
+    // the first frame is the site id
+    std::vector<std::string> frames;
+    while (frames.empty())
+    {
+        char block[frame_header_size + sizeof(uint32_t)];
+        const ssize_t read = ::recv(socket_, block, sizeof(block) - received_.size(), 0);
+        if (read <= 0)
+        {
+            if (read < 0 && errno == EINTR)
+                continue;
+
+            ::close(socket_);
+            throw std::runtime_error("Collaboration hub at " + path.string() + " closed the connection");
+        }
+
+        received_.append(block, static_cast<size_t>(read));
+        frames = take_complete_frames(received_);
+    }
+
+    if (frames.front().empty())
+    {
+        ::close(socket_);
+        throw std::runtime_error("Collaboration session at " + path.string() + " is too long to join");
+    }
+
+    if (frames.front().size() != sizeof(uint32_t))
+    {
+        ::close(socket_);
+        throw std::runtime_error("Unexpected greeting of the collaboration hub at " + path.string());
+    }
+
+    for (size_t i = sizeof(uint32_t); i-- > 0;)
+        site_ = (site_ << 8) | static_cast<uint8_t>(frames.front()[i]);
+
+    set_non_blocking(socket_);
+}
+
+CollabClient::~CollabClient()
+{
+    ::close(socket_);
+}
+
+void CollabClient::send(std::string_view payload)
+{
+    std::string frame;
+    frame.reserve(frame_header_size + payload.size());
+    put_frame(frame, payload);
+
+    size_t written = 0;
+    while (written < frame.size())
+    {
+        const ssize_t sent = ::send(socket_, frame.data() + written, frame.size() - written, MSG_NOSIGNAL);
+        if (sent >= 0)
+        {
+            written += static_cast<size_t>(sent);
+            continue;
+        }
+
+        if (errno == EINTR)
+            continue;
+
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            connected_ = false;
+            throw_system_error("Cannot send to the collaboration hub");
+        }
+
+        // the hub reads everything it gets - its socket buffer is full only for a moment
+        pollfd fd{socket_, POLLOUT, 0};
+        ::poll(&fd, 1, -1);
+    }
+}
+
+std::vector<std::string> CollabClient::receive(std::chrono::milliseconds timeout)
+{
+    if (!connected_)
+        return take_complete_frames(received_);
+
+    if (timeout.count() > 0)
+    {
+        pollfd fd{socket_, POLLIN, 0};
+        ::poll(&fd, 1, static_cast<int>(timeout.count()));
+    }
+
+    connected_ = read_available(socket_, received_);
+
+    return take_complete_frames(received_);
+}
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef COLLAB_HUB_HPP
+#define COLLAB_HUB_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Frames exchanged over a Unix domain socket: payload size (u32, little-endian) & payload.
+
+// Relays the frames of editor processes on one host. A client connecting gets its site id (u32
+// frame) and every frame sent before, so it catches up with the session; then each frame a client
+// sends is forwarded to all the others. A poll loop on its own thread serves all the clients with
+// non-blocking sockets - a slow client only grows its own send buffer.
+//
+// The frames kept for catching up are bounded by max_history bytes - once a session has sent more,
+// they are dropped and clients connecting later are turned away (an empty greeting frame), while
+// the clients in the session go on.
+class CollabHub
+{
+    std::filesystem::path path_;
+    size_t max_history_;
+    int listener_ = -1;
+    int wake_[2] = {-1, -1}; // pipe that interrupts poll() on shutdown
+
+    std::atomic<size_t> clients_ = 0;
+    std::atomic<uint64_t> frames_ = 0;
+    std::atomic<bool> joinable_ = true;
+
+    std::jthread relay_;
+
+public:
+    static constexpr size_t default_max_history = 64 * 1024 * 1024;
+
+    // listens on a new socket file at path - the file of a hub that crashed is replaced. Throws
+    // std::system_error (address_in_use) if a hub listens at path.
+    explicit CollabHub(std::filesystem::path path, size_t max_history = default_max_history);
+
+    CollabHub(const CollabHub&) = delete;
+    CollabHub& operator=(const CollabHub&) = delete;
+
+    // disconnects the clients & removes the socket file
+    ~CollabHub();
+
+    const std::filesystem::path& path() const
+    {
+        return path_;
+    }
+
+    size_t clients() const
+    {
+        return clients_;
+    }
+
+    // frames received from the clients
+    uint64_t frames() const
+    {
+        return frames_;
+    }
+
+    // false once the session has outgrown max_history - new clients are turned away
+    bool joinable() const
+    {
+        return joinable_;
+    }
+
+private:
+    void relay_loop(std::stop_token stop);
+};
+
+// connection of an editor process to a CollabHub
+class CollabClient
+{
+    int socket_ = -1;
+    uint32_t site_ = 0;
+    std::string received_; // bytes of an incomplete frame
+    bool connected_ = true;
+
+public:
+    // throws std::system_error if no hub listens at path, std::runtime_error if the hub turns
+    // the client away
+    explicit CollabClient(const std::filesystem::path& path);
+
+    CollabClient(const CollabClient&) = delete;
+    CollabClient& operator=(const CollabClient&) = delete;
+
+    ~CollabClient();
+
+    // unique in the session, never 0
+    uint32_t site() const
+    {
+        return site_;
+    }
+
+    // false once the hub has closed the connection
+    bool connected() const
+    {
+        return connected_;
+    }
+
+    void send(std::string_view payload);
+
+    // frames of the other clients - waits up to timeout for the first one
+    std::vector<std::string> receive(std::chrono::milliseconds timeout = std::chrono::milliseconds{0});
+};
+
+#endif // COLLAB_HUB_HPP
@@ -3,9 +3,508 @@
 
 #include "clipboard.hpp"
 #include "console.hpp"
+#include "diff.hpp"
 #include "document.hpp"
+#include "undo_history.hpp"
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <sstream>
 #include <stack>
+#include <string>
+#include <system_error>
+#include <vector>
 
+class Command
+{
+public:
+    virtual void execute() = 0;
+    virtual ~Command() = default;
+};
+
+// "in 1.23 ms (4.56 GB/s)" - throughput of processing bytes of text
+inline std::string format_throughput(size_t bytes, std::chrono::duration<double> elapsed)
+{
+    std::ostringstream out;
+    out.precision(3);
+    out << "in " << elapsed.count() * 1e3 << " ms (" << bytes / std::max(elapsed.count(), 1e-9) / 1e9 << " GB/s)";
+
+    return out.str();
+}
+
+class PrintCmd : public Command
+{
+    Document& doc_;
+    Console& console_;
+
+public:
+    PrintCmd(Document& doc, Console& console)
+        : doc_{doc}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        console_.print("[" + doc_.text() + "]");
+    }
+};
+
+// "Characters: 12, words: 3, lines: 2" - read from the counts kept by the text, not by scanning it
+class StatsCmd : public Command
+{
+    Document& doc_;
+    Console& console_;
+
+public:
+    StatsCmd(Document& doc, Console& console)
+        : doc_{doc}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        console_.print("Characters: " + std::to_string(doc_.length()) + ", words: " + std::to_string(doc_.word_count()) +
+            ", lines: " + std::to_string(doc_.line_count()));
+    }
+};
+
+class AddTextCmd : public Command
+{
+    Document& doc_;
+    Console& console_;
+
+public:
+    AddTextCmd(Document& doc, Console& console)
+        : doc_{doc}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        console_.print("Enter text:");
+        doc_.add_text(console_.get_line());
+    }
+};
+
+class ToUpperCmd : public Command
+{
+    Document& doc_;
+
+public:
+    explicit ToUpperCmd(Document& doc)
+        : doc_{doc}
+    {
+    }
+
+    void execute() override
+    {
+        doc_.to_upper();
+    }
+};
+
+class ToLowerCmd : public Command
+{
+    Document& doc_;
+
+public:
+    explicit ToLowerCmd(Document& doc)
+        : doc_{doc}
+    {
+    }
+
+    void execute() override
+    {
+        doc_.to_lower();
+    }
+};
+
+class ClearCmd : public Command
+{
+    Document& doc_;
+
+public:
+    explicit ClearCmd(Document& doc)
+        : doc_{doc}
+    {
+    }
+
+    void execute() override
+    {
+        doc_.clear();
+    }
+};
+
+class FlushCmd : public Command
+{
+    Console& console_;
+
+public:
+    explicit FlushCmd(Console& console)
+        : console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        console_.flush();
+    }
+};
+
+class CopyCmd : public Command
+{
+    Document& doc_;
+    SharedClipboard& clipboard_;
+
+public:
+    CopyCmd(Document& doc, SharedClipboard& clipboard)
+        : doc_{doc}
+        , clipboard_{clipboard}
+    {
+    }
+
+    void execute() override
+    {
+        clipboard_.set_content(doc_.text());
+    }
+};
+
+// the pasted text references the clipboard buffer - no copy is made until the text is changed
+class PasteCmd : public Command
+{
+    Document& doc_;
+    SharedClipboard& clipboard_;
+
+public:
+    PasteCmd(Document& doc, SharedClipboard& clipboard)
+        : doc_{doc}
+        , clipboard_{clipboard}
+    {
+    }
+
+    void execute() override
+    {
+        doc_.add_text(clipboard_.content_rope());
+    }
+};
+
+class OpenCmd : public Command
+{
+    Document& doc_;
+    Console& console_;
+
+public:
+    OpenCmd(Document& doc, Console& console)
+        : doc_{doc}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        console_.print("Enter file name:");
+        const std::string path = console_.get_line();
+
+        try
+        {
+            doc_.open(path);
+        }
+        catch (const std::system_error& e)
+        {
+            console_.print(std::string{"Error: "} + e.what());
+        }
+    }
+};
+
+class SaveCmd : public Command
+{
+    Document& doc_;
+    Console& console_;
+
+public:
+    SaveCmd(Document& doc, Console& console)
+        : doc_{doc}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        console_.print("Enter file name:");
+        const std::string path = console_.get_line();
+
+        try
+        {
+            doc_.save(path);
+        }
+        catch (const std::system_error& e)
+        {
+            console_.print(std::string{"Error: "} + e.what());
+        }
+    }
+};
+
+// changes of the document since it was last opened or saved - or since a file when a name is given;
+// "line 3: -[old] +[new]"
+class DiffCmd : public Command
+{
+    Document& doc_;
+    Console& console_;
+
+    static constexpr size_t max_shown = 60;
+
+public:
+    DiffCmd(Document& doc, Console& console)
+        : doc_{doc}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        console_.print("Enter file name (empty - the last opened or saved text):");
+        const std::string path = console_.get_line();
+
+        Rope saved = doc_.saved().rope();
+        if (!path.empty())
+        {
+            try
+            {
+                saved = map_file(path);
+            }
+            catch (const std::system_error& e)
+            {
+                console_.print(std::string{"Error: "} + e.what());
+                return;
+            }
+        }
+
+        const Document::Snapshot current = doc_.snapshot();
+
+        const auto start = std::chrono::steady_clock::now();
+        const std::vector<DiffHunk> hunks = diff(saved, current.rope());
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        console_.print("Found " + std::to_string(hunks.size()) + " change(s) " + format_throughput(saved.size() + current.length(), elapsed));
+
+        for (const DiffHunk& hunk : hunks)
+        {
+            console_.print("line " + std::to_string(current.rope().line_of(hunk.new_pos) + 1) + ": -[" +
+                shown(saved, hunk.old_pos, hunk.old_count) + "] +[" + shown(current.rope(), hunk.new_pos, hunk.new_count) + "]");
+        }
+    }
+
+private:
+    static std::string shown(const Rope& text, size_t pos, size_t count)
+    {
+        return (count <= max_shown) ? text.substr(pos, count) : text.substr(pos, max_shown) + "...";
+    }
+};
+
+class FindCmd : public Command
+{
+    Document& doc_;
+    Console& console_;
+
+public:
+    FindCmd(Document& doc, Console& console)
+        : doc_{doc}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        console_.print("Enter text to find:");
+        const std::string pattern = console_.get_line();
+
+        if (pattern.empty())
+            return;
+
+        const size_t pos = doc_.find(pattern);
+
+        if (pos == std::string::npos)
+            console_.print("Not found");
+        else
+            console_.print("Found at " + std::to_string(pos) + " (line " + std::to_string(doc_.line_of(pos) + 1) + ")");
+    }
+};
+
+class FindAllCmd : public Command
+{
+    Document& doc_;
+    Console& console_;
+
+public:
+    FindAllCmd(Document& doc, Console& console)
+        : doc_{doc}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        console_.print("Enter text to find:");
+        const std::string pattern = console_.get_line();
+
+        if (pattern.empty())
+            return;
+
+        const auto start = std::chrono::steady_clock::now();
+        const std::vector<size_t> occurrences = doc_.find_all(pattern);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        console_.print("Found " + std::to_string(occurrences.size()) + " occurrence(s) " + format_throughput(doc_.length(), elapsed));
+
+        for (size_t pos : occurrences)
+            console_.print(std::to_string(pos) + " (line " + std::to_string(doc_.line_of(pos) + 1) + ")");
+    }
+};
+
+class ReplaceAllCmd : public Command
+{
+    Document& doc_;
+    Console& console_;
+
+public:
+    ReplaceAllCmd(Document& doc, Console& console)
+        : doc_{doc}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        console_.print("Enter text to find:");
+        const std::string pattern = console_.get_line();
+
+        if (pattern.empty())
+            return;
+
+        console_.print("Enter replacement:");
+        const std::string replacement = console_.get_line();
+
+        const size_t length = doc_.length();
+        const auto start = std::chrono::steady_clock::now();
+        const size_t replaced = doc_.replace_all(pattern, replacement);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        console_.print("Replaced " + std::to_string(replaced) + " occurrence(s) " + format_throughput(length, elapsed));
+    }
+};
+
+class IndexCmd : public Command
+{
+    Document& doc_;
+    Console& console_;
+
+public:
+    IndexCmd(Document& doc, Console& console)
+        : doc_{doc}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        const auto start = std::chrono::steady_clock::now();
+        doc_.build_index();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        std::ostringstream memory;
+        memory.precision(3);
+        memory << doc_.index_memory() / (1024.0 * 1024.0) << " MiB";
+
+        console_.print("Index built " + format_throughput(doc_.length(), elapsed) + " - " + memory.str());
+    }
+};
+
+// records the state of the document before an editing command runs
+class CheckpointCmd : public Command
+{
+    UndoHistory& history_;
+    std::shared_ptr<Command> cmd_;
+
+public:
+    CheckpointCmd(UndoHistory& history, std::shared_ptr<Command> cmd)
+        : history_{history}
+        , cmd_{std::move(cmd)}
+    {
+    }
+
+    void execute() override
+    {
+        history_.checkpoint();
+        cmd_->execute();
+    }
+};
+
+class UndoCmd : public Command
+{
+    UndoHistory& history_;
+    Console& console_;
+
+public:
+    UndoCmd(UndoHistory& history, Console& console)
+        : history_{history}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        if (!history_.undo())
+            console_.print("Nothing to undo");
+    }
+};
+
+class RedoCmd : public Command
+{
+    UndoHistory& history_;
+    Console& console_;
+
+public:
+    RedoCmd(UndoHistory& history, Console& console)
+        : history_{history}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        if (!history_.redo())
+            console_.print("Nothing to redo");
+    }
+};
+
+// "History: 12 entries, 1.5 MiB (3.2x compressed), undo p50/p90/p99: 12/40/95 us"
+class HistoryCmd : public Command
+{
+    UndoHistory& history_;
+    Console& console_;
+
+public:
+    HistoryCmd(UndoHistory& history, Console& console)
+        : history_{history}
+        , console_{console}
+    {
+    }
+
+    void execute() override
+    {
+        const UndoHistoryStats stats = history_.stats();
+        const auto us = [](std::chrono::nanoseconds latency) { return std::chrono::duration<double, std::micro>(latency).count(); };
+
+        std::ostringstream out;
+        out.precision(3);
+        out << "History: " << stats.entries << " entries, " << stats.bytes_used / (1024.0 * 1024.0) << " MiB ("
+            << stats.compression_ratio << "x compressed), undo p50/p90/p99: " << us(stats.undo_p50) << "/"
+            << us(stats.undo_p90) << "/" << us(stats.undo_p99) << " us";
+
+        console_.print(out.str());
+    }
+};
 
 #endif // COMMAND_HPP
@@ -2,30 +2,58 @@
 #define CONSOLE_HPP
 
 #include <iostream>
+#include <stdexcept>
 #include <string>
 
+// thrown by Console::get_line() once the input has ended - Application::run() returns, aborting a
+// command that was reading its arguments
+struct EndOfInput : std::runtime_error
+{
+    EndOfInput()
+        : std::runtime_error("End of input")
+    {
+    }
+};
+
 class Console
 {
 public:
+    // throws EndOfInput at the end of the input
     virtual std::string get_line() = 0;
+
+    // reads the name of the next command - called between commands, unlike the get_line() of
+    // their arguments
+    virtual std::string get_command()
+    {
+        return get_line();
+    }
+
     virtual void print(const std::string& line) = 0;
+    virtual void flush() {}
     virtual ~Console() = default;
 };
 
 class Terminal : public Console
 {
 public:
+    // std::cin is tied to std::cout - the output is flushed before every read, not after every line
     std::string get_line() override
     {
         std::string line;
-        std::getline(std::cin, line);
+        if (!std::getline(std::cin, line))
+            throw EndOfInput{};
 
         return line;
     }
 
     void print(const std::string& line) override
     {
-        std::cout << line << std::endl;
+        std::cout << line << '\n';
+    }
+
+    void flush() override
+    {
+        std::cout.flush();
     }
 };
 
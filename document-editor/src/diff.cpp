@@ -0,0 +1,481 @@
+#include "diff.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+    std::vector<std::string_view> chunks_of(const Rope& text, size_t pos, size_t count)
+    {
+        std::vector<std::string_view> chunks;
+        text.for_each_chunk(pos, count, [&chunks](std::string_view chunk) { chunks.push_back(chunk); });
+
+        return chunks;
+    }
+
+    size_t mismatch(const char* a, const char* b, size_t count)
+    {
+        constexpr size_t block = 64;
+
+        size_t pos = 0;
+        while (pos + block <= count && std::memcmp(a + pos, b + pos, block) == 0)
+            pos += block;
+
+        while (pos < count && a[pos] == b[pos])
+            ++pos;
+
+        return pos;
+    }
+
+    size_t mismatch_backward(const char* a_end, const char* b_end, size_t count)
+    {
+        constexpr size_t block = 64;
+
+        size_t matched = 0;
+        while (matched + block <= count && std::memcmp(a_end - matched - block, b_end - matched - block, block) == 0)
+            matched += block;
+
+        while (matched < count && a_end[-1 - static_cast<ptrdiff_t>(matched)] == b_end[-1 - static_cast<ptrdiff_t>(matched)])
+            ++matched;
+
+        return matched;
+    }
+
+    // length of the common prefix - chunks at the same address are equal without comparing them
+    size_t common_prefix(const std::vector<std::string_view>& a, const std::vector<std::string_view>& b)
+    {
+        size_t length = 0;
+        std::string_view x, y;
+
+        for (size_t i = 0, j = 0;;)
+        {
+            if (x.empty() && i < a.size())
+            {
+                x = a[i++];
+                continue;
+            }
+            if (y.empty() && j < b.size())
+            {
+                y = b[j++];
+                continue;
+            }
+            if (x.empty() || y.empty())
+                return length;
+
+            const size_t count = std::min(x.size(), y.size());
+            const size_t matched = (x.data() == y.data()) ? count : mismatch(x.data(), y.data(), count);
+
+            length += matched;
+            if (matched < count)
+                return length;
+
+            x.remove_prefix(count);
+            y.remove_prefix(count);
+        }
+    }
+
+    size_t common_suffix(const std::vector<std::string_view>& a, const std::vector<std::string_view>& b, size_t limit)
+    {
+        size_t length = 0;
+        std::string_view x, y;
+
+        for (size_t i = a.size(), j = b.size(); length < limit;)
+        {
+            if (x.empty() && i > 0)
+            {
+                x = a[--i];
+                continue;
+            }
+            if (y.empty() && j > 0)
+            {
+                y = b[--j];
+                continue;
+            }
+            if (x.empty() || y.empty())
+                break;
+
+            const char* x_end = x.data() + x.size();
+            const char* y_end = y.data() + y.size();
+            const size_t count = std::min({x.size(), y.size(), limit - length});
+            const size_t matched = (x_end == y_end) ? count : mismatch_backward(x_end, y_end, count);
+
+            length += matched;
+            if (matched < count)
+                break;
+
+            x.remove_suffix(count);
+            y.remove_suffix(count);
+        }
+
+        return length;
+    }
+
+    uint64_t load(const char* p, size_t count)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, p, count);
+        return word;
+    }
+
+    // hashes the line 8 bytes at a time
+    uint64_t hash_line(std::string_view line)
+    {
+        uint64_t hash = 0x9E3779B97F4A7C15ull * (line.size() + 1);
+
+        const auto mix = [&hash](uint64_t word) {
+            hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+            hash ^= hash >> 31;
+        };
+
+        size_t pos = 0;
+        for (; pos + 8 <= line.size(); pos += 8)
+            mix(load(line.data() + pos, 8));
+        if (pos < line.size())
+            mix(load(line.data() + pos, line.size() - pos));
+
+        hash ^= hash >> 29;
+        hash *= 0x94D049BB133111EBull;
+        return hash ^ (hash >> 32);
+    }
+
+    // hashes of the lines ('\n' included) of a range & their start offsets, lines may span chunks
+    struct Lines
+    {
+        std::vector<uint64_t> hashes;
+        std::vector<size_t> starts; // starts[i + 1] is the end of line i
+
+        Lines(const Rope& text, size_t pos, size_t count)
+        {
+            const size_t lines = text.line_of(pos + count) - text.line_of(pos) + 1;
+            hashes.reserve(lines);
+            starts.reserve(lines + 1);
+            starts.push_back(pos);
+
+            std::string spanning; // line started in an earlier chunk
+            size_t offset = pos;
+
+            text.for_each_chunk(pos, count, [&](std::string_view chunk) {
+                while (!chunk.empty())
+                {
+                    const auto* newline = static_cast<const char*>(std::memchr(chunk.data(), '\n', chunk.size()));
+                    if (!newline)
+                    {
+                        spanning.append(chunk);
+                        offset += chunk.size();
+                        return;
+                    }
+
+                    const std::string_view line = chunk.substr(0, newline - chunk.data() + 1);
+                    if (spanning.empty())
+                    {
+                        hashes.push_back(hash_line(line));
+                    }
+                    else
+                    {
+                        spanning.append(line);
+                        hashes.push_back(hash_line(spanning));
+                        spanning.clear();
+                    }
+
+                    offset += line.size();
+                    starts.push_back(offset);
+                    chunk.remove_prefix(line.size());
+                }
+            });
+
+            if (!spanning.empty())
+            {
+                hashes.push_back(hash_line(spanning));
+                starts.push_back(offset);
+            }
+        }
+    };
+
+    // Myers' linear space diff - the middle snake of the shortest edit script splits the problem in two.
+    // equal(i, j) compares element i of the old sequence with element j of the new one.
+    template <typename Equal>
+    class Myers
+    {
+        Equal equal_;
+        size_t max_cost_;
+        std::vector<DiffHunk>& hunks_;
+        std::vector<ptrdiff_t> forward_;
+        std::vector<ptrdiff_t> backward_;
+
+    public:
+        Myers(Equal equal, size_t max_cost, std::vector<DiffHunk>& hunks)
+            : equal_{std::move(equal)}
+            , max_cost_{max_cost}
+            , hunks_{hunks}
+        {
+        }
+
+        void compare(size_t a_begin, size_t a_end, size_t b_begin, size_t b_end)
+        {
+            while (a_begin < a_end && b_begin < b_end && equal_(a_begin, b_begin))
+                ++a_begin, ++b_begin;
+
+            while (a_begin < a_end && b_begin < b_end && equal_(a_end - 1, b_end - 1))
+                --a_end, --b_end;
+
+            if (a_begin == a_end || b_begin == b_end)
+            {
+                add(a_begin, a_end, b_begin, b_end);
+                return;
+            }
+
+            const auto split = middle_snake(a_begin, a_end, b_begin, b_end);
+            if (!split)
+            {
+                add(a_begin, a_end, b_begin, b_end); // too costly to search - one hunk
+                return;
+            }
+
+            compare(a_begin, split->first, b_begin, split->second);
+            compare(split->first, a_end, split->second, b_end);
+        }
+
+    private:
+        void add(size_t a_begin, size_t a_end, size_t b_begin, size_t b_end)
+        {
+            if (a_begin == a_end && b_begin == b_end)
+                return;
+
+            if (!hunks_.empty())
+            {
+                DiffHunk& last = hunks_.back();
+                if (last.old_pos + last.old_count == a_begin && last.new_pos + last.new_count == b_begin)
+                {
+                    last.old_count += a_end - a_begin;
+                    last.new_count += b_end - b_begin;
+                    return;
+                }
+            }
+
+            hunks_.push_back({a_begin, a_end - a_begin, b_begin, b_end - b_begin});
+        }
+
+        // searches from both ends at once until the paths overlap - the furthest reaching forward and
+        // backward paths of d edits are kept per diagonal k = x - y. nullopt if it takes more than max_cost
+        std::optional<std::pair<size_t, size_t>> middle_snake(size_t a_begin, size_t a_end, size_t b_begin, size_t b_end)
+        {
+            const auto n = static_cast<ptrdiff_t>(a_end - a_begin);
+            const auto m = static_cast<ptrdiff_t>(b_end - b_begin);
+            const ptrdiff_t max_d = std::min<ptrdiff_t>((n + m + 1) / 2, static_cast<ptrdiff_t>(max_cost_) + 1);
+            const ptrdiff_t offset = max_d;
+            const ptrdiff_t delta = n - m;
+            const bool odd = (delta % 2) != 0;
+
+            forward_.assign(2 * max_d + 2, -1);
+            backward_.assign(2 * max_d + 2, -1);
+            forward_[offset + 1] = 0;
+            backward_[offset + 1] = 0;
+
+            // diagonals that left the grid are not extended any more
+            ptrdiff_t forward_start = 0, forward_end = 0, backward_start = 0, backward_end = 0;
+
+            const auto a = [&](ptrdiff_t x) { return a_begin + static_cast<size_t>(x); };
+            const auto b = [&](ptrdiff_t y) { return b_begin + static_cast<size_t>(y); };
+
+            for (ptrdiff_t d = 0; d < max_d; ++d)
+            {
+                for (ptrdiff_t k = -d + forward_start; k <= d - forward_end; k += 2)
+                {
+                    const ptrdiff_t i = offset + k;
+                    ptrdiff_t x = (k == -d || (k != d && forward_[i - 1] < forward_[i + 1])) ? forward_[i + 1] : forward_[i - 1] + 1;
+                    ptrdiff_t y = x - k;
+
+                    while (x < n && y < m && equal_(a(x), b(y)))
+                        ++x, ++y;
+
+                    forward_[i] = x;
+
+                    if (x > n)
+                        forward_end += 2;
+                    else if (y > m)
+                        forward_start += 2;
+                    else if (odd)
+                    {
+                        const ptrdiff_t j = offset + delta - k;
+                        if (j >= 0 && j < static_cast<ptrdiff_t>(backward_.size()) && backward_[j] != -1 && x >= n - backward_[j])
+                            return std::pair{a(x), b(y)};
+                    }
+                }
+
+                for (ptrdiff_t k = -d + backward_start; k <= d - backward_end; k += 2)
+                {
+                    const ptrdiff_t i = offset + k;
+                    ptrdiff_t x = (k == -d || (k != d && backward_[i - 1] < backward_[i + 1])) ? backward_[i + 1] : backward_[i - 1] + 1;
+                    ptrdiff_t y = x - k;
+
+                    while (x < n && y < m && equal_(a(n - x - 1), b(m - y - 1)))
+                        ++x, ++y;
+
+                    backward_[i] = x;
+
+                    if (x > n)
+                        backward_end += 2;
+                    else if (y > m)
+                        backward_start += 2;
+                    else if (!odd)
+                    {
+                        const ptrdiff_t j = offset + delta - k;
+                        if (j >= 0 && j < static_cast<ptrdiff_t>(forward_.size()) && forward_[j] != -1)
+                        {
+                            const ptrdiff_t forward_x = forward_[j];
+                            const ptrdiff_t forward_y = forward_x - (j - offset);
+                            if (forward_x >= n - x)
+                                return std::pair{a(forward_x), b(forward_y)};
+                        }
+                    }
+                }
+            }
+
+            return std::nullopt;
+        }
+    };
+
+    template <typename Equal>
+    void myers_diff(size_t old_size, size_t new_size, Equal equal, std::vector<DiffHunk>& hunks)
+    {
+        Myers<Equal>{std::move(equal), diff_max_cost, hunks}.compare(0, old_size, 0, new_size);
+    }
+
+    // start of the line holding pos
+    size_t line_begin(const Rope& text, size_t pos)
+    {
+        return text.line_start(text.line_of(pos));
+    }
+
+    // pos if it starts a line (or is the end), else the start of the next line
+    size_t line_end(const Rope& text, size_t pos)
+    {
+        if (pos == 0 || pos == text.size() || text.at(pos - 1) == '\n')
+            return pos;
+
+        const size_t line = text.line_of(pos);
+        return (line < text.newlines()) ? text.line_start(line + 1) : text.size();
+    }
+
+    // changes of whole lines old_text[old_begin, old_end) -> new_text[new_begin, new_end): the common
+    // prefix & suffix are skipped, the lines between them are matched by hash, changed lines are
+    // diffed again character by character
+    void diff_lines(const Rope& old_text, size_t old_begin, size_t old_end, const Rope& new_text, size_t new_begin,
+        size_t new_end, std::vector<DiffHunk>& hunks)
+    {
+        const auto old_chunks = chunks_of(old_text, old_begin, old_end - old_begin);
+        const auto new_chunks = chunks_of(new_text, new_begin, new_end - new_begin);
+
+        const size_t prefix = common_prefix(old_chunks, new_chunks);
+        if (prefix == old_end - old_begin && prefix == new_end - new_begin)
+            return;
+
+        const size_t suffix = common_suffix(old_chunks, new_chunks, std::min(old_end - old_begin, new_end - new_begin) - prefix);
+
+        // the changed range widened to whole lines - by the same amount in both texts, as the prefix & suffix are equal
+        const size_t begin_offset = line_begin(old_text, old_begin + prefix) - old_begin;
+        const size_t end_offset = old_end - line_end(old_text, old_end - suffix);
+
+        const Lines old_lines{old_text, old_begin + begin_offset, old_end - end_offset - old_begin - begin_offset};
+        const Lines new_lines{new_text, new_begin + begin_offset, new_end - end_offset - new_begin - begin_offset};
+
+        std::vector<DiffHunk> line_hunks;
+        myers_diff(old_lines.hashes.size(), new_lines.hashes.size(),
+            [&](size_t i, size_t j) { return old_lines.hashes[i] == new_lines.hashes[j]; }, line_hunks);
+
+        for (const DiffHunk& lines : line_hunks)
+        {
+            const size_t old_pos = old_lines.starts[lines.old_pos];
+            const size_t old_count = old_lines.starts[lines.old_pos + lines.old_count] - old_pos;
+            const size_t new_pos = new_lines.starts[lines.new_pos];
+            const size_t new_count = new_lines.starts[lines.new_pos + lines.new_count] - new_pos;
+
+            if (old_count == 0 || new_count == 0 || old_count + new_count > diff_refine_limit)
+            {
+                hunks.push_back({old_pos, old_count, new_pos, new_count});
+                continue;
+            }
+
+            const std::string old_part = old_text.substr(old_pos, old_count);
+            const std::string new_part = new_text.substr(new_pos, new_count);
+
+            std::vector<DiffHunk> refined;
+            myers_diff(old_count, new_count, [&](size_t i, size_t j) { return old_part[i] == new_part[j]; }, refined);
+
+            for (const DiffHunk& chars : refined)
+                hunks.push_back({old_pos + chars.old_pos, chars.old_count, new_pos + chars.new_pos, chars.new_count});
+        }
+    }
+
+    bool share_chunks(const std::vector<std::string_view>& a, const std::vector<std::string_view>& b)
+    {
+        std::vector<const char*> addresses;
+        addresses.reserve(a.size());
+        for (std::string_view chunk : a)
+            addresses.push_back(chunk.data());
+        std::sort(addresses.begin(), addresses.end());
+
+        return std::any_of(b.begin(), b.end(),
+            [&addresses](std::string_view chunk) { return std::binary_search(addresses.begin(), addresses.end(), chunk.data()); });
+    }
+} // namespace
+
+std::vector<DiffHunk> diff(const Rope& old_text, const Rope& new_text)
+{
+    std::vector<DiffHunk> hunks;
+
+    const auto old_chunks = chunks_of(old_text, 0, old_text.size());
+    const auto new_chunks = chunks_of(new_text, 0, new_text.size());
+
+    if (!share_chunks(old_chunks, new_chunks))
+    {
+        diff_lines(old_text, 0, old_text.size(), new_text, 0, new_text.size(), hunks);
+        return hunks;
+    }
+
+    // versions of one document: chunks at the same address are equal, so the chunks are matched
+    // first and only the ranges between the shared ones are read - widened to whole lines and merged
+    // where they overlap then
+    std::vector<DiffHunk> chunk_hunks;
+    myers_diff(old_chunks.size(), new_chunks.size(), [&](size_t i, size_t j) {
+        return old_chunks[i].data() == new_chunks[j].data() && old_chunks[i].size() == new_chunks[j].size();
+    }, chunk_hunks);
+
+    std::vector<size_t> old_offsets{0}, new_offsets{0};
+    for (std::string_view chunk : old_chunks)
+        old_offsets.push_back(old_offsets.back() + chunk.size());
+    for (std::string_view chunk : new_chunks)
+        new_offsets.push_back(new_offsets.back() + chunk.size());
+
+    std::vector<DiffHunk> ranges;
+    for (const DiffHunk& chunks : chunk_hunks)
+    {
+        const size_t old_begin = line_begin(old_text, old_offsets[chunks.old_pos]);
+        const size_t old_end = line_end(old_text, old_offsets[chunks.old_pos + chunks.old_count]);
+        const size_t new_begin = line_begin(new_text, new_offsets[chunks.new_pos]);
+        const size_t new_end = line_end(new_text, new_offsets[chunks.new_pos + chunks.new_count]);
+
+        if (!ranges.empty() && (old_begin <= ranges.back().old_pos + ranges.back().old_count ||
+                                   new_begin <= ranges.back().new_pos + ranges.back().new_count))
+        {
+            DiffHunk& last = ranges.back();
+            last.old_count = old_end - last.old_pos;
+            last.new_count = new_end - last.new_pos;
+        }
+        else
+        {
+            ranges.push_back({old_begin, old_end - old_begin, new_begin, new_end - new_begin});
+        }
+    }
+
+    for (const DiffHunk& range : ranges)
+        diff_lines(old_text, range.old_pos, range.old_pos + range.old_count, new_text, range.new_pos, range.new_pos + range.new_count, hunks);
+
+    return hunks;
+}
+
@@ -0,0 +1,39 @@
+#ifndef DIFF_HPP
+#define DIFF_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "document.hpp"
+#include "rope.hpp"
+
+// old_text[old_pos, old_pos + old_count) was replaced by new_text[new_pos, new_pos + new_count)
+struct DiffHunk
+{
+    size_t old_pos;
+    size_t old_count;
+    size_t new_pos;
+    size_t new_count;
+
+    bool operator==(const DiffHunk&) const = default;
+};
+
+// an edit script longer than this (in lines or characters) is not searched for further - the
+// remaining range is reported as one hunk, so totally different texts cost O((N + M) * limit)
+constexpr size_t diff_max_cost = 4096;
+
+// changed line ranges larger than this are not refined to characters
+constexpr size_t diff_refine_limit = 1024 * 1024;
+
+// Changes between two texts in order. The common prefix & suffix are skipped first - chunks shared
+// by both ropes (e.g. two versions of one document) are not even compared. Lines of the rest are
+// hashed and matched with Myers' O(ND) algorithm (linear space variant), then only the changed lines
+// are diffed again character by character. Lines are compared by 64-bit hashes.
+std::vector<DiffHunk> diff(const Rope& old_text, const Rope& new_text);
+
+inline std::vector<DiffHunk> diff(const Document::Snapshot& old_version, const Document::Snapshot& new_version)
+{
+    return diff(old_version.rope(), new_version.rope());
+}
+
+#endif // DIFF_HPP
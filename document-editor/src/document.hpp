@@ -3,22 +3,279 @@
 
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <cereal/archives/binary.hpp>
 #include <cereal/types/string.hpp>
 
+#include "case_conversion.hpp"
+#include "file_io.hpp"
+#include "lz_codec.hpp"
+#include "parallel_transform.hpp"
+#include "raw_archive.hpp"
+#include "rope.hpp"
+#include "search.hpp"
+#include "suffix_index.hpp"
+#include "thread_pool.hpp"
+
+// TSerializer of Document::create_memento() keeping a keyframe as a rope - serialized only when compressed
+struct RopeKeyframe
+{
+};
 
 class Document
 {
-    std::string text_;
+    // single change of the text - removed & inserted ropes share chunks with the document
+    struct Edit
+    {
+        size_t pos;
+        Rope removed;
+        Rope inserted;
+    };
+
+    // edits made between two consecutive mementos - after an undo new edits branch off, so revisions form a tree
+    struct Revision
+    {
+        mutable std::shared_ptr<const Revision> parent; // cut by truncate_history()
+        mutable std::vector<Edit> edits;                // removed ropes are emptied by compress()
+        size_t depth;
+        mutable std::string compressed_removed;         // removed text of all the edits, lz-compressed
+        mutable std::vector<size_t> removed_sizes;      // of every edit - empty unless compressed
+        mutable std::optional<Rope> keyframe;           // text after the edits - set by a keyframe memento
+
+        bool is_compressed() const
+        {
+            return !removed_sizes.empty();
+        }
+
+        // bytes of text only the history holds - inserted text is in the document or removed by a later edit
+        size_t memory_usage() const
+        {
+            return is_compressed() ? compressed_removed.size() : uncompressed_size();
+        }
+
+        size_t uncompressed_size() const
+        {
+            size_t bytes = 0;
+            for (size_t i = 0; i < edits.size(); ++i)
+                bytes += is_compressed() ? removed_sizes[i] : edits[i].removed.size();
+
+            return bytes;
+        }
+
+        // moves the removed text into compressed_removed - kept as is if it does not shrink
+        void compress() const
+        {
+            if (is_compressed() || edits.empty())
+                return;
+
+            std::string removed;
+            for (const Edit& edit : edits)
+                removed += edit.removed.str();
+
+            std::string compressed = lz_compress(removed);
+            if (compressed.size() >= removed.size())
+                return;
+
+            compressed_removed = std::move(compressed);
+            for (Edit& edit : edits)
+            {
+                removed_sizes.push_back(edit.removed.size());
+                edit.removed = Rope{};
+            }
+        }
+
+        // the edits with their removed text - decompressed into a copy while the revision is compressed
+        std::vector<Edit> uncompressed_edits() const
+        {
+            std::vector<Edit> result = edits;
+            if (!is_compressed())
+                return result;
+
+            const std::string removed = lz_decompress(compressed_removed);
+            size_t offset = 0;
+            for (size_t i = 0; i < result.size(); offset += removed_sizes[i++])
+                result[i].removed = Rope{removed.substr(offset, removed_sizes[i])};
+
+            return result;
+        }
+    };
+
+    // token held by the mementos of a history - documents only observe it, so edits are recorded
+    // only while a memento may need them, also after another document adopted the history
+    struct History
+    {
+    };
+
+    Rope text_;
+    mutable std::weak_ptr<const History> history_;
+    mutable std::shared_ptr<const Revision> head_ = std::make_shared<Revision>();
+    mutable std::vector<Edit> pending_edits_;
+    size_t keyframe_interval_ = default_keyframe_interval;
+    mutable size_t mementos_since_keyframe_ = 0;
+
+    // optional full-text index of the prefix [0, indexed_length_) - appends keep it valid while
+    // the unindexed tail is short, any other edit drops it
+    mutable std::shared_ptr<const SuffixIndex> index_;
+    mutable std::shared_future<std::shared_ptr<const SuffixIndex>> pending_index_;
+    size_t indexed_length_ = 0;
+
+public:
+    static constexpr size_t default_keyframe_interval = 32;
+    static constexpr size_t max_unindexed_tail = 1024 * 1024;
+
+    // immutable view of the text taken in O(1) - chunks are shared with the document,
+    // later edits of the document copy only the nodes they touch
+    class Snapshot
+    {
+    private:
+        Rope text_;
+        uint64_t version_;
+
+        explicit Snapshot(Rope text, uint64_t version = 0) : text_{std::move(text)}, version_{version}
+        {
+        }
+
+        friend class Document;
+
+    public:
+        // number of edits made to the document before the snapshot was taken
+        uint64_t version() const
+        {
+            return version_;
+        }
+
+        std::string text() const
+        {
+            return text_.str();
+        }
+
+        std::string text(size_t pos, size_t count) const
+        {
+            return text_.substr(pos, count);
+        }
+
+        template <typename F>
+        void for_each_chunk(F f) const
+        {
+            text_.for_each_chunk(std::move(f));
+        }
+
+        // the text shared with the document - e.g. to write it out without copying
+        const Rope& rope() const
+        {
+            return text_;
+        }
+
+        size_t length() const
+        {
+            return text_.size();
+        }
+    };
+
+    // called for every change of the text with the version that will include it - e.g. to journal edits
+    using EditListener = std::function<void(uint64_t version, size_t pos, size_t count, const Rope& inserted)>;
+
+private:
+    std::vector<std::pair<size_t, EditListener>> edit_listeners_; // id -> listener, in the order they were added
+    size_t next_listener_id_ = 0;
+
+    // the text as last opened or saved (the initial text before that) - shares its chunks with the
+    // document, so diffing it against the current text skips the unchanged ones
+    mutable Snapshot saved_{text_};
+
+    // latest version for reader threads (MVCC) - replaced after every edit, an old version lives
+    // as long as a reader holds its snapshot
+    uint64_t version_ = 0;
+    std::atomic<std::shared_ptr<const Snapshot>> published_{std::make_shared<const Snapshot>(Snapshot{text_})};
 
 public:
+    // holds a position in the edit history of a document - every keyframe_interval-th memento is a
+    // keyframe holding the whole text (none from create_delta_memento()), so it can be set on other
+    // documents and restoring it needs no long replay of edits; a memento may also wrap a Snapshot directly
     class Memento
     {
     private:
-        std::string snapshot_;
+        std::shared_ptr<const History> history_;
+        std::shared_ptr<const Revision> revision_;
+        bool is_keyframe_ = false;
+        std::string keyframe_;     // serialized keyframe - empty for delta mementos & keyframes kept as a rope
+        size_t keyframe_size_ = 0; // of the serialized keyframe - keyframe_ may hold it compressed
+        std::optional<Snapshot> snapshot_;
 
         friend class Document;
+
+    public:
+        Memento() = default;
+
+        explicit Memento(Snapshot snapshot) : snapshot_{std::move(snapshot)}
+        {
+        }
+
+        bool is_keyframe() const
+        {
+            return is_keyframe_;
+        }
+
+        // both restore the same revision of the same history
+        bool same_revision(const Memento& other) const
+        {
+            return history_ && history_ == other.history_ && revision_ == other.revision_;
+        }
+
+        bool is_compressed() const
+        {
+            return keyframe_.size() != keyframe_size_ || (revision_ && revision_->is_compressed());
+        }
+
+        // compresses the keyframe & the text removed by the recorded edits with lz_compress() - each
+        // kept as is if it does not shrink; a keyframe kept as a rope is serialized with RawOutputArchive
+        void compress()
+        {
+            if (revision_)
+                revision_->compress();
+
+            if (!is_keyframe() || keyframe_.size() != keyframe_size_)
+                return;
+
+            std::string serialized;
+            if (keyframe_.empty())
+            {
+                RawOutputArchive oarchive(serialized);
+                oarchive(*revision_->keyframe);
+            }
+            const std::string& uncompressed = keyframe_.empty() ? serialized : keyframe_;
+
+            std::string compressed = lz_compress(uncompressed);
+            if (compressed.size() < uncompressed.size())
+            {
+                keyframe_size_ = uncompressed.size();
+                keyframe_ = std::move(compressed);
+            }
+        }
+
+        // bytes held by the keyframe and the edits recorded since the previous memento
+        size_t memory_usage() const
+        {
+            return keyframe_.size() + (revision_ ? revision_->memory_usage() : 0);
+        }
+
+        // memory_usage() with nothing compressed
+        size_t uncompressed_size() const
+        {
+            return keyframe_size_ + (revision_ ? revision_->uncompressed_size() : 0);
+        }
     };
 
     Document() : text_{}
@@ -29,9 +286,52 @@ public:
     {
     }
 
+    // a copy shares the text (O(1)) & the search index - it starts with a history of its own, no
+    // edit listeners & a new published version
+    Document(const Document& other)
+        : text_{other.text_}
+        , keyframe_interval_{other.keyframe_interval_}
+        , index_{other.index_}
+        , pending_index_{other.pending_index_}
+        , indexed_length_{other.indexed_length_}
+        , saved_{other.saved_}
+    {
+    }
+
+    // steals the text - the moved-from document is left empty, with a history of its own
+    Document(Document&& other)
+        : text_{std::exchange(other.text_, Rope{})}
+        , keyframe_interval_{other.keyframe_interval_}
+        , index_{std::move(other.index_)}
+        , pending_index_{std::move(other.pending_index_)}
+        , indexed_length_{std::exchange(other.indexed_length_, 0)}
+        , saved_{other.saved_}
+    {
+        other.history_.reset();
+        other.head_ = std::make_shared<Revision>();
+        other.pending_edits_.clear();
+        other.publish();
+    }
+
+    // a document has an identity - readers hold its published versions, edit listeners & mementos
+    // refer to it, so assigning another text goes through set_memento(Memento{other.snapshot()})
+    Document& operator=(const Document&) = delete;
+
+    // flattens the text - use for_each_chunk() to iterate without a copy
     std::string text() const
     {
-        return text_;
+        return text_.str();
+    }
+
+    std::string text(size_t pos, size_t count) const
+    {
+        return text_.substr(pos, count);
+    }
+
+    template <typename F>
+    void for_each_chunk(F f) const
+    {
+        text_.for_each_chunk(std::move(f));
     }
 
     size_t length() const
@@ -39,50 +339,591 @@ public:
         return text_.size();
     }
 
+    // lines are separated by '\n' - an empty document has one empty line
+    size_t line_count() const
+    {
+        return text_.newlines() + 1;
+    }
+
+    // runs of non-whitespace characters - O(1), chunks are counted when they are created and the
+    // counts are combined up the tree by every edit
+    size_t word_count() const
+    {
+        return text_.words();
+    }
+
+    size_t line_start(size_t line) const
+    {
+        return text_.line_start(line);
+    }
+
+    size_t line_of(size_t pos) const
+    {
+        return text_.line_of(pos);
+    }
+
+    // lines [first_line, first_line + count) with their newlines - the rest of the text is not visited
+    std::string lines(size_t first_line, size_t count) const
+    {
+        const size_t start = line_start(first_line);
+        const size_t end = (count > text_.newlines() - first_line) ? length() : line_start(first_line + count);
+
+        return text_.substr(start, end - start);
+    }
+
+    Snapshot snapshot() const
+    {
+        return Snapshot{text_, version_};
+    }
+
+    // latest version of the text - unlike the rest of Document safe to call from any thread while
+    // the owner edits; readers never block the writer and pinning costs one atomic load
+    Snapshot pin() const
+    {
+        return *published_.load(std::memory_order_acquire);
+    }
+
+    uint64_t version() const
+    {
+        return version_;
+    }
+
+    // returns the id that removes the listener
+    size_t add_edit_listener(EditListener listener)
+    {
+        edit_listeners_.emplace_back(next_listener_id_, std::move(listener));
+        return next_listener_id_++;
+    }
+
+    void remove_edit_listener(size_t id)
+    {
+        std::erase_if(edit_listeners_, [id](const auto& entry) { return entry.first == id; });
+    }
+
     void add_text(const std::string& txt)
     {
-        text_ += txt;
+        apply(length(), 0, Rope{txt});
+    }
+
+    void insert(size_t pos, const std::string& text)
+    {
+        apply(pos, 0, Rope{text});
+    }
+
+    // text shared with another rope (e.g. the clipboard) is inserted by reference in O(log n)
+    void add_text(const Rope& text)
+    {
+        apply(length(), 0, text);
+    }
+
+    void insert(size_t pos, const Rope& text)
+    {
+        apply(pos, 0, text);
+    }
+
+    void erase(size_t pos, size_t count)
+    {
+        apply(pos, count, Rope{});
     }
 
     void to_upper()
     {
-        std::transform(text_.begin(), text_.end(), text_.begin(), [](auto c) { return std::toupper(c); });        
+        apply(0, length(), text_.transformed([](std::string_view chunk, char* out) { ascii_to_upper(chunk, out); }));
     }
 
     void to_lower()
     {
-        std::transform(text_.begin(), text_.end(), text_.begin(), [](auto c) { return std::tolower(c); });
+        apply(0, length(), text_.transformed([](std::string_view chunk, char* out) { ascii_to_lower(chunk, out); }));
+    }
+
+    // same results as to_upper() / to_lower() - large texts are converted in parallel on the pool
+    void to_upper(ThreadPool& pool)
+    {
+        transform([](std::string_view chunk, char* out) { ascii_to_upper(chunk, out); }, pool);
+    }
+
+    void to_lower(ThreadPool& pool)
+    {
+        transform([](std::string_view chunk, char* out) { ascii_to_lower(chunk, out); }, pool);
+    }
+
+    // user-supplied byte transform f(std::string_view chunk, char* out) - writes chunk.size() bytes
+    template <typename F>
+    void transform(F f)
+    {
+        apply(0, length(), text_.transformed(std::move(f)));
+    }
+
+    template <typename F>
+    void transform(F f, ThreadPool& pool, size_t chunk_size = default_parallel_chunk_size)
+    {
+        apply(0, length(), parallel_transformed(text_, std::move(f), pool, chunk_size));
     }
 
     void clear()
     {
-        text_.clear();
+        apply(0, length(), Rope{});
+    }
+
+    // replaces the text with a memory mapped file - no text is copied and opening can be undone like any edit
+    void open(const std::filesystem::path& path)
+    {
+        apply(0, length(), map_file(path));
+        saved_ = snapshot();
+    }
+
+    void save(const std::filesystem::path& path) const
+    {
+        write_file(path, text_);
+        saved_ = snapshot();
+    }
+
+    const Snapshot& saved() const
+    {
+        return saved_;
     }
 
-    template <typename TSerializer = cereal::BinaryOutputArchive>
+    // position of the first occurrence of pattern at or after from - std::string::npos if not found
+    size_t find(const std::string& pattern, size_t from = 0) const
+    {
+        const Searcher searcher{pattern};
+
+        const SuffixIndex* index = ready_index();
+        if (!index)
+            return searcher.find(text_, from);
+
+        if (const size_t pos = index->find(pattern, from); pos != std::string::npos)
+            return pos;
+
+        return searcher.find(text_, std::max(from, unindexed_tail_start(pattern.size())));
+    }
+
+    // non-overlapping occurrences from left to right
+    std::vector<size_t> find_all(const std::string& pattern) const
+    {
+        const Searcher searcher{pattern};
+
+        const SuffixIndex* index = ready_index();
+        if (!index)
+            return searcher.find_all(text_);
+
+        std::vector<size_t> occurrences = index->occurrences(pattern);
+        for (size_t pos : tail_occurrences(searcher))
+            occurrences.push_back(pos);
+
+        // the index reports overlapping occurrences
+        size_t next = 0;
+        std::erase_if(occurrences, [&next, m = pattern.size()](size_t pos) {
+            if (pos < next)
+                return true;
+            next = pos + m;
+            return false;
+        });
+
+        return occurrences;
+    }
+
+    // number of (possibly overlapping) occurrences - O(m log n) with an index
+    size_t count(const std::string& pattern) const
+    {
+        const Searcher searcher{pattern};
+
+        if (const SuffixIndex* index = ready_index())
+            return index->count(pattern) + tail_occurrences(searcher).size();
+
+        size_t result = 0;
+        for (size_t pos = searcher.find(text_); pos != std::string::npos; pos = searcher.find(text_, pos + 1))
+            ++result;
+
+        return result;
+    }
+
+    // builds the full-text index now
+    void build_index()
+    {
+        drop_index();
+        index_ = std::make_shared<const SuffixIndex>(text_);
+        indexed_length_ = length();
+    }
+
+    // builds the full-text index on the pool - searches scan the text until it is ready, or for good
+    // if the pool is destroyed before it starts the build
+    void build_index(ThreadPool& pool)
+    {
+        drop_index();
+        pending_index_ = pool.submit([text = text_] { return std::make_shared<const SuffixIndex>(text); }).share();
+        indexed_length_ = length();
+    }
+
+    void drop_index()
+    {
+        index_.reset();
+        pending_index_ = {};
+        indexed_length_ = 0;
+    }
+
+    bool has_index() const
+    {
+        return ready_index() != nullptr;
+    }
+
+    // bytes used by the index - 0 when there is no index ready
+    size_t index_memory() const
+    {
+        const SuffixIndex* index = ready_index();
+
+        return index ? index->memory_usage() : 0;
+    }
+
+    // rebuilds the text in a single pass into a buffer allocated once - returns the number of replacements
+    size_t replace_all(const std::string& pattern, const std::string& replacement)
+    {
+        const std::vector<size_t> occurrences = find_all(pattern);
+        if (occurrences.empty())
+            return 0;
+
+        auto buffer = std::make_shared<std::string>();
+        buffer->reserve(length() - occurrences.size() * pattern.size() + occurrences.size() * replacement.size());
+
+        const auto copy_text = [this, &buffer](size_t pos, size_t count) {
+            text_.for_each_chunk(pos, count, [&buffer](std::string_view chunk) { buffer->append(chunk); });
+        };
+
+        size_t copied = 0;
+        for (size_t pos : occurrences)
+        {
+            copy_text(copied, pos - copied);
+            buffer->append(replacement);
+            copied = pos + pattern.size();
+        }
+        copy_text(copied, length() - copied);
+
+        apply(0, length(), Rope{std::shared_ptr<const std::string>{std::move(buffer)}});
+
+        return occurrences.size();
+    }
+
+    void set_keyframe_interval(size_t interval)
+    {
+        if (interval == 0)
+            throw std::invalid_argument("Keyframe interval must be positive");
+
+        keyframe_interval_ = interval;
+    }
+
+    // A keyframe keeps the text as a rope sharing chunks with the document (O(1), RopeKeyframe) or
+    // serializes it with TSerializer constructed either from the std::string keyframe it fills
+    // (RawOutputArchive) or from a std::ostream (cereal archives)
+    template <typename TSerializer = RopeKeyframe>
     Memento create_memento() const
     {
-        std::stringstream stream;
-        TSerializer oarchive(stream);
-        oarchive(text_);
+        seal_pending_edits();
+
+        Memento memento;
+        memento.history_ = history();
+        memento.revision_ = head_;
+
+        if (mementos_since_keyframe_++ % keyframe_interval_ == 0)
+        {
+            memento.is_keyframe_ = true;
+            head_->keyframe = text_;
+
+            if constexpr (std::is_constructible_v<TSerializer, std::string&>)
+            {
+                TSerializer oarchive(memento.keyframe_);
+                oarchive(text_);
+            }
+            else if constexpr (!std::is_same_v<TSerializer, RopeKeyframe>)
+            {
+                std::stringstream stream;
+                TSerializer oarchive(stream);
+                oarchive(text_.str());
+
+                memento.keyframe_ = stream.str();
+            }
+
+            memento.keyframe_size_ = memento.keyframe_.size();
+        }
+
+        return memento;
+    }
+
+    // memento that never holds a keyframe - restored only by undoing & redoing edits of this document
+    Memento create_delta_memento() const
+    {
+        seal_pending_edits();
 
         Memento memento;
-        memento.snapshot_ = stream.str();
+        memento.history_ = history();
+        memento.revision_ = head_;
 
         return memento;
     }
 
-    template <typename TDeserializer = cereal::BinaryInputArchive>
+    // mementos from the history of this document are restored by undoing & redoing edits (from the
+    // nearest keyframe when that is shorter or the history is truncated), mementos from other
+    // documents only when they hold a keyframe or a snapshot
+    template <typename TDeserializer = RawInputArchive>
     void set_memento(Memento& memento)
     {
-        std::stringstream stream{memento.snapshot_};
-        TDeserializer iarchive(stream);
-        iarchive(text_);
+        if (memento.snapshot_)
+        {
+            apply(0, length(), memento.snapshot_->text_);
+            return;
+        }
+
+        if (memento.history_ && memento.history_ == history_.lock())
+        {
+            travel_to(memento.revision_);
+            return;
+        }
+
+        if (!memento.is_keyframe())
+            throw std::invalid_argument("Memento does not belong to the history of this document");
+
+        if (memento.keyframe_.empty())
+        {
+            adopt_history(memento, *memento.revision_->keyframe);
+            return;
+        }
+
+        const bool compressed = memento.keyframe_.size() != memento.keyframe_size_;
+        const std::string decompressed = compressed ? lz_decompress(memento.keyframe_) : std::string{};
+        const std::string& keyframe = compressed ? decompressed : memento.keyframe_;
+
+        std::string text;
+        if constexpr (std::is_constructible_v<TDeserializer, std::string_view>)
+        {
+            TDeserializer iarchive(keyframe);
+            iarchive(text);
+        }
+        else
+        {
+            std::stringstream stream{keyframe};
+            TDeserializer iarchive(stream);
+            iarchive(text);
+        }
+
+        adopt_history(memento, Rope{std::move(text)});
+    }
+
+    // forgets the history before a memento of this document - older revisions are freed once no
+    // memento refers to them, restoring a delta memento older than the cut throws std::invalid_argument
+    void truncate_history(const Memento& oldest)
+    {
+        if (!oldest.history_ || oldest.history_ != history_.lock() || !oldest.revision_)
+            throw std::invalid_argument("Memento does not belong to the history of this document");
+
+        oldest.revision_->parent.reset();
+    }
+
+    // forgets the history before the current state without creating a memento of it
+    void truncate_history()
+    {
+        head_->parent.reset();
     }
 
     void replace(size_t start_pos, size_t count, const std::string& text)
     {
-        text_.replace(start_pos, count, text);
+        apply(start_pos, count, Rope{text});
+    }
+
+private:
+    // the token of the current history - a new one once no memento holds the previous one
+    std::shared_ptr<const History> history() const
+    {
+        std::shared_ptr<const History> history = history_.lock();
+        if (!history)
+            history_ = history = std::make_shared<History>();
+
+        return history;
+    }
+
+    void apply(size_t pos, size_t count, Rope inserted)
+    {
+        if (pos > length())
+            throw std::out_of_range("Position out of range");
+
+        count = std::min(count, length() - pos);
+        Rope removed = text_.slice(pos, count);
+
+        change_text(pos, count, inserted);
+        publish();
+
+        if ((index_ || pending_index_.valid()) && (pos < indexed_length_ || length() - indexed_length_ > max_unindexed_tail))
+            drop_index();
+
+        if (!history_.expired())
+        {
+            pending_edits_.push_back(Edit{pos, std::move(removed), std::move(inserted)});
+        }
+        else if (head_->depth > 0 || !pending_edits_.empty())
+        {
+            // no memento is alive - nothing can be undone, so the history is dropped
+            head_ = std::make_shared<Revision>();
+            pending_edits_.clear();
+        }
+    }
+
+    const SuffixIndex* ready_index() const
+    {
+        if (pending_index_.valid() && pending_index_.wait_for(std::chrono::seconds{0}) == std::future_status::ready)
+        {
+            try
+            {
+                index_ = pending_index_.get();
+            }
+            catch (const std::future_error&)
+            {
+                // the pool was destroyed before the build started - searches scan the text
+            }
+            pending_index_ = {};
+        }
+
+        return index_.get();
+    }
+
+    // occurrences ending in the unindexed tail start at most m - 1 bytes before it
+    size_t unindexed_tail_start(size_t pattern_size) const
+    {
+        return indexed_length_ - std::min(indexed_length_, pattern_size - 1);
+    }
+
+    // all (possibly overlapping) occurrences that are not covered by the index
+    std::vector<size_t> tail_occurrences(const Searcher& searcher) const
+    {
+        std::vector<size_t> occurrences;
+
+        for (size_t pos = searcher.find(text_, unindexed_tail_start(searcher.pattern().size())); pos != std::string::npos;
+             pos = searcher.find(text_, pos + 1))
+            occurrences.push_back(pos);
+
+        return occurrences;
+    }
+
+    void seal_pending_edits() const
+    {
+        if (pending_edits_.empty())
+            return;
+
+        head_ = std::make_shared<Revision>(Revision{head_, std::move(pending_edits_), head_->depth + 1, {}, {}, {}});
+        pending_edits_.clear();
+    }
+
+    void undo(const std::vector<Edit>& edits)
+    {
+        for (auto it = edits.rbegin(); it != edits.rend(); ++it)
+            change_text(it->pos, it->inserted.size(), it->removed);
+    }
+
+    void redo(const std::vector<Edit>& edits)
+    {
+        for (const Edit& edit : edits)
+            change_text(edit.pos, edit.removed.size(), edit.inserted);
+    }
+
+    // revisions to undo from `from` up to the common ancestor & to redo from there down to `to`
+    // (bottom-up) - false if the history between them is truncated
+    static bool find_path(const Revision* from, const Revision* to, std::vector<const Revision*>& undo_path,
+        std::vector<const Revision*>& redo_path)
+    {
+        while (from->depth > to->depth)
+        {
+            undo_path.push_back(from);
+            if (!(from = from->parent.get()))
+                return false;
+        }
+
+        while (to->depth > from->depth)
+        {
+            redo_path.push_back(to);
+            if (!(to = to->parent.get()))
+                return false;
+        }
+
+        while (from != to)
+        {
+            undo_path.push_back(from);
+            redo_path.push_back(to);
+            if (!(from = from->parent.get()) || !(to = to->parent.get()))
+                return false;
+        }
+
+        return true;
+    }
+
+    // walks the revision tree: undo up to the common ancestor, then redo down to the target - or, when
+    // that path is longer than keyframe_interval revisions or truncated, restores the nearest keyframe
+    // above the target & redoes from there. The path is found before the text is touched, so a
+    // truncated history without a keyframe leaves it unchanged
+    void travel_to(const std::shared_ptr<const Revision>& target)
+    {
+        std::vector<const Revision*> undo_path, redo_path;
+        const bool connected = find_path(head_.get(), target.get(), undo_path, redo_path);
+        const size_t path_length = connected ? undo_path.size() + redo_path.size() : SIZE_MAX;
+
+        std::vector<const Revision*> keyframe_path; // bottom-up, the revision of the keyframe last
+        for (const Revision* revision = target.get();
+             revision && path_length > keyframe_interval_ && keyframe_path.size() < path_length;
+             revision = revision->parent.get())
+        {
+            keyframe_path.push_back(revision);
+            if (revision->keyframe)
+                break;
+        }
+
+        if (!keyframe_path.empty() && keyframe_path.back()->keyframe && keyframe_path.size() < path_length)
+        {
+            pending_edits_.clear();
+            change_text(0, length(), *keyframe_path.back()->keyframe);
+
+            for (auto it = keyframe_path.rbegin() + 1; it != keyframe_path.rend(); ++it)
+                redo((*it)->uncompressed_edits());
+        }
+        else if (connected)
+        {
+            undo(pending_edits_);
+            pending_edits_.clear();
+
+            for (const Revision* revision : undo_path)
+                undo(revision->uncompressed_edits());
+
+            for (auto it = redo_path.rbegin(); it != redo_path.rend(); ++it)
+                redo((*it)->uncompressed_edits());
+        }
+        else
+        {
+            throw std::invalid_argument("Memento is older than the truncated history");
+        }
+
+        head_ = target;
+        drop_index();
+        publish();
+    }
+
+    // the text of a keyframe from another document - its history becomes the history of this one
+    void adopt_history(const Memento& memento, const Rope& text)
+    {
+        change_text(0, length(), text);
+        drop_index();
+        publish();
+
+        history_ = memento.history_;
+        head_ = memento.revision_;
+        pending_edits_.clear();
+    }
+
+    void change_text(size_t pos, size_t count, const Rope& inserted)
+    {
+        text_.replace(pos, count, inserted);
+
+        for (const auto& [id, listener] : edit_listeners_)
+            listener(version_ + 1, pos, count, inserted);
+    }
+
+    void publish()
+    {
+        published_.store(std::make_shared<const Snapshot>(Snapshot{text_, ++version_}), std::memory_order_release);
     }
 };
 
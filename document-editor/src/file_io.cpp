@@ -0,0 +1,336 @@
+#include "file_io.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <system_error>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    [[noreturn]] void throw_system_error(const std::string& what, const std::filesystem::path& path)
+    {
+#if defined(_WIN32)
+        const int error = static_cast<int>(::GetLastError());
+#else
+        const int error = errno;
+#endif
+        throw std::system_error(error, std::system_category(), what + " " + path.string());
+    }
+
+    // name of a temporary file next to path - unique in the process, the pid separates processes
+    std::filesystem::path temp_path_for(const std::filesystem::path& path)
+    {
+        static std::atomic<uint64_t> next_id = 0;
+
+#if defined(_WIN32)
+        const auto pid = static_cast<uint64_t>(::GetCurrentProcessId());
+#else
+        const auto pid = static_cast<uint64_t>(::getpid());
+#endif
+        std::filesystem::path temp_path = path;
+        temp_path += "." + std::to_string(pid) + "-" + std::to_string(next_id++) + ".saving";
+
+        return temp_path;
+    }
+
+    struct alignas(4096) WriteBlock
+    {
+        char bytes[write_block_size];
+    };
+} // namespace
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    file_ = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+        throw_system_error("Cannot open", path);
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file_, &size))
+    {
+        ::CloseHandle(file_);
+        throw_system_error("Cannot read the size of", path);
+    }
+
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_ == 0)
+        return; // empty files cannot be mapped
+
+    mapping_ = ::CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    data_ = mapping_ ? static_cast<const char*>(::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    if (!data_)
+    {
+        if (mapping_)
+            ::CloseHandle(mapping_);
+        ::CloseHandle(file_);
+        throw_system_error("Cannot map", path);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+        ::UnmapViewOfFile(data_);
+    if (mapping_)
+        ::CloseHandle(mapping_);
+    ::CloseHandle(file_);
+}
+
+AppendFile::AppendFile(const std::filesystem::path& path, bool create_new)
+    : path_{path}
+{
+    file_ = ::CreateFileW(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+        create_new ? CREATE_NEW : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+        throw_system_error("Cannot open", path);
+}
+
+AppendFile::~AppendFile()
+{
+    ::CloseHandle(file_);
+}
+
+void AppendFile::write(std::string_view data)
+{
+    while (!data.empty())
+    {
+        const DWORD count = static_cast<DWORD>(std::min<size_t>(data.size(), 1 << 30));
+        DWORD written = 0;
+        if (!::WriteFile(file_, data.data(), count, &written, nullptr))
+            throw_system_error("Cannot write", path_);
+
+        data.remove_prefix(written);
+    }
+}
+
+void AppendFile::sync()
+{
+    if (!::FlushFileBuffers(file_))
+        throw_system_error("Cannot sync", path_);
+}
+
+LockFile::LockFile(const std::filesystem::path& path)
+{
+    file_ = ::CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        if (::GetLastError() == ERROR_SHARING_VIOLATION)
+            throw std::system_error(std::make_error_code(std::errc::resource_unavailable_try_again), "Locked by another process: " + path.string());
+        throw_system_error("Cannot open", path);
+    }
+}
+
+LockFile::~LockFile()
+{
+    ::CloseHandle(file_);
+}
+
+void sync_directory(const std::filesystem::path&)
+{
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        throw_system_error("Cannot open", path);
+
+    struct stat status;
+    if (::fstat(fd, &status) == -1)
+    {
+        ::close(fd);
+        throw_system_error("Cannot read the size of", path);
+    }
+
+    size_ = static_cast<size_t>(status.st_size);
+    if (size_ == 0)
+    {
+        ::close(fd); // empty files cannot be mapped
+        return;
+    }
+
+    void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file open
+
+    if (data == MAP_FAILED)
+        throw_system_error("Cannot map", path);
+
+    ::madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(data);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+        ::munmap(const_cast<char*>(data_), size_);
+}
+
+AppendFile::AppendFile(const std::filesystem::path& path, bool create_new)
+    : path_{path}
+{
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (create_new ? O_EXCL : 0), 0644);
+    if (fd_ == -1)
+        throw_system_error("Cannot open", path);
+}
+
+AppendFile::~AppendFile()
+{
+    ::close(fd_);
+}
+
+void AppendFile::write(std::string_view data)
+{
+    while (!data.empty())
+    {
+        const ssize_t written = ::write(fd_, data.data(), data.size());
+        if (written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            throw_system_error("Cannot write", path_);
+        }
+
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+}
+
+void AppendFile::sync()
+{
+    if (::fdatasync(fd_) == -1)
+        throw_system_error("Cannot sync", path_);
+}
+
+LockFile::LockFile(const std::filesystem::path& path)
+{
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ == -1)
+        throw_system_error("Cannot open", path);
+
+    if (::flock(fd_, LOCK_EX | LOCK_NB) == -1)
+    {
+        const int error = errno;
+        ::close(fd_);
+        if (error == EWOULDBLOCK)
+            throw std::system_error(std::make_error_code(std::errc::resource_unavailable_try_again), "Locked by another process: " + path.string());
+        throw std::system_error(error, std::system_category(), "Cannot lock " + path.string());
+    }
+}
+
+LockFile::~LockFile()
+{
+    ::close(fd_); // releases the lock
+}
+
+void sync_directory(const std::filesystem::path& directory)
+{
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1)
+        throw_system_error("Cannot open", directory);
+
+    const int result = ::fsync(fd);
+    ::close(fd);
+
+    if (result == -1)
+        throw_system_error("Cannot sync", directory);
+}
+
+#endif
+
+Rope map_file(const std::filesystem::path& path)
+{
+    auto file = std::make_shared<const MappedFile>(path);
+    const size_t size = file->size();
+
+    return Rope{std::shared_ptr<const char>{file, file->data()}, size};
+}
+
+void write_file(const std::filesystem::path& path, const Rope& text, bool sync)
+{
+    // a rename over a symbolic link would replace the link
+    std::error_code unresolved;
+    std::filesystem::path target = std::filesystem::weakly_canonical(path, unresolved);
+    if (unresolved)
+        target = path;
+
+    // a file left by a process that had the same pid is skipped
+    std::optional<AppendFile> out; // unbuffered - blocks go straight to the OS
+    std::filesystem::path temp_path;
+    while (!out)
+    {
+        temp_path = temp_path_for(target);
+        try
+        {
+            out.emplace(temp_path, true);
+        }
+        catch (const std::system_error& e)
+        {
+            if (e.code() != std::errc::file_exists)
+                throw;
+        }
+    }
+
+    try
+    {
+        auto block = std::make_unique<WriteBlock>();
+        size_t filled = 0;
+
+        text.for_each_chunk([&](std::string_view chunk) {
+            while (!chunk.empty())
+            {
+                const size_t count = std::min(chunk.size(), write_block_size - filled);
+                std::memcpy(block->bytes + filled, chunk.data(), count);
+                filled += count;
+                chunk.remove_prefix(count);
+
+                if (filled == write_block_size)
+                {
+                    out->write({block->bytes, filled});
+                    filled = 0;
+                }
+            }
+        });
+
+        out->write({block->bytes, filled});
+
+        if (sync)
+            out->sync();
+        out.reset();
+
+        std::error_code missing;
+        const std::filesystem::file_status original = std::filesystem::status(target, missing);
+        if (!missing)
+            std::filesystem::permissions(temp_path, original.permissions());
+    }
+    catch (...)
+    {
+        out.reset();
+        std::error_code ignored;
+        std::filesystem::remove(temp_path, ignored);
+        throw;
+    }
+
+    std::filesystem::rename(temp_path, target);
+
+    if (sync)
+        sync_directory(target.has_parent_path() ? target.parent_path() : std::filesystem::path{"."});
+}
\ No newline at end of file
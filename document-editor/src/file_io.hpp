@@ -0,0 +1,105 @@
+#ifndef FILE_IO_HPP
+#define FILE_IO_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+#include "rope.hpp"
+
+// read-only memory mapping of a whole file - pages are loaded by the OS when the text is read.
+// A private mapping does not copy the file: if another process truncates it while it is mapped,
+// reading the lost pages raises SIGBUS (POSIX). write_file() replaces a file by a rename, so saving
+// over a mapped file is safe.
+class MappedFile
+{
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#if defined(_WIN32)
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+
+public:
+    explicit MappedFile(const std::filesystem::path& path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    const char* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+};
+
+// rope whose leaves point into the mapping of the file - no text is copied, edits add leaves
+// on top of the mapped ones (like a piece table) and the mapping lives as long as any leaf
+Rope map_file(const std::filesystem::path& path);
+
+// file opened for appending with unbuffered writes - sync() makes the written data durable
+class AppendFile
+{
+#if defined(_WIN32)
+    void* file_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    std::filesystem::path path_;
+
+public:
+    // creates the file if needed, create_new - throws std::system_error (file_exists) if it exists
+    explicit AppendFile(const std::filesystem::path& path, bool create_new = false);
+
+    AppendFile(const AppendFile&) = delete;
+    AppendFile& operator=(const AppendFile&) = delete;
+
+    ~AppendFile();
+
+    void write(std::string_view data);
+
+    // returns once the data written so far is on the disk (fdatasync / FlushFileBuffers)
+    void sync();
+};
+
+// exclusive lock on a file held while the object lives (flock / a handle without sharing) - the file
+// is created if needed and kept, deleting it would let two processes lock different files
+class LockFile
+{
+#if defined(_WIN32)
+    void* file_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+
+public:
+    // throws std::system_error (resource_unavailable_try_again) if another owner holds the lock
+    explicit LockFile(const std::filesystem::path& path);
+
+    LockFile(const LockFile&) = delete;
+    LockFile& operator=(const LockFile&) = delete;
+
+    ~LockFile();
+};
+
+// makes a rename or a creation of a file in the directory durable - no-op on Windows
+void sync_directory(const std::filesystem::path& directory);
+
+constexpr size_t write_block_size = 1024 * 1024;
+
+// streams the chunks of the text through an aligned block buffer - every write() except the last one
+// is write_block_size bytes. The file is replaced atomically, so a file mapped by map_file() can be
+// saved over while its rope is still alive; the replaced file keeps the permissions of the old one.
+// The text is written to a temporary file with a unique name next to the target, so concurrent saves
+// do not mix; a symbolic link is kept and the file it points to is replaced.
+// With sync the new content and the rename are durable when the function returns.
+void write_file(const std::filesystem::path& path, const Rope& text, bool sync = false);
+
+#endif // FILE_IO_HPP
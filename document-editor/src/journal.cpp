@@ -0,0 +1,348 @@
+#include "journal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+#include "file_io.hpp"
+
+namespace
+{
+    constexpr size_t header_size = sizeof(uint64_t);
+    constexpr size_t fields_size = 3 * sizeof(uint64_t);
+    constexpr size_t trailer_size = sizeof(uint32_t);
+    constexpr size_t write_buffer_size = 64 * 1024; // a large insert is written in blocks, never flattened
+
+    constexpr std::array<uint32_t, 256> make_crc_table()
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            table[i] = crc;
+        }
+
+        return table;
+    }
+
+    constexpr auto crc_table = make_crc_table();
+
+    // previous - crc32() of the data before, so crc32(b, crc32(a)) == crc32(a + b)
+    uint32_t crc32(std::string_view data, uint32_t previous = 0)
+    {
+        uint32_t crc = ~previous;
+        for (char c : data)
+            crc = crc_table[(crc ^ static_cast<uint8_t>(c)) & 0xFF] ^ (crc >> 8);
+
+        return ~crc;
+    }
+
+    template <typename T>
+    void put(std::string& out, T value)
+    {
+        for (size_t i = 0; i < sizeof(T); ++i, value >>= 8)
+            out.push_back(static_cast<char>(value & 0xFF));
+    }
+
+    template <typename T>
+    T get(const char* in)
+    {
+        T value = 0;
+        for (size_t i = sizeof(T); i-- > 0;)
+            value = (value << 8) | static_cast<uint8_t>(in[i]);
+
+        return value;
+    }
+
+    // records of one segment - false if it ends with a torn or corrupted record
+    bool read_segment(const std::filesystem::path& path, uint64_t after_version, std::vector<JournalRecord>& records)
+    {
+        std::ifstream in{path, std::ios::binary};
+        const std::string data{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+
+        size_t pos = 0;
+        while (pos < data.size())
+        {
+            if (data.size() - pos < header_size + trailer_size)
+                return false;
+
+            const uint64_t payload_size = get<uint64_t>(data.data() + pos);
+            if (payload_size < fields_size || data.size() - pos - header_size - trailer_size < payload_size)
+                return false;
+
+            const std::string_view payload{data.data() + pos + header_size, static_cast<size_t>(payload_size)};
+            if (get<uint32_t>(payload.data() + payload_size) != crc32(payload))
+                return false;
+
+            const uint64_t version = get<uint64_t>(payload.data());
+            if (version > after_version)
+            {
+                records.push_back({version, get<uint64_t>(payload.data() + 8), get<uint64_t>(payload.data() + 16),
+                    std::string{payload.substr(fields_size)}});
+            }
+
+            pos += header_size + payload_size + trailer_size;
+        }
+
+        return true;
+    }
+
+    // n of a segment file name <base file name>.<n>
+    std::optional<uint64_t> segment_number(const std::filesystem::path& file, const std::filesystem::path& base)
+    {
+        const std::string name = file.filename().string();
+        const std::string prefix = base.filename().string() + ".";
+
+        if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0)
+            return std::nullopt;
+
+        const std::string_view digits = std::string_view{name}.substr(prefix.size());
+        if (!std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; }) || digits.size() > 18)
+            return std::nullopt;
+
+        return std::stoull(std::string{digits});
+    }
+} // namespace
+
+Journal::Journal(std::filesystem::path base, std::chrono::milliseconds commit_interval)
+    : base_{std::move(base)}
+    , commit_interval_{commit_interval}
+{
+    const auto existing = segments(base_);
+    segment_ = existing.empty() ? 0 : *segment_number(existing.back(), base_) + 1;
+
+    flusher_ = std::jthread{[this](std::stop_token stop) { flush_loop(stop); }};
+}
+
+Journal::~Journal()
+{
+    flusher_.request_stop();
+    flusher_.join(); // the flusher writes the pending records before it stops
+}
+
+void Journal::append(uint64_t version, size_t pos, size_t count, const Rope& inserted)
+{
+    std::lock_guard lock{mutex_};
+
+    if (pending_.empty() || pending_.back().segment != segment_)
+        pending_.push_back({segment_, {}});
+    pending_.back().records.push_back({version, pos, count, inserted});
+
+    segment_versions_[segment_] = version;
+    ++appended_;
+}
+
+void Journal::sync()
+{
+    std::unique_lock lock{mutex_};
+
+    const uint64_t target = appended_;
+    sync_requested_ = true;
+    work_.notify_one();
+
+    committed_.wait(lock, [&] { return durable_ >= target || error_; });
+
+    if (error_)
+        std::rethrow_exception(std::exchange(error_, nullptr));
+}
+
+void Journal::rotate()
+{
+    std::lock_guard lock{mutex_};
+    ++segment_;
+}
+
+void Journal::remove_segments_up_to(uint64_t version)
+{
+    sync(); // segments before the current one are complete
+
+    std::lock_guard lock{mutex_};
+
+    for (auto it = segment_versions_.begin(); it != segment_versions_.end() && it->first < segment_;)
+    {
+        if (it->second > version)
+        {
+            ++it;
+            continue;
+        }
+
+        std::error_code ignored;
+        std::filesystem::remove(segment_path(it->first), ignored);
+        it = segment_versions_.erase(it);
+    }
+}
+
+uint64_t Journal::commits() const
+{
+    std::lock_guard lock{mutex_};
+    return commits_;
+}
+
+uint64_t Journal::records() const
+{
+    std::lock_guard lock{mutex_};
+    return appended_;
+}
+
+std::vector<JournalRecord> Journal::read(const std::filesystem::path& base, uint64_t after_version)
+{
+    std::vector<JournalRecord> records;
+
+    for (const auto& path : segments(base))
+    {
+        if (!read_segment(path, after_version, records))
+            break; // a torn record is the last one written before a crash
+    }
+
+    return records;
+}
+
+std::vector<std::filesystem::path> Journal::segments(const std::filesystem::path& base)
+{
+    const std::filesystem::path directory = base.has_parent_path() ? base.parent_path() : std::filesystem::path{"."};
+
+    std::vector<std::pair<uint64_t, std::filesystem::path>> found;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator{directory, error})
+    {
+        if (auto number = segment_number(entry.path(), base))
+            found.emplace_back(*number, entry.path());
+    }
+
+    std::sort(found.begin(), found.end());
+
+    std::vector<std::filesystem::path> paths;
+    for (auto& [number, path] : found)
+        paths.push_back(std::move(path));
+
+    return paths;
+}
+
+std::filesystem::path Journal::segment_path(uint64_t segment) const
+{
+    std::filesystem::path path = base_;
+    path += "." + std::to_string(segment);
+
+    return path;
+}
+
+void Journal::write_batch(const Batch& batch) const
+{
+    AppendFile file{segment_path(batch.segment)};
+    std::string buffer;
+    buffer.reserve(write_buffer_size + Rope::max_chunk_size);
+
+    const auto write_buffer = [&] {
+        file.write(buffer);
+        buffer.clear();
+    };
+
+    for (const PendingRecord& record : batch.records)
+    {
+        put(buffer, static_cast<uint64_t>(fields_size + record.inserted.size()));
+        const size_t fields_start = buffer.size();
+        put(buffer, record.version);
+        put(buffer, record.pos);
+        put(buffer, record.count);
+        uint32_t crc = crc32(std::string_view{buffer}.substr(fields_start));
+
+        record.inserted.for_each_chunk([&](std::string_view chunk) {
+            crc = crc32(chunk, crc);
+            buffer.append(chunk);
+            if (buffer.size() >= write_buffer_size)
+                write_buffer();
+        });
+
+        put(buffer, crc);
+    }
+
+    write_buffer();
+    file.sync();
+}
+
+void Journal::flush_loop(std::stop_token stop)
+{
+    uint64_t synced_directory_segment = UINT64_MAX;
+
+    std::unique_lock lock{mutex_};
+
+    while (true)
+    {
+        work_.wait_for(lock, stop, commit_interval_, [this] { return sync_requested_; });
+        sync_requested_ = false;
+
+        if (pending_.empty())
+        {
+            durable_ = appended_;
+            committed_.notify_all();
+
+            if (stop.stop_requested())
+                break;
+
+            continue;
+        }
+
+        std::vector<Batch> batches = std::move(pending_);
+        pending_.clear();
+
+        lock.unlock();
+
+        size_t written = 0;
+        uint64_t written_records = 0;
+        std::exception_ptr error;
+        for (; written < batches.size(); ++written)
+        {
+            const std::filesystem::path path = segment_path(batches[written].segment);
+            std::error_code missing;
+            const uintmax_t size_before = std::filesystem::file_size(path, missing);
+
+            try
+            {
+                write_batch(batches[written]);
+
+                // a new segment file must also be found after a crash
+                if (batches[written].segment != synced_directory_segment)
+                {
+                    sync_directory(base_.has_parent_path() ? base_.parent_path() : std::filesystem::path{"."});
+                    synced_directory_segment = batches[written].segment;
+                }
+            }
+            catch (...)
+            {
+                // a torn record would end the journal before the retried ones
+                std::error_code ignored;
+                if (missing)
+                    std::filesystem::remove(path, ignored);
+                else
+                    std::filesystem::resize_file(path, size_before, ignored);
+
+                error = std::current_exception();
+                break;
+            }
+
+            written_records += batches[written].records.size();
+        }
+
+        lock.lock();
+
+        durable_ += written_records;
+        ++commits_;
+        if (error)
+        {
+            error_ = error;
+
+            // retried at the next interval, before the records appended meanwhile
+            pending_.insert(pending_.begin(), std::make_move_iterator(batches.begin() + static_cast<std::ptrdiff_t>(written)),
+                std::make_move_iterator(batches.end()));
+        }
+        committed_.notify_all();
+
+        if (error && stop.stop_requested())
+            break;
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rope.hpp"
+
+// edit of a document read back from a journal
+struct JournalRecord
+{
+    uint64_t version; // version of the document that includes the edit
+    uint64_t pos;
+    uint64_t count;
+    std::string inserted;
+};
+
+// Write-ahead log of document edits in segment files <base>.<n>. append() only queues the edit -
+// its inserted text shares chunks with the document, so no text is copied on the editing thread. A
+// background thread encodes the records appended meanwhile, writes them and syncs them with one
+// fsync per segment (group commit), so an edit is durable at most commit_interval after it is made.
+// Records that failed to be written are retried at the next interval.
+//
+// Record: payload size (u64), version, pos, count (u64), inserted text, CRC-32 of the payload (u32),
+// little-endian. A record torn by a crash fails the CRC check and ends the journal.
+class Journal
+{
+    std::filesystem::path base_;
+    std::chrono::milliseconds commit_interval_;
+
+    struct PendingRecord
+    {
+        uint64_t version;
+        uint64_t pos;
+        uint64_t count;
+        Rope inserted;
+    };
+
+    struct Batch
+    {
+        uint64_t segment;
+        std::vector<PendingRecord> records;
+    };
+
+    mutable std::mutex mutex_;
+    std::condition_variable_any committed_;
+    std::condition_variable_any work_;
+    std::vector<Batch> pending_;
+    uint64_t segment_;
+    std::map<uint64_t, uint64_t> segment_versions_; // segment -> highest version appended to it
+    uint64_t appended_ = 0;                         // records appended
+    uint64_t durable_ = 0;                          // records written & synced
+    uint64_t commits_ = 0;
+    bool sync_requested_ = false;
+    std::exception_ptr error_;
+
+    std::jthread flusher_;
+
+public:
+    static constexpr auto default_commit_interval = std::chrono::milliseconds{5};
+
+    // appends continue after the existing segments of base
+    explicit Journal(std::filesystem::path base, std::chrono::milliseconds commit_interval = default_commit_interval);
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // syncs the appended records - a write error at this point loses them
+    ~Journal();
+
+    void append(uint64_t version, size_t pos, size_t count, const Rope& inserted);
+
+    // waits until all records appended so far are durable - rethrows a write error of the flusher,
+    // the records are retried later
+    void sync();
+
+    // later records go to a new segment
+    void rotate();
+
+    // deletes the segments before the current one holding only records up to version
+    void remove_segments_up_to(uint64_t version);
+
+    // groups written so far - each one costs a single fsync per segment
+    uint64_t commits() const;
+
+    uint64_t records() const;
+
+    // records of all segments of base newer than version in order - reading stops at the first torn record
+    static std::vector<JournalRecord> read(const std::filesystem::path& base, uint64_t after_version = 0);
+
+    // existing segment files of base in order
+    static std::vector<std::filesystem::path> segments(const std::filesystem::path& base);
+
+private:
+    std::filesystem::path segment_path(uint64_t segment) const;
+
+    // appends the encoded records to their segment & syncs it
+    void write_batch(const Batch& batch) const;
+
+    void flush_loop(std::stop_token stop);
+};
+
+#endif // JOURNAL_HPP
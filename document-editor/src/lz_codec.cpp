@@ -0,0 +1,204 @@
+#include "lz_codec.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    constexpr size_t min_match = 4;
+    constexpr size_t max_offset = 65535;
+    constexpr int hash_bits = 14;
+
+    uint32_t load32(const char* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t hash(uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - hash_bits);
+    }
+
+    void write_length(std::string& out, size_t length)
+    {
+        for (; length >= 255; length -= 255)
+            out.push_back(static_cast<char>(255));
+        out.push_back(static_cast<char>(length));
+    }
+
+    void write_sequence(std::string& out, std::string_view literals, size_t offset, size_t match_length)
+    {
+        const size_t extra_match = (match_length != 0) ? match_length - min_match : 0;
+        const auto token = static_cast<uint8_t>((std::min<size_t>(literals.size(), 15) << 4) | std::min<size_t>(extra_match, 15));
+
+        out.push_back(static_cast<char>(token));
+        if (literals.size() >= 15)
+            write_length(out, literals.size() - 15);
+        out.append(literals);
+
+        if (match_length == 0)
+            return;
+
+        out.push_back(static_cast<char>(offset & 0xFF));
+        out.push_back(static_cast<char>(offset >> 8));
+        if (extra_match >= 15)
+            write_length(out, extra_match - 15);
+    }
+
+    class Reader
+    {
+        std::string_view input_;
+        size_t pos_ = 0;
+
+    public:
+        explicit Reader(std::string_view input)
+            : input_{input}
+        {
+        }
+
+        bool at_end() const
+        {
+            return pos_ == input_.size();
+        }
+
+        uint8_t byte()
+        {
+            if (at_end())
+                throw std::runtime_error("lz_decompress - truncated input");
+
+            return static_cast<uint8_t>(input_[pos_++]);
+        }
+
+        std::string_view bytes(size_t count)
+        {
+            if (count > input_.size() - pos_)
+                throw std::runtime_error("lz_decompress - truncated input");
+
+            pos_ += count;
+            return input_.substr(pos_ - count, count);
+        }
+
+        size_t length(size_t nibble)
+        {
+            size_t length = nibble;
+            if (nibble == 15)
+            {
+                uint8_t more;
+                do
+                {
+                    more = byte();
+                    length += more;
+                } while (more == 255);
+            }
+
+            return length;
+        }
+    };
+} // namespace
+
+std::string lz_compress(std::string_view input)
+{
+    std::string out;
+    out.reserve(input.size() / 2 + 16);
+
+    for (size_t size = input.size(); ; size >>= 7)
+    {
+        if (size < 0x80)
+        {
+            out.push_back(static_cast<char>(size));
+            break;
+        }
+        out.push_back(static_cast<char>((size & 0x7F) | 0x80));
+    }
+
+    const char* data = input.data();
+    const size_t n = input.size();
+
+    std::vector<uint32_t> table(size_t{1} << hash_bits, UINT32_MAX);
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    while (pos + min_match <= n)
+    {
+        const uint32_t sequence = load32(data + pos);
+        uint32_t& entry = table[hash(sequence)];
+        const size_t candidate = entry;
+        entry = static_cast<uint32_t>(pos);
+
+        if (candidate == UINT32_MAX || pos - candidate > max_offset || load32(data + candidate) != sequence)
+        {
+            ++pos;
+            continue;
+        }
+
+        size_t length = min_match;
+        while (pos + length < n && data[candidate + length] == data[pos + length])
+            ++length;
+
+        write_sequence(out, input.substr(anchor, pos - anchor), pos - candidate, length);
+
+        pos += length;
+        anchor = pos;
+    }
+
+    write_sequence(out, input.substr(anchor), 0, 0);
+
+    return out;
+}
+
+std::string lz_decompress(std::string_view compressed)
+{
+    Reader in{compressed};
+
+    size_t size = 0;
+    for (int shift = 0; ; shift += 7)
+    {
+        if (shift > 63)
+            throw std::runtime_error("lz_decompress - invalid size");
+
+        const uint8_t byte = in.byte();
+        size |= static_cast<size_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+
+    std::string out;
+    out.reserve(std::min(size, compressed.size() * 255)); // a corrupted size must not allocate much more
+
+    while (true)
+    {
+        const uint8_t token = in.byte();
+
+        out.append(in.bytes(in.length(token >> 4)));
+        if (out.size() > size)
+            throw std::runtime_error("lz_decompress - size mismatch");
+
+        if (in.at_end())
+            break;
+
+        const size_t offset_low = in.byte();
+        const size_t offset = offset_low | (static_cast<size_t>(in.byte()) << 8);
+        const size_t length = in.length(token & 0x0F) + min_match;
+
+        if (offset == 0 || offset > out.size() || length > size - out.size())
+            throw std::runtime_error("lz_decompress - invalid match");
+
+        // a match may overlap the bytes it produces - copied in chunks no longer than the offset
+        for (size_t copied = 0; copied < length;)
+        {
+            const size_t chunk = std::min(length - copied, offset);
+            out.append(out, out.size() - offset, chunk);
+            copied += chunk;
+        }
+    }
+
+    if (out.size() != size)
+        throw std::runtime_error("lz_decompress - size mismatch");
+
+    return out;
+}
@@ -0,0 +1,19 @@
+#ifndef LZ_CODEC_HPP
+#define LZ_CODEC_HPP
+
+#include <string>
+#include <string_view>
+
+// Byte-oriented LZ77 codec in the style of LZ4 - greedy matching through a hash table of 4-byte
+// sequences, no entropy coding. Fast enough to run on every history entry; text with repeats
+// shrinks several times.
+//
+// Format: uncompressed size (LEB128), then sequences of
+//   token (literal count << 4 | match length - 4), literals, offset (16-bit LE), match
+// where a nibble of 15 is continued by bytes adding up to 255 each. The last sequence has no match.
+std::string lz_compress(std::string_view input);
+
+// throws std::runtime_error on malformed input
+std::string lz_decompress(std::string_view compressed);
+
+#endif // LZ_CODEC_HPP
@@ -0,0 +1,114 @@
+#include "macro.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // text of more repetitions of an append-only macro is reserved as it grows - the repeat count is user input
+    constexpr size_t max_reserved_pending = 64 * 1024 * 1024;
+} // namespace
+
+Macro::Macro(const std::vector<MacroStep>& steps, const Resolver& resolve, std::string_view append_command_name)
+{
+    for (const MacroStep& step : steps)
+    {
+        std::shared_ptr<Command> command = resolve(step.name);
+        if (!command)
+            continue;
+
+        const auto first_argument = static_cast<uint32_t>(arguments_.size());
+
+        if (step.name == append_command_name && step.arguments.size() == 1)
+        {
+            append_command_ = command;
+
+            if (!instructions_.empty() && instructions_.back().append)
+            {
+                arguments_[instructions_.back().first_argument] += step.arguments.front();
+                continue;
+            }
+
+            instructions_.push_back({std::move(command), first_argument, 1, true});
+            arguments_.push_back(step.arguments.front());
+            continue;
+        }
+
+        instructions_.push_back({std::move(command), first_argument, static_cast<uint32_t>(step.arguments.size()), false});
+        arguments_.insert(arguments_.end(), step.arguments.begin(), step.arguments.end());
+    }
+}
+
+void Macro::play(MacroConsole& console, size_t count) const
+{
+    // leftover arguments of a failed command must not be read later
+    struct ReplayReset
+    {
+        MacroConsole& console;
+
+        ~ReplayReset()
+        {
+            console.replay({});
+        }
+    } reset{console};
+
+    std::string pending;
+    pending.reserve(pending_capacity(count));
+
+    const auto append_pending = [&] {
+        if (pending.empty())
+            return;
+
+        console.replay({&pending, 1});
+        append_command_->execute();
+        pending.clear();
+    };
+
+    const std::span<const std::string> arguments{arguments_};
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (const Instruction& instruction : instructions_)
+        {
+            if (instruction.append)
+            {
+                pending += arguments[instruction.first_argument];
+                continue;
+            }
+
+            append_pending();
+            console.replay(arguments.subspan(instruction.first_argument, instruction.argument_count));
+            instruction.command->execute();
+        }
+    }
+
+    append_pending();
+}
+
+size_t Macro::pending_capacity(size_t count) const
+{
+    size_t leading = 0; // appends before the first other command
+    size_t run = 0;
+    size_t longest = 0;
+    bool only_appends = true;
+
+    for (const Instruction& instruction : instructions_)
+    {
+        if (instruction.append)
+        {
+            run += arguments_[instruction.first_argument].size();
+            continue;
+        }
+
+        if (only_appends)
+            leading = run;
+        only_appends = false;
+        longest = std::max(longest, run);
+        run = 0;
+    }
+
+    if (only_appends)
+        return (run == 0) ? 0 : run * std::min(count, std::max<size_t>(1, max_reserved_pending / run));
+
+    // the trailing appends of one repetition join the leading ones of the next
+    return std::max(longest, (count > 1) ? run + leading : run);
+}
@@ -0,0 +1,136 @@
+#ifndef MACRO_HPP
+#define MACRO_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "command.hpp"
+#include "console.hpp"
+
+// Console decorator used by Application - captures the lines commands read while a macro is
+// recorded and feeds stored arguments to commands while a macro is replayed
+class MacroConsole : public Console
+{
+    Console& console_;
+    bool capturing_ = false;
+    std::vector<std::string> captured_;
+    std::span<const std::string> replayed_;
+
+public:
+    explicit MacroConsole(Console& console)
+        : console_{console}
+    {
+    }
+
+    std::string get_line() override
+    {
+        if (!replayed_.empty())
+        {
+            std::string line = replayed_.front();
+            replayed_ = replayed_.subspan(1);
+            return line;
+        }
+
+        std::string line = console_.get_line();
+        if (capturing_)
+            captured_.push_back(line);
+
+        return line;
+    }
+
+    // names are read between commands - never captured or replayed
+    std::string get_command() override
+    {
+        return console_.get_command();
+    }
+
+    void print(const std::string& line) override
+    {
+        console_.print(line);
+    }
+
+    void flush() override
+    {
+        console_.flush();
+    }
+
+    void start_capture()
+    {
+        capturing_ = true;
+        captured_.clear();
+    }
+
+    // lines read since start_capture()
+    std::vector<std::string> stop_capture()
+    {
+        capturing_ = false;
+        return std::move(captured_);
+    }
+
+    // next reads return lines (they must outlive the reads) - then reads go to the console again
+    void replay(std::span<const std::string> lines)
+    {
+        replayed_ = lines;
+    }
+};
+
+// command executed while recording with the lines it read
+struct MacroStep
+{
+    std::string name;
+    std::vector<std::string> arguments;
+};
+
+// Recorded steps compiled into a flat list of instructions - handlers are resolved once (and kept
+// alive, so replacing a command of the application later does not affect the macro) and all
+// arguments are kept in one buffer. Steps of the append command with a single argument only add
+// text to the document, so adjacent ones are merged into one instruction and on replay their text
+// is collected until another command runs - repeating appends costs a single edit.
+class Macro
+{
+public:
+    struct Instruction
+    {
+        std::shared_ptr<Command> command;
+        uint32_t first_argument;
+        uint32_t argument_count;
+        bool append;
+    };
+
+    using Resolver = std::function<std::shared_ptr<Command>(std::string_view name)>;
+
+private:
+    std::vector<Instruction> instructions_;
+    std::vector<std::string> arguments_;
+    std::shared_ptr<Command> append_command_;
+
+public:
+    Macro() = default;
+
+    // steps the resolver does not know (returns nullptr for) are skipped
+    Macro(const std::vector<MacroStep>& steps, const Resolver& resolve, std::string_view append_command_name);
+
+    // runs the macro count times in a row - lines the commands read come from the recorded arguments
+    void play(MacroConsole& console, size_t count = 1) const;
+
+    const std::vector<Instruction>& instructions() const
+    {
+        return instructions_;
+    }
+
+    bool empty() const
+    {
+        return instructions_.empty();
+    }
+
+private:
+    // bytes appended between two other commands at most - text collected on replay fits in it
+    size_t pending_capacity(size_t count) const;
+};
+
+#endif // MACRO_HPP
@@ -0,0 +1,77 @@
+#ifndef PARALLEL_TRANSFORM_HPP
+#define PARALLEL_TRANSFORM_HPP
+
+#include <exception>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rope.hpp"
+#include "thread_pool.hpp"
+
+constexpr size_t default_parallel_chunk_size = 256 * 1024;
+
+// first position >= pos that does not point into the middle of a UTF-8 sequence
+inline size_t next_utf8_boundary(const Rope& text, size_t pos)
+{
+    while (pos < text.size() && (static_cast<unsigned char>(text.at(pos)) & 0xC0) == 0x80)
+        ++pos;
+
+    return pos;
+}
+
+// Rope::transformed() on a thread pool: the text is split into cache-sized ranges aligned to UTF-8
+// boundaries, so f(std::string_view chunk, char* out) never sees a part of a multi-byte sequence.
+// f has to write exactly chunk.size() bytes. If it throws, the first exception is rethrown once
+// every range has finished.
+template <typename F>
+Rope parallel_transformed(const Rope& text, F f, ThreadPool& pool, size_t chunk_size = default_parallel_chunk_size)
+{
+    auto buffer = std::make_shared<std::string>(text.size(), '\0');
+
+    std::vector<std::future<void>> ranges_done;
+    std::exception_ptr error;
+
+    try
+    {
+        for (size_t begin = 0; begin < text.size();)
+        {
+            const size_t end = next_utf8_boundary(text, std::min(begin + chunk_size, text.size()));
+
+            ranges_done.push_back(pool.submit([&text, &f, out = buffer->data() + begin, begin, end]() mutable {
+                text.for_each_chunk(begin, end - begin, [&](std::string_view chunk) {
+                    f(chunk, out);
+                    out += chunk.size();
+                });
+            }));
+
+            begin = end;
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    // the ranges write into buffer & use text and f - none may outlive this call
+    for (auto& range_done : ranges_done)
+    {
+        try
+        {
+            range_done.get();
+        }
+        catch (...)
+        {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+
+    return Rope{std::shared_ptr<const std::string>{std::move(buffer)}};
+}
+
+#endif // PARALLEL_TRANSFORM_HPP
@@ -0,0 +1,105 @@
+#ifndef PERFECT_HASH_HPP
+#define PERFECT_HASH_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+// Perfect hash of a fixed set of keys built at compile time - the constructor searches for a seed
+// that maps every key to its own slot. A lookup is one hash of the name and one comparison with
+// the key in its slot - no allocation, no probing.
+template <size_t N>
+class PerfectHashTable
+{
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    static constexpr size_t table_size = std::bit_ceil(2 * N); // load factor <= 0.5 - a seed is found quickly
+
+private:
+    static constexpr uint32_t empty_slot = UINT32_MAX;
+    static constexpr uint32_t max_seed = 1 << 16;
+
+    std::array<std::string_view, N> keys_;
+    std::array<uint32_t, table_size> slots_{};
+    uint32_t seed_ = 0;
+
+public:
+    // keys must be unique - otherwise (or if no seed is found) the constant evaluation fails
+    constexpr explicit PerfectHashTable(const std::array<std::string_view, N>& keys)
+        : keys_{keys}
+    {
+        for (size_t i = 0; i < N; ++i)
+            for (size_t j = i + 1; j < N; ++j)
+                if (keys_[i] == keys_[j])
+                    throw std::invalid_argument("PerfectHashTable - duplicate key");
+
+        for (uint32_t seed = 0; seed < max_seed; ++seed)
+        {
+            if (try_seed(seed))
+                return;
+        }
+
+        throw std::logic_error("PerfectHashTable - no perfect seed found");
+    }
+
+    // index of the key in the array passed to the constructor or npos
+    constexpr size_t find(std::string_view name) const
+    {
+        const uint32_t index = slots_[slot(name, seed_)];
+
+        return (index != empty_slot && keys_[index] == name) ? index : npos;
+    }
+
+    constexpr size_t size() const
+    {
+        return N;
+    }
+
+    constexpr std::string_view key(size_t index) const
+    {
+        return keys_[index];
+    }
+
+    constexpr uint32_t seed() const
+    {
+        return seed_;
+    }
+
+private:
+    // FNV-1a started from the seed, high bits folded into the low ones used for the slot
+    static constexpr size_t slot(std::string_view name, uint32_t seed)
+    {
+        uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+        for (char c : name)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+        hash ^= hash >> 16;
+
+        return hash & (table_size - 1);
+    }
+
+    constexpr bool try_seed(uint32_t seed)
+    {
+        slots_.fill(empty_slot);
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            uint32_t& entry = slots_[slot(keys_[i], seed)];
+            if (entry != empty_slot)
+                return false;
+
+            entry = static_cast<uint32_t>(i);
+        }
+
+        seed_ = seed;
+
+        return true;
+    }
+};
+
+#endif // PERFECT_HASH_HPP
@@ -0,0 +1,94 @@
+#ifndef RAW_ARCHIVE_HPP
+#define RAW_ARCHIVE_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "rope.hpp"
+
+// Archives writing length-prefixed values straight into a std::string - no stream in between.
+// A value is written into a buffer grown once to its final size and read back with one memcpy.
+// Drop-in for the TSerializer/TDeserializer parameters of Document::create_memento/set_memento.
+//
+// Format: every value is a 64-bit little-endian length followed by its bytes.
+class RawOutputArchive
+{
+    std::string& buffer_;
+
+public:
+    // values are appended to buffer
+    explicit RawOutputArchive(std::string& buffer)
+        : buffer_{buffer}
+    {
+    }
+
+    template <typename... T>
+    void operator()(const T&... values)
+    {
+        (save(values), ...);
+    }
+
+    void save(std::string_view value)
+    {
+        write_length(value.size());
+        buffer_.append(value);
+    }
+
+    // chunks are copied straight into the buffer - the rope is not flattened first
+    void save(const Rope& value)
+    {
+        write_length(value.size());
+        value.for_each_chunk([this](std::string_view chunk) { buffer_.append(chunk); });
+    }
+
+private:
+    // reserves room for the whole value - appending it does not reallocate (or zero-fill)
+    void write_length(size_t size)
+    {
+        buffer_.reserve(buffer_.size() + sizeof(uint64_t) + size);
+
+        uint64_t length = size;
+        for (size_t i = 0; i < sizeof(length); ++i, length >>= 8)
+            buffer_.push_back(static_cast<char>(length & 0xFF));
+    }
+};
+
+class RawInputArchive
+{
+    std::string_view buffer_;
+
+public:
+    // buffer must outlive the archive
+    explicit RawInputArchive(std::string_view buffer)
+        : buffer_{buffer}
+    {
+    }
+
+    template <typename... T>
+    void operator()(T&... values)
+    {
+        (load(values), ...);
+    }
+
+    // throws std::runtime_error if the buffer ends before the value
+    void load(std::string& value)
+    {
+        if (buffer_.size() < sizeof(uint64_t))
+            throw std::runtime_error("RawInputArchive - truncated length");
+
+        uint64_t length = 0;
+        for (size_t i = sizeof(length); i-- > 0;)
+            length = (length << 8) | static_cast<uint8_t>(buffer_[i]);
+        buffer_.remove_prefix(sizeof(length));
+
+        if (length > buffer_.size())
+            throw std::runtime_error("RawInputArchive - truncated value");
+
+        value.assign(buffer_.data(), length);
+        buffer_.remove_prefix(length);
+    }
+};
+
+#endif // RAW_ARCHIVE_HPP
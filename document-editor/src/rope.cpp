@@ -0,0 +1,306 @@
+#include "rope.hpp"
+
+#include <cassert>
+#include <stdexcept>
+
+Rope::Rope(std::string text)
+    : Rope{std::make_shared<const std::string>(std::move(text))}
+{
+}
+
+Rope::Rope(std::shared_ptr<const std::string> buffer)
+    : Rope{buffer ? std::shared_ptr<const char>{buffer, buffer->data()} : nullptr, buffer ? buffer->size() : 0}
+{
+}
+
+Rope::Rope(std::shared_ptr<const char> data, size_t size)
+    : root_{build(data, size)}
+{
+}
+
+char Rope::at(size_t pos) const
+{
+    if (pos >= size())
+        throw std::out_of_range("Rope::at - position out of range");
+
+    const Node* node = root_.get();
+    while (!node->is_leaf())
+    {
+        if (pos < node->left->length)
+        {
+            node = node->left.get();
+        }
+        else
+        {
+            pos -= node->left->length;
+            node = node->right.get();
+        }
+    }
+
+    return node->data.get()[pos];
+}
+
+size_t Rope::line_start(size_t line) const
+{
+    if (line > newlines())
+        throw std::out_of_range("Rope::line_start - line out of range");
+
+    if (line == 0)
+        return 0;
+
+    // looking for the line-th newline - the line starts right after it
+    size_t offset = 0;
+    const Node* node = root_.get();
+    while (!node->is_leaf())
+    {
+        if (line <= node->left->stats.newlines)
+        {
+            node = node->left.get();
+        }
+        else
+        {
+            line -= node->left->stats.newlines;
+            offset += node->left->length;
+            node = node->right.get();
+        }
+    }
+
+    const std::string_view chunk = node->chunk();
+    size_t pos = 0;
+    for (; line > 0; --line)
+        pos = chunk.find('\n', pos) + 1;
+
+    return offset + pos;
+}
+
+size_t Rope::line_of(size_t pos) const
+{
+    if (pos > size())
+        throw std::out_of_range("Rope::line_of - position out of range");
+
+    size_t line = 0;
+    const Node* node = root_.get();
+    while (node && !node->is_leaf())
+    {
+        if (pos < node->left->length)
+        {
+            node = node->left.get();
+        }
+        else
+        {
+            pos -= node->left->length;
+            line += node->left->stats.newlines;
+            node = node->right.get();
+        }
+    }
+
+    if (node)
+        line += count_newlines(node->chunk().substr(0, pos));
+
+    return line;
+}
+
+std::string Rope::str() const
+{
+    return substr(0);
+}
+
+std::string Rope::substr(size_t pos, size_t count) const
+{
+    if (pos > size())
+        throw std::out_of_range("Rope::substr - position out of range");
+
+    std::string result;
+    result.reserve(std::min(count, size() - pos));
+    for_each_chunk(pos, count, [&result](std::string_view chunk) { result.append(chunk); });
+
+    return result;
+}
+
+void Rope::append(const Rope& other)
+{
+    root_ = join(root_, other.root_);
+}
+
+void Rope::insert(size_t pos, const Rope& other)
+{
+    replace(pos, 0, other);
+}
+
+void Rope::erase(size_t pos, size_t count)
+{
+    replace(pos, count, Rope{});
+}
+
+void Rope::replace(size_t pos, size_t count, const Rope& other)
+{
+    if (pos > size())
+        throw std::out_of_range("Rope::replace - position out of range");
+
+    count = std::min(count, size() - pos);
+
+    auto [head, rest] = split(root_, pos);
+    auto [removed, tail] = split(rest, count);
+
+    root_ = join(join(std::move(head), other.root_), std::move(tail));
+}
+
+std::pair<Rope, Rope> Rope::split(size_t pos) const
+{
+    if (pos > size())
+        throw std::out_of_range("Rope::split - position out of range");
+
+    auto [left, right] = split(root_, pos);
+
+    return {Rope{std::move(left)}, Rope{std::move(right)}};
+}
+
+Rope Rope::slice(size_t pos, size_t count) const
+{
+    if (pos > size())
+        throw std::out_of_range("Rope::slice - position out of range");
+
+    count = std::min(count, size() - pos);
+
+    auto [head, rest] = split(root_, pos);
+    auto [middle, tail] = split(rest, count);
+
+    return Rope{std::move(middle)};
+}
+
+size_t Rope::count_newlines(std::string_view chunk)
+{
+    return static_cast<size_t>(std::count(chunk.begin(), chunk.end(), '\n'));
+}
+
+Rope::NodePtr Rope::make_leaf(std::shared_ptr<const char> data, size_t length)
+{
+    if (length == 0)
+        return nullptr;
+
+    const TextStats stats = count_text_stats({data.get(), length});
+
+    return std::make_shared<const Node>(Node{nullptr, nullptr, std::move(data), length, stats, 0});
+}
+
+Rope::NodePtr Rope::make_node(NodePtr left, NodePtr right)
+{
+    const size_t length = left->length + right->length;
+    const TextStats stats = left->stats + right->stats;
+    const int height = std::max(left->height, right->height) + 1;
+
+    return std::make_shared<const Node>(Node{std::move(left), std::move(right), nullptr, length, stats, height});
+}
+
+// joins two subtrees whose heights differ by at most 2 - single or double rotation restores the balance
+Rope::NodePtr Rope::balance(NodePtr left, NodePtr right)
+{
+    if (left->height > right->height + 1)
+    {
+        if (left->left->height >= left->right->height)
+            return make_node(left->left, make_node(left->right, std::move(right)));
+
+        const NodePtr& middle = left->right;
+        return make_node(make_node(left->left, middle->left), make_node(middle->right, std::move(right)));
+    }
+
+    if (right->height > left->height + 1)
+    {
+        if (right->right->height >= right->left->height)
+            return make_node(make_node(std::move(left), right->left), right->right);
+
+        const NodePtr& middle = right->left;
+        return make_node(make_node(std::move(left), middle->left), make_node(middle->right, right->right));
+    }
+
+    return make_node(std::move(left), std::move(right));
+}
+
+Rope::NodePtr Rope::join(NodePtr left, NodePtr right)
+{
+    if (!left)
+        return right;
+
+    if (!right)
+        return left;
+
+    // small adjacent chunks are merged - appending short lines does not produce a leaf per line
+    if (left->is_leaf() && right->is_leaf() && left->length + right->length <= merge_chunk_size)
+    {
+        auto buffer = std::make_shared<std::string>();
+        buffer->reserve(left->length + right->length);
+        buffer->append(left->chunk()).append(right->chunk());
+
+        const char* data = buffer->data();
+        return make_leaf(std::shared_ptr<const char>{std::move(buffer), data}, left->length + right->length);
+    }
+
+    const bool small_right = right->is_leaf() && right->length < merge_chunk_size;
+    const bool small_left = left->is_leaf() && left->length < merge_chunk_size;
+
+    if (left->height > right->height + 1 || (small_right && !left->is_leaf()))
+        return balance(left->left, join(left->right, std::move(right)));
+
+    if (right->height > left->height + 1 || (small_left && !right->is_leaf()))
+        return balance(join(std::move(left), right->left), right->right);
+
+    return make_node(std::move(left), std::move(right));
+}
+
+std::pair<Rope::NodePtr, Rope::NodePtr> Rope::split(const NodePtr& node, size_t pos)
+{
+    if (!node)
+        return {nullptr, nullptr};
+
+    if (pos == 0)
+        return {nullptr, node};
+
+    if (pos >= node->length)
+        return {node, nullptr};
+
+    if (node->is_leaf())
+    {
+        // both halves keep pointing into the same buffer
+        return {make_leaf(node->data, pos), make_leaf(std::shared_ptr<const char>{node->data, node->data.get() + pos}, node->length - pos)};
+    }
+
+    const size_t left_length = node->left->length;
+
+    if (pos < left_length)
+    {
+        auto [left, right] = split(node->left, pos);
+        return {std::move(left), join(std::move(right), node->right)};
+    }
+
+    auto [left, right] = split(node->right, pos - left_length);
+    return {join(node->left, std::move(left)), std::move(right)};
+}
+
+Rope::NodePtr Rope::build(const std::shared_ptr<const char>& data, size_t size)
+{
+    if (!data || size == 0)
+        return nullptr;
+
+    std::vector<NodePtr> leaves;
+    leaves.reserve((size + max_chunk_size - 1) / max_chunk_size);
+
+    for (size_t offset = 0; offset < size; offset += max_chunk_size)
+    {
+        const size_t length = std::min(max_chunk_size, size - offset);
+        leaves.push_back(make_leaf(std::shared_ptr<const char>{data, data.get() + offset}, length));
+    }
+
+    return build(leaves, 0, leaves.size());
+}
+
+Rope::NodePtr Rope::build(const std::vector<NodePtr>& leaves, size_t first, size_t last)
+{
+    assert(first < last);
+
+    if (last - first == 1)
+        return leaves[first];
+
+    const size_t middle = first + (last - first) / 2;
+
+    return make_node(build(leaves, first, middle), build(leaves, middle, last));
+}
@@ -0,0 +1,182 @@
+#ifndef ROPE_HPP
+#define ROPE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "text_stats.hpp"
+
+// Balanced (AVL) rope - text stored as a tree of chunks
+//  - nodes are immutable and shared, so copying a rope is O(1)
+//  - leaves point into shared buffers, so splitting a chunk copies no text
+//  - insert, erase & replace are O(log n)
+//  - nodes count their newlines & words, so line <-> offset lookups are O(log n) as well and
+//    the counts of the whole text O(1)
+class Rope
+{
+    struct Node
+    {
+        std::shared_ptr<const Node> left;
+        std::shared_ptr<const Node> right;
+        std::shared_ptr<const char> data; // leaves only - aliases the buffer owning the chunk
+        size_t length;
+        TextStats stats; // of the subtree - newlines let line lookups descend like position lookups
+        int height;      // leaves have height 0
+
+        bool is_leaf() const
+        {
+            return left == nullptr;
+        }
+
+        std::string_view chunk() const
+        {
+            return {data.get(), length};
+        }
+    };
+
+    using NodePtr = std::shared_ptr<const Node>;
+
+    NodePtr root_;
+
+public:
+    static constexpr size_t max_chunk_size = 16 * 1024;
+    static constexpr size_t merge_chunk_size = 512;
+
+    Rope() = default;
+
+    explicit Rope(std::string text);
+
+    explicit Rope(std::shared_ptr<const std::string> buffer);
+
+    // leaves alias [data, data + size) - the owner of data (e.g. a memory mapped file) lives as long as any leaf
+    Rope(std::shared_ptr<const char> data, size_t size);
+
+    size_t size() const
+    {
+        return root_ ? root_->length : 0;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    int height() const
+    {
+        return root_ ? root_->height : 0;
+    }
+
+    size_t newlines() const
+    {
+        return root_ ? root_->stats.newlines : 0;
+    }
+
+    // runs of non-whitespace bytes - kept per node like newlines, so it is O(1)
+    size_t words() const
+    {
+        return root_ ? root_->stats.words : 0;
+    }
+
+    char at(size_t pos) const;
+
+    // offset of the first character of the line (lines are numbered from 0)
+    size_t line_start(size_t line) const;
+
+    // line containing the character at pos - the number of newlines before pos
+    size_t line_of(size_t pos) const;
+
+    std::string str() const;
+
+    std::string substr(size_t pos, size_t count = std::string::npos) const;
+
+    void append(const Rope& other);
+
+    void insert(size_t pos, const Rope& other);
+
+    void erase(size_t pos, size_t count = std::string::npos);
+
+    void replace(size_t pos, size_t count, const Rope& other);
+
+    // splits the rope into [0, pos) and [pos, size())
+    std::pair<Rope, Rope> split(size_t pos) const;
+
+    // rope sharing the chunks of the range [pos, pos + count)
+    Rope slice(size_t pos, size_t count = std::string::npos) const;
+
+    // calls f(std::string_view) for consecutive chunks of the text
+    template <typename F>
+    void for_each_chunk(F f) const
+    {
+        for_each_chunk(0, size(), std::move(f));
+    }
+
+    // calls f(std::string_view) for consecutive chunks of the range [pos, pos + count)
+    template <typename F>
+    void for_each_chunk(size_t pos, size_t count, F f) const
+    {
+        if (pos >= size() || count == 0)
+            return;
+
+        visit(root_, pos, std::min(count, size() - pos), f);
+    }
+
+    // rope with the text rewritten by f(std::string_view chunk, char* out) into one fresh buffer
+    template <typename F>
+    Rope transformed(F f) const
+    {
+        auto buffer = std::make_shared<std::string>(size(), '\0');
+        char* out = buffer->data();
+
+        for_each_chunk([&](std::string_view chunk) {
+            f(chunk, out);
+            out += chunk.size();
+        });
+
+        return Rope{std::shared_ptr<const std::string>{std::move(buffer)}};
+    }
+
+private:
+    explicit Rope(NodePtr root)
+        : root_{std::move(root)}
+    {
+    }
+
+    template <typename F>
+    static void visit(const NodePtr& node, size_t pos, size_t count, F& f)
+    {
+        if (node->is_leaf())
+        {
+            f(node->chunk().substr(pos, count));
+            return;
+        }
+
+        const size_t left_length = node->left->length;
+
+        if (pos < left_length)
+        {
+            const size_t left_count = std::min(count, left_length - pos);
+            visit(node->left, pos, left_count, f);
+            pos = left_length;
+            count -= left_count;
+        }
+
+        if (count > 0)
+            visit(node->right, pos - left_length, count, f);
+    }
+
+    static size_t count_newlines(std::string_view chunk);
+    static NodePtr make_leaf(std::shared_ptr<const char> data, size_t length);
+    static NodePtr make_node(NodePtr left, NodePtr right);
+    static NodePtr balance(NodePtr left, NodePtr right);
+    static NodePtr join(NodePtr left, NodePtr right);
+    static std::pair<NodePtr, NodePtr> split(const NodePtr& node, size_t pos);
+    static NodePtr build(const std::shared_ptr<const char>& data, size_t size);
+    static NodePtr build(const std::vector<NodePtr>& leaves, size_t first, size_t last);
+};
+
+#endif // ROPE_HPP
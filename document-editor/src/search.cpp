@@ -0,0 +1,209 @@
+#include "search.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "simd_intrinsics.hpp"
+
+namespace
+{
+    constexpr size_t npos = std::string::npos;
+
+    bool matches_inner_bytes(const char* candidate, std::string_view pattern)
+    {
+        // first & last bytes are already compared by the filter
+        return pattern.size() < 3 || std::memcmp(candidate + 1, pattern.data() + 1, pattern.size() - 2) == 0;
+    }
+
+#if defined(DOCUMENT_SIMD_X86)
+    // scans while full blocks fit - pos is left where the scalar search has to continue
+    size_t find_sse2(std::string_view text, std::string_view pattern, size_t& pos)
+    {
+        const size_t m = pattern.size();
+        const __m128i first = _mm_set1_epi8(pattern.front());
+        const __m128i last = _mm_set1_epi8(pattern.back());
+
+        for (; pos + m - 1 + 16 <= text.size(); pos += 16)
+        {
+            const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));
+            const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos + m - 1));
+
+            auto candidates = static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+
+            for (; candidates != 0; candidates &= candidates - 1)
+            {
+                const size_t candidate = pos + std::countr_zero(candidates);
+                if (matches_inner_bytes(text.data() + candidate, pattern))
+                    return candidate;
+            }
+        }
+
+        return npos;
+    }
+
+    DOCUMENT_TARGET_AVX2 size_t find_avx2(std::string_view text, std::string_view pattern, size_t& pos)
+    {
+        const size_t m = pattern.size();
+        const __m256i first = _mm256_set1_epi8(pattern.front());
+        const __m256i last = _mm256_set1_epi8(pattern.back());
+
+        for (; pos + m - 1 + 32 <= text.size(); pos += 32)
+        {
+            const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + pos));
+            const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + pos + m - 1));
+
+            auto candidates = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+
+            for (; candidates != 0; candidates &= candidates - 1)
+            {
+                const size_t candidate = pos + std::countr_zero(candidates);
+                if (matches_inner_bytes(text.data() + candidate, pattern))
+                    return candidate;
+            }
+        }
+
+        return npos;
+    }
+#endif
+
+    // calls on_match(pos) for non-overlapping occurrences in [from, text.size()) until it returns false.
+    // Occurrences spanning chunks are found in a small buffer joining the last m - 1 bytes seen
+    // with the beginning of the next chunk.
+    template <typename F>
+    void scan(const Searcher& searcher, const Rope& text, size_t from, F on_match)
+    {
+        const size_t m = searcher.pattern().size();
+
+        std::string window;   // last (at most m - 1) bytes before the current chunk
+        std::string boundary; // window + first m - 1 bytes of the current chunk
+        size_t chunk_start = from;
+        size_t next = from; // occurrences may not start before the end of the previous one
+        bool done = false;
+
+        text.for_each_chunk(from, text.size(), [&](std::string_view chunk) {
+            if (done)
+                return;
+
+            if (!window.empty())
+            {
+                boundary.assign(window).append(chunk.substr(0, m - 1));
+                const size_t window_start = chunk_start - window.size();
+
+                for (size_t pos = searcher.find(boundary, std::max(next, window_start) - window_start);
+                     pos != npos && pos < window.size(); pos = searcher.find(boundary, next - window_start))
+                {
+                    next = window_start + pos + m;
+                    if (!on_match(window_start + pos))
+                    {
+                        done = true;
+                        return;
+                    }
+                }
+            }
+
+            for (size_t pos = searcher.find(chunk, std::max(next, chunk_start) - chunk_start); pos != npos;
+                 pos = searcher.find(chunk, next - chunk_start))
+            {
+                next = chunk_start + pos + m;
+                if (!on_match(chunk_start + pos))
+                {
+                    done = true;
+                    return;
+                }
+            }
+
+            if (chunk.size() >= m - 1)
+                window.assign(chunk.substr(chunk.size() - (m - 1)));
+            else
+                window.append(chunk).erase(0, window.size() > m - 1 ? window.size() - (m - 1) : 0);
+
+            chunk_start += chunk.size();
+        });
+    }
+} // namespace
+
+Searcher::Searcher(std::string pattern, SimdLevel level)
+    : pattern_{std::move(pattern)}
+    , level_{std::min(level, detect_simd_level())}
+{
+    if (pattern_.empty())
+        throw std::invalid_argument("Search pattern must not be empty");
+
+    const size_t m = pattern_.size();
+
+    shifts_.fill(m);
+    for (size_t i = 0; i + 1 < m; ++i)
+        shifts_[static_cast<unsigned char>(pattern_[i])] = m - 1 - i;
+}
+
+size_t Searcher::find(std::string_view text, size_t from) const
+{
+    if (from > text.size() || text.size() - from < pattern_.size())
+        return npos;
+
+    size_t pos = from;
+
+#if defined(DOCUMENT_SIMD_X86)
+    if (level_ == SimdLevel::AVX2)
+    {
+        if (const size_t found = find_avx2(text, pattern_, pos); found != npos)
+            return found;
+    }
+    else if (level_ == SimdLevel::SSE2)
+    {
+        if (const size_t found = find_sse2(text, pattern_, pos); found != npos)
+            return found;
+    }
+#endif
+
+    return find_horspool(text, pos);
+}
+
+size_t Searcher::find(const Rope& text, size_t from) const
+{
+    size_t found = npos;
+
+    scan(*this, text, from, [&found](size_t pos) {
+        found = pos;
+        return false;
+    });
+
+    return found;
+}
+
+std::vector<size_t> Searcher::find_all(const Rope& text) const
+{
+    std::vector<size_t> occurrences;
+
+    scan(*this, text, 0, [&occurrences](size_t pos) {
+        occurrences.push_back(pos);
+        return true;
+    });
+
+    return occurrences;
+}
+
+size_t Searcher::find_horspool(std::string_view text, size_t from) const
+{
+    const size_t m = pattern_.size();
+    const char last = pattern_.back();
+
+    if (m == 1) // no shifts to gain - memchr is vectorized by the C library
+    {
+        const void* found = std::memchr(text.data() + from, last, text.size() - from);
+        return found ? static_cast<const char*>(found) - text.data() : npos;
+    }
+
+    for (size_t pos = from; pos + m <= text.size(); pos += shifts_[static_cast<unsigned char>(text[pos + m - 1])])
+    {
+        if (text[pos + m - 1] == last && std::memcmp(text.data() + pos, pattern_.data(), m - 1) == 0)
+            return pos;
+    }
+
+    return npos;
+}
@@ -0,0 +1,43 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rope.hpp"
+#include "simd.hpp"
+
+// Exact substring search. Candidates are filtered 32 (AVX2) or 16 (SSE2) positions at a time by
+// comparing the first and the last byte of the pattern, and verified with memcmp; the scalar path
+// and the tails use Horspool's bad character shifts.
+class Searcher
+{
+    std::string pattern_;
+    std::array<size_t, 256> shifts_;
+    SimdLevel level_;
+
+public:
+    explicit Searcher(std::string pattern, SimdLevel level = detect_simd_level());
+
+    const std::string& pattern() const
+    {
+        return pattern_;
+    }
+
+    // first occurrence starting at or after from, npos if there is none
+    size_t find(std::string_view text, size_t from = 0) const;
+
+    // first occurrence in the rope starting at or after from - matches may span chunks
+    size_t find(const Rope& text, size_t from = 0) const;
+
+    // non-overlapping occurrences from left to right
+    std::vector<size_t> find_all(const Rope& text) const;
+
+private:
+    size_t find_horspool(std::string_view text, size_t from) const;
+};
+
+#endif // SEARCH_HPP
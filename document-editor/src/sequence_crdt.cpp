@@ -0,0 +1,565 @@
+#include "sequence_crdt.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    void put_varint(std::string& out, uint64_t value)
+    {
+        for (; value >= 0x80; value >>= 7)
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        out.push_back(static_cast<char>(value));
+    }
+
+    void put_signed(std::string& out, int64_t value)
+    {
+        put_varint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63)); // zigzag
+    }
+
+    [[noreturn]] void throw_malformed()
+    {
+        throw std::runtime_error("Malformed operation batch");
+    }
+
+    class Reader
+    {
+        std::string_view data_;
+        size_t pos_ = 0;
+
+    public:
+        explicit Reader(std::string_view data)
+            : data_{data}
+        {
+        }
+
+        uint64_t varint()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (pos_ == data_.size())
+                    throw_malformed();
+
+                const auto byte = static_cast<uint8_t>(data_[pos_++]);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+
+            throw_malformed();
+        }
+
+        int64_t signed_varint()
+        {
+            const uint64_t value = varint();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        uint8_t byte()
+        {
+            if (pos_ == data_.size())
+                throw_malformed();
+
+            return static_cast<uint8_t>(data_[pos_++]);
+        }
+
+        std::string_view bytes(uint64_t count)
+        {
+            if (count > data_.size() - pos_)
+                throw_malformed();
+
+            const std::string_view result = data_.substr(pos_, static_cast<size_t>(count));
+            pos_ += result.size();
+
+            return result;
+        }
+
+        bool at_end() const
+        {
+            return pos_ == data_.size();
+        }
+    };
+
+    uint32_t to_site(uint64_t value)
+    {
+        if (value > UINT32_MAX)
+            throw_malformed();
+
+        return static_cast<uint32_t>(value);
+    }
+} // namespace
+
+std::string encode_ops(const std::vector<CrdtOp>& ops)
+{
+    std::string out;
+    put_varint(out, ops.size());
+
+    uint64_t previous_counter = 0;
+    for (const CrdtOp& op : ops)
+    {
+        out.push_back(static_cast<char>(op.kind));
+        put_varint(out, op.id.site);
+        put_signed(out, static_cast<int64_t>(op.id.counter - previous_counter));
+        put_varint(out, op.length);
+        previous_counter = op.id.counter;
+
+        if (op.kind == CrdtOp::Kind::Insert)
+        {
+            // the origin is mostly the character just before - a short distance back
+            put_varint(out, op.origin.site);
+            put_signed(out, static_cast<int64_t>(op.id.counter - op.origin.counter));
+            out.append(op.text);
+        }
+    }
+
+    return out;
+}
+
+std::vector<CrdtOp> decode_ops(std::string_view batch)
+{
+    Reader in{batch};
+
+    const uint64_t count = in.varint();
+    if (count > batch.size()) // every op takes some bytes
+        throw_malformed();
+
+    std::vector<CrdtOp> ops;
+    ops.reserve(static_cast<size_t>(count));
+
+    uint64_t previous_counter = 0;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        CrdtOp op{};
+
+        const uint8_t kind = in.byte();
+        if (kind > static_cast<uint8_t>(CrdtOp::Kind::Erase))
+            throw_malformed();
+
+        op.kind = static_cast<CrdtOp::Kind>(kind);
+        op.id.site = to_site(in.varint());
+        op.id.counter = previous_counter + static_cast<uint64_t>(in.signed_varint());
+        op.length = in.varint();
+        previous_counter = op.id.counter;
+
+        if (op.kind == CrdtOp::Kind::Insert)
+        {
+            op.origin.site = to_site(in.varint());
+            op.origin.counter = op.id.counter - static_cast<uint64_t>(in.signed_varint());
+            op.text = in.bytes(op.length);
+        }
+
+        ops.push_back(std::move(op));
+    }
+
+    if (!in.at_end())
+        throw_malformed();
+
+    return ops;
+}
+
+SequenceCrdt::SequenceCrdt(Document& doc, uint32_t site)
+    : doc_{doc}
+    , site_{site}
+    , clock_{doc.length()}
+    , random_state_{site * 2654435761u | 1}
+{
+    if (site == 0)
+        throw std::invalid_argument("Site 0 is reserved for the base text");
+
+    // the head is an erased character every insert at the start of the document follows
+    head_ = new_item(CrdtId{}, CrdtId{}, 1, true);
+    root_ = head_;
+
+    if (clock_ > 0)
+    {
+        Item* base = new_item(CrdtId{1, 0}, CrdtId{}, clock_, false);
+        insert_after(head_, base);
+        index_[0][1] = base;
+    }
+
+    listener_ = doc_.add_edit_listener(
+        [this](uint64_t, size_t pos, size_t count, const Rope& inserted) { local_edit(pos, count, inserted); });
+}
+
+SequenceCrdt::~SequenceCrdt()
+{
+    doc_.remove_edit_listener(listener_);
+}
+
+std::vector<CrdtOp> SequenceCrdt::take_local_ops()
+{
+    return std::exchange(local_ops_, {});
+}
+
+bool SequenceCrdt::merge(const std::vector<CrdtOp>& ops)
+{
+    const uint64_t version = doc_.version();
+
+    bool merged_any = false;
+    for (const CrdtOp& op : ops)
+    {
+        if (try_merge(op))
+            merged_any = true;
+        else
+            waiting_ops_.push_back(op);
+    }
+
+    // ops waiting for the merged ones - until no more can be merged
+    while (merged_any && !waiting_ops_.empty())
+    {
+        merged_any = false;
+        std::vector<CrdtOp> waiting = std::move(waiting_ops_);
+        waiting_ops_.clear();
+
+        for (CrdtOp& op : waiting)
+        {
+            if (try_merge(op))
+                merged_any = true;
+            else
+                waiting_ops_.push_back(std::move(op));
+        }
+    }
+
+    return doc_.version() != version;
+}
+
+void SequenceCrdt::local_edit(size_t pos, size_t count, const Rope& inserted)
+{
+    if (merging_)
+        return; // the edit of a remote op
+
+    while (count > 0)
+    {
+        auto [item, offset] = at(pos);
+        if (offset > 0)
+            item = split(item, offset);
+        if (item->length > count)
+            split(item, count);
+
+        erase_run(item);
+        count -= static_cast<size_t>(item->length);
+        add_local_op({CrdtOp::Kind::Erase, item->id, CrdtId{}, item->length, {}});
+    }
+
+    if (inserted.size() == 0)
+        return;
+
+    CrdtId origin{};
+    if (pos > 0)
+    {
+        const auto [item, offset] = at(pos - 1);
+        origin = {item->id.counter + offset, item->id.site};
+    }
+
+    const CrdtId id{clock_ + 1, site_};
+    integrate(id, origin, inserted.size(), nullptr);
+    add_local_op({CrdtOp::Kind::Insert, id, origin, inserted.size(), inserted.substr(0)});
+}
+
+bool SequenceCrdt::try_merge(const CrdtOp& op)
+{
+    if (op.length == 0)
+        return true;
+
+    if (op.kind == CrdtOp::Kind::Insert)
+    {
+        if (op.id.site == 0 || op.text.size() != op.length)
+            throw std::runtime_error("Malformed insert operation");
+
+        if (find(op.id))
+            return true; // merged already
+        if (!find(op.origin))
+            return false;
+
+        integrate(op.id, op.origin, op.length, &op.text);
+        return true;
+    }
+
+    // all the erased characters must be known - runs of one site cover consecutive counters
+    const auto runs = index_.find(op.id.site);
+    if (runs == index_.end())
+        return false;
+
+    const uint64_t end = op.id.counter + op.length;
+    for (uint64_t counter = op.id.counter; counter < end;)
+    {
+        auto it = runs->second.upper_bound(counter);
+        if (it == runs->second.begin())
+            return false;
+
+        --it;
+        if (counter >= it->first + it->second->length)
+            return false;
+
+        counter = it->first + it->second->length;
+    }
+
+    for (uint64_t counter = op.id.counter; counter < end;)
+    {
+        Item* item = find({counter, op.id.site});
+        if (counter > item->id.counter)
+            item = split(item, counter - item->id.counter);
+        if (item->length > end - counter)
+            split(item, end - counter);
+
+        counter += item->length;
+        if (item->erased)
+            continue; // erased concurrently
+
+        const uint64_t pos = position(item);
+        erase_run(item);
+
+        merging_ = true;
+        doc_.erase(static_cast<size_t>(pos), static_cast<size_t>(item->length));
+        merging_ = false;
+    }
+
+    return true;
+}
+
+void SequenceCrdt::integrate(const CrdtId& id, const CrdtId& origin, uint64_t length, const std::string* text)
+{
+    Item* previous = find(origin);
+    const uint64_t offset = origin.counter - previous->id.counter;
+    if (offset + 1 < previous->length)
+        split(previous, offset + 1);
+
+    // concurrent inserts after the same character are ordered by descending ids - the ones inserted
+    // after them have even higher ids, so skipping higher ids skips their whole subtrees
+    Item* origin_item = previous;
+    for (Item* next = successor(previous); next && id < next->id; next = successor(next))
+        previous = next;
+
+    const uint64_t pos = position(previous) + (previous->erased ? 0 : previous->length);
+
+    if (previous == origin_item && previous != head_ && !previous->erased && previous->id.site == id.site &&
+        previous->id.counter + previous->length == id.counter)
+    {
+        // typing continues a run
+        previous->length += length;
+        update_path(previous);
+    }
+    else
+    {
+        Item* item = new_item(id, origin, length, false);
+        insert_after(previous, item);
+        index_[id.site][id.counter] = item;
+    }
+
+    clock_ = std::max(clock_, id.counter + length - 1);
+
+    if (text)
+    {
+        merging_ = true;
+        doc_.insert(static_cast<size_t>(pos), *text);
+        merging_ = false;
+    }
+}
+
+void SequenceCrdt::erase_run(Item* item)
+{
+    item->erased = true;
+    update_path(item);
+}
+
+void SequenceCrdt::add_local_op(CrdtOp op)
+{
+    if (!local_ops_.empty() && local_ops_.back().kind == op.kind && local_ops_.back().id.site == op.id.site)
+    {
+        CrdtOp& last = local_ops_.back();
+        const uint64_t last_end = last.id.counter + last.length;
+
+        if (op.kind == CrdtOp::Kind::Insert && op.id.counter == last_end &&
+            op.origin == CrdtId{last_end - 1, last.id.site})
+        {
+            last.length += op.length;
+            last.text += op.text;
+            return;
+        }
+
+        if (op.kind == CrdtOp::Kind::Erase && op.id.counter == last_end)
+        {
+            last.length += op.length;
+            return;
+        }
+
+        if (op.kind == CrdtOp::Kind::Erase && op.id.counter + op.length == last.id.counter)
+        {
+            last.id = op.id; // backspacing
+            last.length += op.length;
+            return;
+        }
+    }
+
+    local_ops_.push_back(std::move(op));
+}
+
+SequenceCrdt::Item* SequenceCrdt::new_item(const CrdtId& id, const CrdtId& origin, uint64_t length, bool erased)
+{
+    // xorshift - treap priorities need not be shared between replicas
+    random_state_ ^= random_state_ << 13;
+    random_state_ ^= random_state_ >> 17;
+    random_state_ ^= random_state_ << 5;
+
+    Item& item = items_.emplace_back();
+    item.id = id;
+    item.origin = origin;
+    item.length = length;
+    item.erased = erased;
+    item.priority = random_state_;
+    update(&item);
+
+    return &item;
+}
+
+SequenceCrdt::Item* SequenceCrdt::find(const CrdtId& id) const
+{
+    if (id == CrdtId{})
+        return head_;
+
+    const auto runs = index_.find(id.site);
+    if (runs == index_.end())
+        return nullptr;
+
+    auto it = runs->second.upper_bound(id.counter);
+    if (it == runs->second.begin())
+        return nullptr;
+
+    --it;
+    return id.counter < it->first + it->second->length ? it->second : nullptr;
+}
+
+SequenceCrdt::Item* SequenceCrdt::split(Item* item, uint64_t offset)
+{
+    const CrdtId id{item->id.counter + offset, item->id.site};
+    Item* rest = new_item(id, CrdtId{id.counter - 1, id.site}, item->length - offset, item->erased);
+
+    item->length = offset;
+    update_path(item);
+    insert_after(item, rest);
+    index_[id.site][id.counter] = rest;
+
+    return rest;
+}
+
+std::pair<SequenceCrdt::Item*, uint64_t> SequenceCrdt::at(uint64_t pos) const
+{
+    Item* item = root_;
+    while (true)
+    {
+        if (pos < visible(item->left))
+        {
+            item = item->left;
+            continue;
+        }
+
+        pos -= visible(item->left);
+        if (!item->erased)
+        {
+            if (pos < item->length)
+                return {item, pos};
+
+            pos -= item->length;
+        }
+
+        item = item->right;
+    }
+}
+
+uint64_t SequenceCrdt::position(const Item* item) const
+{
+    uint64_t pos = visible(item->left);
+    for (; item->parent; item = item->parent)
+    {
+        if (item == item->parent->right)
+            pos += visible(item->parent->left) + (item->parent->erased ? 0 : item->parent->length);
+    }
+
+    return pos;
+}
+
+SequenceCrdt::Item* SequenceCrdt::successor(Item* item)
+{
+    if (item->right)
+    {
+        item = item->right;
+        while (item->left)
+            item = item->left;
+
+        return item;
+    }
+
+    while (item->parent && item == item->parent->right)
+        item = item->parent;
+
+    return item->parent;
+}
+
+void SequenceCrdt::insert_after(Item* item, Item* added)
+{
+    if (!item->right)
+    {
+        item->right = added;
+    }
+    else
+    {
+        item = item->right;
+        while (item->left)
+            item = item->left;
+
+        item->left = added;
+    }
+
+    added->parent = item;
+    update_path(added);
+
+    while (added->parent && added->priority > added->parent->priority)
+        rotate_up(added);
+}
+
+void SequenceCrdt::rotate_up(Item* item)
+{
+    Item* parent = item->parent;
+    Item* grandparent = parent->parent;
+
+    if (item == parent->left)
+    {
+        parent->left = item->right;
+        if (item->right)
+            item->right->parent = parent;
+        item->right = parent;
+    }
+    else
+    {
+        parent->right = item->left;
+        if (item->left)
+            item->left->parent = parent;
+        item->left = parent;
+    }
+
+    parent->parent = item;
+    item->parent = grandparent;
+
+    if (!grandparent)
+        root_ = item;
+    else if (grandparent->left == parent)
+        grandparent->left = item;
+    else
+        grandparent->right = item;
+
+    update(parent);
+    update(item);
+}
+
+void SequenceCrdt::update_path(Item* item)
+{
+    for (; item; item = item->parent)
+        update(item);
+}
+
+void SequenceCrdt::update(Item* item)
+{
+    item->visible = visible(item->left) + visible(item->right) + (item->erased ? 0 : item->length);
+}
@@ -0,0 +1,162 @@
+#ifndef SEQUENCE_CRDT_HPP
+#define SEQUENCE_CRDT_HPP
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "document.hpp"
+
+// identifies a character for good - the Lamport clock of the site that inserted it & the site
+struct CrdtId
+{
+    uint64_t counter = 0; // 0 - the start of the document
+    uint32_t site = 0;    // 0 - the base text every replica starts with
+
+    // counter first, then site - a total order all replicas agree on
+    auto operator<=>(const CrdtId&) const = default;
+};
+
+// insert: text with ids id, id + 1, ... placed after the character origin
+// erase: length characters with ids id, id + 1, ... (inserted by one site)
+struct CrdtOp
+{
+    enum class Kind : uint8_t
+    {
+        Insert,
+        Erase
+    };
+
+    Kind kind;
+    CrdtId id;
+    CrdtId origin;
+    uint64_t length;
+    std::string text;
+
+    bool operator==(const CrdtOp&) const = default;
+};
+
+// Batch of ops as bytes: op count, then per op the kind, ids as LEB128 varints delta coded against
+// the previous op, length & text - a run of typed characters is a single op.
+std::string encode_ops(const std::vector<CrdtOp>& ops);
+
+// throws std::runtime_error for a malformed batch
+std::vector<CrdtOp> decode_ops(std::string_view batch);
+
+// Replicated growable array (RGA) kept in sync with a Document. The text stays in the document -
+// the CRDT holds only the ids of the characters in their order (runs of consecutive ids, erased
+// ones as tombstones) in a treap that sums the visible characters, so the document position of any
+// run is found in O(log n).
+//
+// Local edits of the document (any command, undo included) become ops through an edit listener;
+// merged remote ops edit the document. They become part of its history like local edits, so an undo
+// history must be cleared after a merge - undo would send the reverted remote edits as local ops.
+// Concurrent inserts at one place are ordered by their ids, so every replica that has merged the
+// same ops has the same text whatever the order of delivery.
+// An op whose characters are not known yet (e.g. erasing text not received) waits until they are.
+class SequenceCrdt
+{
+    struct Item
+    {
+        CrdtId id; // of the first character - the others follow with consecutive counters
+        CrdtId origin;
+        uint64_t length;
+        bool erased;
+
+        Item* left = nullptr;
+        Item* right = nullptr;
+        Item* parent = nullptr;
+        uint32_t priority;
+        uint64_t visible = 0; // characters not erased in the subtree
+    };
+
+    Document& doc_;
+    uint32_t site_;
+    uint64_t clock_;
+
+    std::deque<Item> items_; // stable addresses - runs are split, never removed
+    Item* root_ = nullptr;
+    Item* head_;             // the start of the document, id {0, 0}
+    std::unordered_map<uint32_t, std::map<uint64_t, Item*>> index_; // site -> first counter -> run
+    uint32_t random_state_;
+
+    std::vector<CrdtOp> local_ops_;
+    std::vector<CrdtOp> waiting_ops_;
+    bool merging_ = false;
+    size_t listener_;
+
+public:
+    // the current text of the document is the base all replicas share, site must be unique & not 0
+    SequenceCrdt(Document& doc, uint32_t site);
+
+    SequenceCrdt(const SequenceCrdt&) = delete;
+    SequenceCrdt& operator=(const SequenceCrdt&) = delete;
+
+    ~SequenceCrdt();
+
+    uint32_t site() const
+    {
+        return site_;
+    }
+
+    // ops of the local edits since the last call - adjacent typed characters & erasures are coalesced
+    std::vector<CrdtOp> take_local_ops();
+
+    bool has_local_ops() const
+    {
+        return !local_ops_.empty();
+    }
+
+    // applies remote ops to the document - ops already merged are skipped. Returns false if the
+    // document was not changed.
+    bool merge(const std::vector<CrdtOp>& ops);
+
+    bool merge(std::string_view batch)
+    {
+        return merge(decode_ops(batch));
+    }
+
+    // remote ops waiting for characters they refer to
+    size_t waiting_ops() const
+    {
+        return waiting_ops_.size();
+    }
+
+    // runs of characters held - tombstones included
+    size_t run_count() const
+    {
+        return items_.size();
+    }
+
+private:
+    void local_edit(size_t pos, size_t count, const Rope& inserted);
+    bool try_merge(const CrdtOp& op);
+
+    void integrate(const CrdtId& id, const CrdtId& origin, uint64_t length, const std::string* text);
+    void erase_run(Item* item);
+    void add_local_op(CrdtOp op);
+
+    Item* new_item(const CrdtId& id, const CrdtId& origin, uint64_t length, bool erased);
+    Item* find(const CrdtId& id) const;                  // run holding the character, nullptr if unknown
+    Item* split(Item* item, uint64_t offset);            // item keeps [0, offset), returns the rest
+    std::pair<Item*, uint64_t> at(uint64_t pos) const;   // run & offset of the visible character at pos
+    uint64_t position(const Item* item) const;           // visible characters before the run
+    static Item* successor(Item* item);
+
+    void insert_after(Item* item, Item* added);
+    void rotate_up(Item* item);
+    void update_path(Item* item);
+    static void update(Item* item);
+    static uint64_t visible(const Item* item)
+    {
+        return item ? item->visible : 0;
+    }
+};
+
+#endif // SEQUENCE_CRDT_HPP
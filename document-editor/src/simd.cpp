@@ -0,0 +1,29 @@
+#include "simd_intrinsics.hpp"
+
+namespace
+{
+#if defined(DOCUMENT_SIMD_X86)
+    bool cpu_supports_avx2()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        const bool os_saves_ymm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+        __cpuidex(info, 7, 0);
+        return os_saves_ymm && (info[1] & (1 << 5));
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+} // namespace
+
+SimdLevel detect_simd_level()
+{
+#if defined(DOCUMENT_SIMD_X86)
+    static const SimdLevel level = cpu_supports_avx2() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
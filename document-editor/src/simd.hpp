@@ -0,0 +1,14 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+enum class SimdLevel
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// best instruction set supported by the CPU - kernels clamp a requested level to it
+SimdLevel detect_simd_level();
+
+#endif // SIMD_HPP
@@ -0,0 +1,19 @@
+#ifndef SIMD_INTRINSICS_HPP
+#define SIMD_INTRINSICS_HPP
+
+// included only by translation units implementing SIMD kernels
+
+#include "simd.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DOCUMENT_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define DOCUMENT_TARGET_AVX2
+#else
+#define DOCUMENT_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#endif // SIMD_INTRINSICS_HPP
@@ -0,0 +1,205 @@
+#include "suffix_index.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    using Index = int32_t;
+
+    // short strings - comparison sort of the suffixes
+    std::vector<Index> sort_suffixes_naive(const std::vector<Index>& s)
+    {
+        const auto n = static_cast<Index>(s.size());
+
+        std::vector<Index> sa(n);
+        for (Index i = 0; i < n; ++i)
+            sa[i] = i;
+
+        std::sort(sa.begin(), sa.end(), [&s](Index l, Index r) {
+            return std::lexicographical_compare(s.begin() + l, s.end(), s.begin() + r, s.end());
+        });
+
+        return sa;
+    }
+
+    // SA-IS (Nong, Zhang & Chan) - symbols of s are in [0, upper]
+    //  - suffixes are classified as S-type (smaller than the next suffix) or L-type
+    //  - leftmost S-type positions (LMS) split s into substrings that are sorted by induced sorting
+    //  - if LMS substrings are not unique, their order is resolved recursively on the reduced string
+    //  - the sorted LMS suffixes induce the order of all the other suffixes
+    std::vector<Index> sa_is(const std::vector<Index>& s, Index upper)
+    {
+        const auto n = static_cast<Index>(s.size());
+
+        if (n < 16)
+            return sort_suffixes_naive(s);
+
+        std::vector<Index> sa(n);
+        std::vector<uint8_t> is_s(n); // the last suffix is L-type - a virtual sentinel follows it
+        for (Index i = n - 2; i >= 0; --i)
+            is_s[i] = (s[i] == s[i + 1]) ? is_s[i + 1] : (s[i] < s[i + 1]);
+
+        // bucket of every symbol: L-type suffixes come first, then S-type ones
+        std::vector<Index> l_bucket_start(upper + 2), s_bucket_start(upper + 1);
+        for (Index i = 0; i < n; ++i)
+        {
+            if (is_s[i])
+                ++l_bucket_start[s[i] + 1];
+            else
+                ++s_bucket_start[s[i]];
+        }
+        for (Index c = 0; c <= upper; ++c)
+        {
+            s_bucket_start[c] += l_bucket_start[c];
+            l_bucket_start[c + 1] += s_bucket_start[c];
+        }
+
+        const auto induce = [&](const std::vector<Index>& lms) {
+            std::fill(sa.begin(), sa.end(), -1);
+            std::vector<Index> bucket(upper + 2);
+
+            std::copy(s_bucket_start.begin(), s_bucket_start.end(), bucket.begin());
+            for (Index pos : lms)
+                sa[bucket[s[pos]]++] = pos;
+
+            std::copy(l_bucket_start.begin(), l_bucket_start.end(), bucket.begin());
+            sa[bucket[s[n - 1]]++] = n - 1;
+            for (Index i = 0; i < n; ++i)
+            {
+                const Index pos = sa[i];
+                if (pos >= 1 && !is_s[pos - 1])
+                    sa[bucket[s[pos - 1]]++] = pos - 1;
+            }
+
+            std::copy(l_bucket_start.begin(), l_bucket_start.end(), bucket.begin());
+            for (Index i = n - 1; i >= 0; --i)
+            {
+                const Index pos = sa[i];
+                if (pos >= 1 && is_s[pos - 1])
+                    sa[--bucket[s[pos - 1] + 1]] = pos - 1;
+            }
+        };
+
+        std::vector<Index> lms_number(n, -1);
+        std::vector<Index> lms;
+        for (Index i = 1; i < n; ++i)
+        {
+            if (!is_s[i - 1] && is_s[i])
+            {
+                lms_number[i] = static_cast<Index>(lms.size());
+                lms.push_back(i);
+            }
+        }
+
+        induce(lms);
+
+        if (lms.empty())
+            return sa;
+
+        const auto m = static_cast<Index>(lms.size());
+
+        std::vector<Index> sorted_lms;
+        sorted_lms.reserve(m);
+        for (Index pos : sa)
+            if (lms_number[pos] != -1)
+                sorted_lms.push_back(pos);
+
+        // names of LMS substrings - equal substrings get equal names
+        std::vector<Index> reduced(m);
+        Index reduced_upper = 0;
+        reduced[lms_number[sorted_lms[0]]] = 0;
+        for (Index i = 1; i < m; ++i)
+        {
+            Index l = sorted_lms[i - 1], r = sorted_lms[i];
+            const Index end_l = (lms_number[l] + 1 < m) ? lms[lms_number[l] + 1] : n;
+            const Index end_r = (lms_number[r] + 1 < m) ? lms[lms_number[r] + 1] : n;
+
+            bool same = (end_l - l == end_r - r);
+            if (same)
+            {
+                while (l < end_l && s[l] == s[r])
+                {
+                    ++l;
+                    ++r;
+                }
+                if (l == n || s[l] != s[r])
+                    same = false;
+            }
+
+            if (!same)
+                ++reduced_upper;
+            reduced[lms_number[sorted_lms[i]]] = reduced_upper;
+        }
+
+        const std::vector<Index> reduced_sa = sa_is(reduced, reduced_upper);
+
+        for (Index i = 0; i < m; ++i)
+            sorted_lms[i] = lms[reduced_sa[i]];
+
+        induce(sorted_lms);
+
+        return sa;
+    }
+} // namespace
+
+SuffixIndex::SuffixIndex(const Rope& text)
+    : text_{text.str()}
+{
+    if (text_.size() > static_cast<size_t>(std::numeric_limits<Index>::max()))
+        throw std::length_error("SuffixIndex - text longer than 2 GiB");
+
+    std::vector<Index> symbols(text_.begin(), text_.end());
+    for (Index& symbol : symbols)
+        symbol &= 0xFF; // bytes as unsigned symbols
+
+    suffixes_ = sa_is(symbols, 255);
+}
+
+std::pair<size_t, size_t> SuffixIndex::equal_range(std::string_view pattern) const
+{
+    const std::string_view text{text_};
+
+    // compares only the first pattern.size() bytes - all suffixes starting with pattern are equivalent
+    const auto prefix_of = [&text, m = pattern.size()](Index pos) { return text.substr(pos, m); };
+
+    const auto first = std::lower_bound(suffixes_.begin(), suffixes_.end(), pattern,
+        [&](Index pos, std::string_view p) { return prefix_of(pos) < p; });
+    const auto last = std::upper_bound(first, suffixes_.end(), pattern,
+        [&](std::string_view p, Index pos) { return p < prefix_of(pos); });
+
+    return {static_cast<size_t>(first - suffixes_.begin()), static_cast<size_t>(last - suffixes_.begin())};
+}
+
+size_t SuffixIndex::count(std::string_view pattern) const
+{
+    const auto [first, last] = equal_range(pattern);
+
+    return last - first;
+}
+
+std::vector<size_t> SuffixIndex::occurrences(std::string_view pattern) const
+{
+    const auto [first, last] = equal_range(pattern);
+
+    std::vector<size_t> result(suffixes_.begin() + first, suffixes_.begin() + last);
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+size_t SuffixIndex::find(std::string_view pattern, size_t from) const
+{
+    const auto [first, last] = equal_range(pattern);
+
+    size_t result = std::string::npos;
+    for (size_t i = first; i < last; ++i)
+    {
+        const auto pos = static_cast<size_t>(suffixes_[i]);
+        if (pos >= from && pos < result)
+            result = pos;
+    }
+
+    return result;
+}
@@ -0,0 +1,53 @@
+#ifndef SUFFIX_INDEX_HPP
+#define SUFFIX_INDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "rope.hpp"
+
+// Full-text index - suffix array of a flattened copy of the text built with SA-IS in O(n).
+// Occurrences of a pattern form a contiguous range of the suffix array found by two binary
+// searches in O(m log n). Texts up to 2 GiB are supported (32-bit suffix positions).
+class SuffixIndex
+{
+    std::string text_;
+    std::vector<int32_t> suffixes_;
+
+public:
+    explicit SuffixIndex(const Rope& text);
+
+    size_t size() const
+    {
+        return text_.size();
+    }
+
+    // range [first, last) of the suffix array holding suffixes starting with pattern
+    std::pair<size_t, size_t> equal_range(std::string_view pattern) const;
+
+    // all (possibly overlapping) occurrences - O(m log n)
+    size_t count(std::string_view pattern) const;
+
+    // all (possibly overlapping) occurrences in increasing order
+    std::vector<size_t> occurrences(std::string_view pattern) const;
+
+    // first occurrence at or after from, std::string::npos if there is none - one pass over the
+    // range of the suffix array, nothing is copied or sorted
+    size_t find(std::string_view pattern, size_t from = 0) const;
+
+    // bytes held by the copy of the text and the suffix array
+    size_t memory_usage() const
+    {
+        return text_.capacity() + suffixes_.capacity() * sizeof(int32_t);
+    }
+
+    const std::vector<int32_t>& suffixes() const
+    {
+        return suffixes_;
+    }
+};
+
+#endif // SUFFIX_INDEX_HPP
@@ -0,0 +1,102 @@
+#include "text_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#include "simd_intrinsics.hpp"
+
+namespace
+{
+    bool is_space(char c)
+    {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    // counts from text[first, size) - previous_space tells whether the byte before first is whitespace
+    void count_scalar(std::string_view text, size_t first, bool previous_space, size_t& newlines, size_t& words)
+    {
+        for (size_t i = first; i < text.size(); ++i)
+        {
+            const bool space = is_space(text[i]);
+            newlines += (text[i] == '\n');
+            words += (!space && previous_space);
+            previous_space = space;
+        }
+    }
+
+#if defined(DOCUMENT_SIMD_X86)
+    // whitespace bytes become bits of a mask - a word starts at every non-space bit preceded by a space bit.
+    // Signed byte comparisons - bytes >= 0x80 are negative and never fall into the \t..\r range.
+    size_t count_sse2(std::string_view text, bool& previous_space, size_t& newlines, size_t& words)
+    {
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i lower_bound = _mm_set1_epi8('\t' - 1);
+        const __m128i upper_bound = _mm_set1_epi8('\r' + 1);
+
+        size_t i = 0;
+        for (; i + 16 <= text.size(); i += 16)
+        {
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+            const __m128i is_control_space = _mm_and_si128(_mm_cmpgt_epi8(c, lower_bound), _mm_cmpgt_epi8(upper_bound, c));
+            const auto spaces = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(c, space), is_control_space)));
+            const auto newline_bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(c, newline)));
+
+            const uint32_t preceded_by_space = (spaces << 1) | (previous_space ? 1u : 0u);
+            words += std::popcount(~spaces & preceded_by_space & 0xFFFFu);
+            newlines += std::popcount(newline_bits);
+            previous_space = (spaces >> 15) & 1;
+        }
+
+        return i;
+    }
+
+    DOCUMENT_TARGET_AVX2 size_t count_avx2(std::string_view text, bool& previous_space, size_t& newlines, size_t& words)
+    {
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i newline = _mm256_set1_epi8('\n');
+        const __m256i lower_bound = _mm256_set1_epi8('\t' - 1);
+        const __m256i upper_bound = _mm256_set1_epi8('\r' + 1);
+
+        size_t i = 0;
+        for (; i + 32 <= text.size(); i += 32)
+        {
+            const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + i));
+            const __m256i is_control_space = _mm256_and_si256(_mm256_cmpgt_epi8(c, lower_bound), _mm256_cmpgt_epi8(upper_bound, c));
+            const auto spaces = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(c, space), is_control_space)));
+            const auto newline_bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, newline)));
+
+            const uint32_t preceded_by_space = (spaces << 1) | (previous_space ? 1u : 0u);
+            words += std::popcount(~spaces & preceded_by_space);
+            newlines += std::popcount(newline_bits);
+            previous_space = spaces >> 31;
+        }
+
+        return i;
+    }
+#endif
+} // namespace
+
+TextStats count_text_stats(std::string_view text, SimdLevel level)
+{
+    level = std::min(level, detect_simd_level());
+
+    TextStats stats;
+    bool previous_space = true; // a word at the start of the text is counted
+    size_t done = 0;
+
+#if defined(DOCUMENT_SIMD_X86)
+    if (level == SimdLevel::AVX2)
+        done = count_avx2(text, previous_space, stats.newlines, stats.words);
+    else if (level == SimdLevel::SSE2)
+        done = count_sse2(text, previous_space, stats.newlines, stats.words);
+#endif
+
+    count_scalar(text, done, previous_space, stats.newlines, stats.words);
+
+    stats.starts_in_word = !text.empty() && !is_space(text.front());
+    stats.ends_in_word = !text.empty() && !is_space(text.back());
+
+    return stats;
+}
@@ -0,0 +1,30 @@
+#ifndef TEXT_STATS_HPP
+#define TEXT_STATS_HPP
+
+#include <cstddef>
+#include <string_view>
+
+#include "simd.hpp"
+
+// Counts of a non-empty piece of text. Stats of adjacent pieces combine without reading the text
+// again, so a tree of chunks keeps them per node. Words are maximal runs of bytes other than ASCII
+// whitespace (space, \t \n \v \f \r) - UTF-8 multi-byte sequences are parts of words.
+struct TextStats
+{
+    size_t newlines = 0;
+    size_t words = 0;
+    bool starts_in_word = false; // the first byte is not whitespace
+    bool ends_in_word = false;   // the last byte is not whitespace
+
+    // stats of left followed by right - a word spanning the boundary is counted once
+    friend TextStats operator+(const TextStats& left, const TextStats& right)
+    {
+        return {left.newlines + right.newlines, left.words + right.words - ((left.ends_in_word && right.starts_in_word) ? 1 : 0),
+            left.starts_in_word, right.ends_in_word};
+    }
+};
+
+// Classifies 32 (AVX2) or 16 (SSE2) bytes at a time.
+TextStats count_text_stats(std::string_view text, SimdLevel level = detect_simd_level());
+
+#endif // TEXT_STATS_HPP
@@ -0,0 +1,80 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class ThreadPool
+{
+    std::queue<std::function<void()>> tasks_;
+    std::mutex tasks_mtx_;
+    std::condition_variable_any tasks_cv_;
+    std::vector<std::jthread> threads_;
+
+public:
+    explicit ThreadPool(size_t size = std::max(1u, std::thread::hardware_concurrency()))
+    {
+        for (size_t i = 0; i < size; ++i)
+            threads_.emplace_back([this](std::stop_token stop_token) { run(stop_token); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        for (auto& thd : threads_)
+            thd.request_stop();
+    } // threads are joined - tasks that were not started are dropped
+
+    size_t size() const
+    {
+        return threads_.size();
+    }
+
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F f)
+    {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::move(f));
+        auto result = task->get_future();
+
+        {
+            std::lock_guard lk{tasks_mtx_};
+            tasks_.push([task] { (*task)(); });
+        }
+        tasks_cv_.notify_one();
+
+        return result;
+    }
+
+private:
+    void run(std::stop_token stop_token)
+    {
+        while (true)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock lk{tasks_mtx_};
+                if (!tasks_cv_.wait(lk, stop_token, [this] { return !tasks_.empty(); }))
+                    return;
+
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+
+            task();
+        }
+    }
+};
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,156 @@
+#include "undo_history.hpp"
+
+#include <algorithm>
+
+UndoHistory::UndoHistory(Document& doc, size_t byte_budget, size_t uncompressed_entries)
+    : doc_{doc}
+    , byte_budget_{byte_budget}
+    , uncompressed_entries_{uncompressed_entries}
+{
+}
+
+void UndoHistory::checkpoint()
+{
+    for (const Entry& entry : redo_)
+        remove(entry);
+    redo_.clear();
+
+    undo_.push_back(add(doc_.create_delta_memento()));
+
+    if (undo_.size() > uncompressed_entries_)
+        compress(undo_[undo_.size() - 1 - uncompressed_entries_]);
+
+    enforce_budget();
+}
+
+bool UndoHistory::undo()
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    Document::Memento current = doc_.create_delta_memento();
+
+    // checkpoints of commands that did not change the text
+    while (!undo_.empty() && undo_.back().memento.same_revision(current))
+    {
+        remove(undo_.back());
+        undo_.pop_back();
+    }
+
+    if (undo_.empty())
+        return false;
+
+    doc_.set_memento(undo_.back().memento);
+
+    remove(undo_.back());
+    undo_.pop_back();
+    redo_.push_back(add(std::move(current)));
+
+    if (redo_.size() > uncompressed_entries_)
+        compress(redo_[redo_.size() - 1 - uncompressed_entries_]);
+
+    enforce_budget();
+
+    const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    if (undo_latencies_.size() < latency_samples)
+        undo_latencies_.push_back(latency);
+    else
+        undo_latencies_[next_latency_] = latency;
+    next_latency_ = (next_latency_ + 1) % latency_samples;
+
+    return true;
+}
+
+bool UndoHistory::redo()
+{
+    if (redo_.empty())
+        return false;
+
+    undo_.push_back(add(doc_.create_delta_memento()));
+
+    doc_.set_memento(redo_.back().memento);
+
+    remove(redo_.back());
+    redo_.pop_back();
+
+    enforce_budget();
+
+    return true;
+}
+
+void UndoHistory::clear()
+{
+    undo_.clear();
+    redo_.clear();
+    bytes_used_ = 0;
+    uncompressed_bytes_ = 0;
+
+    doc_.truncate_history();
+}
+
+UndoHistoryStats UndoHistory::stats() const
+{
+    UndoHistoryStats stats{};
+    stats.entries = undo_.size() + redo_.size();
+    stats.bytes_used = bytes_used_;
+    stats.uncompressed_bytes = uncompressed_bytes_;
+    stats.compression_ratio = (bytes_used_ > 0) ? static_cast<double>(uncompressed_bytes_) / bytes_used_ : 1.0;
+
+    if (!undo_latencies_.empty())
+    {
+        std::vector<std::chrono::nanoseconds> latencies = undo_latencies_;
+        const auto percentile = [&latencies](size_t percent) {
+            auto nth = latencies.begin() + (latencies.size() - 1) * percent / 100;
+            std::nth_element(latencies.begin(), nth, latencies.end());
+            return *nth;
+        };
+
+        stats.undo_p50 = percentile(50);
+        stats.undo_p90 = percentile(90);
+        stats.undo_p99 = percentile(99);
+    }
+
+    return stats;
+}
+
+UndoHistory::Entry UndoHistory::add(Document::Memento memento)
+{
+    Entry entry{std::move(memento), 0, 0};
+    entry.bytes = entry.memento.memory_usage();
+    entry.uncompressed_bytes = entry.memento.uncompressed_size();
+
+    bytes_used_ += entry.bytes;
+    uncompressed_bytes_ += entry.uncompressed_bytes;
+
+    return entry;
+}
+
+void UndoHistory::remove(const Entry& entry)
+{
+    bytes_used_ -= entry.bytes;
+    uncompressed_bytes_ -= entry.uncompressed_bytes;
+}
+
+void UndoHistory::compress(Entry& entry)
+{
+    remove(entry);
+    entry.memento.compress();
+    entry = add(std::move(entry.memento));
+}
+
+void UndoHistory::enforce_budget()
+{
+    if (bytes_used_ <= byte_budget_ || undo_.empty())
+        return;
+
+    while (bytes_used_ > byte_budget_ && !undo_.empty())
+    {
+        remove(undo_.front());
+        undo_.pop_front();
+    }
+
+    // revisions before the oldest state still reachable by undo are freed - redo entries descend from the current one
+    if (!undo_.empty())
+        doc_.truncate_history(undo_.front().memento);
+    else
+        doc_.truncate_history();
+}
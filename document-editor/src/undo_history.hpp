@@ -0,0 +1,89 @@
+#ifndef UNDO_HISTORY_HPP
+#define UNDO_HISTORY_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "document.hpp"
+
+struct UndoHistoryStats
+{
+    size_t entries;            // undo & redo entries held
+    size_t bytes_used;         // text removed by the recorded edits - compressed where it is
+    size_t uncompressed_bytes; // bytes_used with nothing compressed
+    double compression_ratio;  // uncompressed_bytes / bytes_used
+    std::chrono::nanoseconds undo_p50;
+    std::chrono::nanoseconds undo_p90;
+    std::chrono::nanoseconds undo_p99;
+};
+
+// Undo & redo stacks of delta mementos (undo only travels the history of the document, so keyframes
+// would be dead weight) kept within a byte budget - the edits of all but the newest entries are
+// compressed, the oldest entries are dropped (and the history of the document before them freed)
+// when the budget is exceeded.
+class UndoHistory
+{
+    // sizes as counted when the entry was added or compressed - another entry of the same revision may
+    // compress it later
+    struct Entry
+    {
+        Document::Memento memento;
+        size_t bytes;
+        size_t uncompressed_bytes;
+    };
+
+    Document& doc_;
+    size_t byte_budget_;
+    size_t uncompressed_entries_;
+
+    std::deque<Entry> undo_; // oldest first
+    std::vector<Entry> redo_;
+    size_t bytes_used_ = 0;
+    size_t uncompressed_bytes_ = 0;
+
+    std::vector<std::chrono::nanoseconds> undo_latencies_; // ring of the latest samples
+    size_t next_latency_ = 0;
+
+public:
+    static constexpr size_t default_byte_budget = 64 * 1024 * 1024;
+    static constexpr size_t default_uncompressed_entries = 8;
+    static constexpr size_t latency_samples = 1024;
+
+    explicit UndoHistory(Document& doc, size_t byte_budget = default_byte_budget,
+        size_t uncompressed_entries = default_uncompressed_entries);
+
+    // records the current state - call before an edit, the redo entries are dropped
+    void checkpoint();
+
+    // false if there is nothing to undo
+    bool undo();
+
+    // false if there is nothing to redo
+    bool redo();
+
+    // drops the undo & redo entries and the history of the document before now - e.g. once edits of
+    // other editors are merged into it, undo must not revert them
+    void clear();
+
+    bool can_undo() const
+    {
+        return !undo_.empty();
+    }
+
+    bool can_redo() const
+    {
+        return !redo_.empty();
+    }
+
+    UndoHistoryStats stats() const;
+
+private:
+    Entry add(Document::Memento memento);
+    void remove(const Entry& entry);
+    void compress(Entry& entry);
+    void enforce_budget();
+};
+
+#endif // UNDO_HISTORY_HPP
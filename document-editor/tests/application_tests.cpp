@@ -1,6 +1,14 @@
+#include <array>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include "application.hpp"
 #include "document.hpp"
 #include "mocks/mocks.hpp"
 
@@ -10,4 +18,232 @@ using namespace std::literals;
 TEST(ApplicationTests, TODO)
 {
     //FAIL();
-}
\ No newline at end of file
+}
+
+struct Application_Running : Test
+{
+    NiceMock<MockConsole> console;
+    Document doc;
+    SharedClipboard clipboard;
+    Application app{console};
+
+    Application_Running()
+    {
+        add_editor_commands(app, doc, clipboard);
+        EXPECT_CALL(console, print(StartsWith("Enter "))).Times(AnyNumber());
+    }
+};
+
+TEST_F(Application_Running, ExecutesCommandsUntilExit)
+{
+    EXPECT_CALL(console, get_line())
+        .WillOnce(Return("AddText"))
+        .WillOnce(Return("abc"))
+        .WillOnce(Return("ToUpper"))
+        .WillOnce(Return("Print"))
+        .WillOnce(Return("Exit"));
+    EXPECT_CALL(console, print("[ABC]"));
+
+    ASSERT_THAT(app.run(), Eq(3));
+}
+
+TEST_F(Application_Running, ReportsUnknownCommand)
+{
+    EXPECT_CALL(console, get_line()).WillOnce(Return("Dance")).WillOnce(Return("Exit"));
+    EXPECT_CALL(console, print("Unknown command: Dance"));
+
+    app.run();
+}
+
+TEST_F(Application_Running, FlushesConsoleAtExit)
+{
+    EXPECT_CALL(console, get_line()).WillOnce(Return("Exit"));
+    EXPECT_CALL(console, flush());
+
+    app.run();
+}
+
+TEST_F(Application_Running, RejectsCommandNamesOutsideTable)
+{
+    ASSERT_THROW(app.add_command("Dance", std::make_shared<ClearCmd>(doc)), std::invalid_argument);
+}
+
+TEST(ApplicationTests, IgnoresKnownNameWithoutCommand)
+{
+    NiceMock<MockConsole> console;
+    Application app{console};
+
+    ASSERT_FALSE(app.execute("Print"));
+}
+
+TEST_F(Application_Running, PlaysRecordedMacro)
+{
+    EXPECT_CALL(console, get_line())
+        .WillOnce(Return("Record"))
+        .WillOnce(Return("AddText"))
+        .WillOnce(Return("ab"))
+        .WillOnce(Return("ToUpper"))
+        .WillOnce(Return("Stop"))
+        .WillOnce(Return("Play"))
+        .WillOnce(Return("2"))
+        .WillOnce(Return("Print"))
+        .WillOnce(Return("Exit"));
+    EXPECT_CALL(console, print("[ABABAB]"));
+
+    app.run();
+
+    ASSERT_THAT(app.macro().instructions().size(), Eq(2));
+}
+
+TEST_F(Application_Running, MacroKeepsCommandsReplacedAfterRecording)
+{
+    EXPECT_CALL(console, get_line()).WillOnce(Return("ab"));
+    app.execute("Record");
+    app.execute("AddText");
+    app.execute("Stop");
+
+    app.add_command("AddText", std::make_shared<ClearCmd>(doc));
+    app.play(2);
+
+    ASSERT_THAT(doc.text(), StrEq("ababab"));
+}
+
+TEST_F(Application_Running, CaptureEndsWhenRecordedCommandThrows)
+{
+    EXPECT_CALL(console, get_line()).WillOnce(Return("a")).WillOnce(Throw(EndOfInput{})).WillOnce(Return("later"));
+    app.execute("Record");
+
+    ASSERT_THROW(app.execute("ReplaceAll"), EndOfInput);
+
+    app.console().get_line();
+    ASSERT_THAT(static_cast<MacroConsole&>(app.console()).stop_capture(), IsEmpty());
+}
+
+TEST_F(Application_Running, ReportsInvalidRepeatCount)
+{
+    EXPECT_CALL(console, get_line()).WillOnce(Return("Play")).WillOnce(Return("twice")).WillOnce(Return("Exit"));
+    EXPECT_CALL(console, print("Error: invalid repeat count twice"));
+
+    app.run();
+}
+
+TEST_F(Application_Running, RejectsBuiltInCommandNames)
+{
+    ASSERT_THROW(app.add_command(Application::cmd_play, std::make_shared<ClearCmd>(doc)), std::invalid_argument);
+}
+
+namespace
+{
+    struct ShoutingCommands
+    {
+        static constexpr std::array<std::string_view, 2> names = {"Append", "Shout"};
+        static constexpr std::string_view append_command = "Append";
+    };
+} // namespace
+
+TEST(Application_OwnCommandSet, DispatchesOnlyItsCommands)
+{
+    NiceMock<MockConsole> console;
+    Document doc;
+    BasicApplication<ShoutingCommands> app{console};
+    app.add_command("Append", std::make_shared<AddTextCmd>(doc, app.console()));
+    app.add_command("Shout", std::make_shared<ToUpperCmd>(doc));
+
+    ASSERT_THROW(app.add_command("AddText", std::make_shared<ClearCmd>(doc)), std::invalid_argument);
+
+    EXPECT_CALL(console, get_line())
+        .WillOnce(Return("Record"))
+        .WillOnce(Return("Append")).WillOnce(Return("a"))
+        .WillOnce(Return("Append")).WillOnce(Return("b"))
+        .WillOnce(Return("Stop"))
+        .WillOnce(Return("Shout"))
+        .WillOnce(Return("Exit"));
+    app.run();
+
+    ASSERT_THAT(doc.text(), StrEq("AB"));
+    ASSERT_THAT(app.macro().instructions(), SizeIs(1)); // the appends are merged
+}
+
+TEST_F(Application_Running, UndoesEditingCommands)
+{
+    UndoHistory history{doc};
+    add_history_commands(app, history);
+    EXPECT_CALL(console, get_line())
+        .WillOnce(Return("AddText"))
+        .WillOnce(Return("abc"))
+        .WillOnce(Return("ToUpper"))
+        .WillOnce(Return("Undo"))
+        .WillOnce(Return("Print"))
+        .WillOnce(Return("Redo"))
+        .WillOnce(Return("Print"))
+        .WillOnce(Return("Exit"));
+    EXPECT_CALL(console, print("[abc]"));
+    EXPECT_CALL(console, print("[ABC]"));
+
+    app.run();
+}
+
+TEST(Application_Interactive, ReturnsAtEndOfStandardInput)
+{
+    std::istringstream in{"AddText\nabc\nPrint\n"};
+    std::ostringstream out;
+    std::streambuf* const cin_buffer = std::cin.rdbuf(in.rdbuf());
+    std::streambuf* const cout_buffer = std::cout.rdbuf(out.rdbuf());
+
+    Terminal terminal;
+    Document doc;
+    SharedClipboard clipboard;
+    Application app{terminal};
+    add_editor_commands(app, doc, clipboard);
+    const size_t executed = app.run();
+
+    std::cin.rdbuf(cin_buffer);
+    std::cout.rdbuf(cout_buffer);
+    std::cin.clear();
+
+    ASSERT_THAT(executed, Eq(2));
+    ASSERT_THAT(out.str(), HasSubstr("[abc]\n"));
+}
+
+TEST(Application_Console, ReadsCommandNamesWithGetCommand)
+{
+    // arguments from get_line(), names from get_command()
+    struct SplitConsole : Console
+    {
+        std::vector<std::string> arguments{"abc"};
+        std::vector<std::string> commands{"AddText", "Print", "Exit"};
+        std::vector<std::string> printed;
+
+        std::string get_line() override
+        {
+            return take(arguments);
+        }
+
+        std::string get_command() override
+        {
+            return take(commands);
+        }
+
+        void print(const std::string& line) override
+        {
+            printed.push_back(line);
+        }
+
+        static std::string take(std::vector<std::string>& lines)
+        {
+            if (lines.empty())
+                throw EndOfInput{};
+
+            std::string line = lines.front();
+            lines.erase(lines.begin());
+            return line;
+        }
+    } console;
+    Document doc;
+    SharedClipboard clipboard;
+    Application app{console};
+    add_editor_commands(app, doc, clipboard);
+
+    ASSERT_THAT(app.run(), Eq(2));
+    ASSERT_THAT(console.printed, Contains("[abc]"));
+}
@@ -0,0 +1,251 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "autosave.hpp"
+#include "temp_path.hpp"
+
+using namespace ::testing;
+
+struct Autosave_Session : Test
+{
+    std::filesystem::path path = test_temp_path(".autosave");
+
+    Autosave_Session()
+    {
+        remove_files();
+    }
+
+    ~Autosave_Session() override
+    {
+        remove_files();
+    }
+
+    void remove_files()
+    {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+        std::filesystem::remove(Autosave::lock_path(path), ignored);
+        for (const auto& segment : Journal::segments(Autosave::journal_base(path)))
+            std::filesystem::remove(segment, ignored);
+    }
+};
+
+TEST_F(Autosave_Session, FirstSessionStartsEmpty)
+{
+    Document doc;
+    Autosave autosave{doc, path};
+
+    ASSERT_FALSE(autosave.recovered().snapshot_loaded);
+    ASSERT_THAT(autosave.recovered().replayed_edits, Eq(0u));
+    ASSERT_TRUE(std::filesystem::exists(path));
+}
+
+TEST_F(Autosave_Session, RecoversEditsOfPreviousSession)
+{
+    {
+        Document doc;
+        Autosave autosave{doc, path};
+        doc.add_text("hello world");
+        doc.erase(5, 6);
+        doc.insert(0, ">> ");
+    }
+
+    Document doc;
+    Autosave autosave{doc, path};
+
+    ASSERT_THAT(doc.text(), StrEq(">> hello"));
+    ASSERT_TRUE(autosave.recovered().snapshot_loaded);
+    ASSERT_THAT(autosave.recovered().replayed_edits, Eq(3u));
+}
+
+TEST_F(Autosave_Session, ReplaysOnlyEditsAfterTheSnapshot)
+{
+    {
+        Document doc;
+        Autosave autosave{doc, path};
+        doc.add_text("abc");
+        autosave.snapshot_now();
+        doc.add_text("def");
+    }
+
+    Document doc;
+    Autosave autosave{doc, path};
+
+    ASSERT_THAT(doc.text(), StrEq("abcdef"));
+    ASSERT_THAT(autosave.recovered().replayed_edits, Eq(1u));
+}
+
+TEST_F(Autosave_Session, RecoversUndoneEdits)
+{
+    {
+        Document doc;
+        Autosave autosave{doc, path};
+        doc.add_text("abc");
+        auto memento = doc.create_memento();
+        doc.to_upper();
+        doc.set_memento(memento);
+    }
+
+    Document doc;
+    Autosave autosave{doc, path};
+
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(Autosave_Session, RecoversFromSnapshotAndJournalLeftByCrash)
+{
+    // files of a session that never shut down: a snapshot & journal records written after it
+    {
+        Document doc{"base text"};
+        Autosave autosave{doc, path};
+    }
+    {
+        Journal journal{Autosave::journal_base(path)};
+        journal.append(1, 0, 4, Rope{"new"});
+        journal.append(2, 8, 0, Rope{"!"});
+    }
+
+    Document doc;
+    Autosave autosave{doc, path};
+
+    ASSERT_THAT(doc.text(), StrEq("new text!"));
+    ASSERT_THAT(autosave.recovered().snapshot_version, Eq(0u));
+    ASSERT_THAT(autosave.recovered().replayed_edits, Eq(2u));
+}
+
+TEST_F(Autosave_Session, JournalKeptByCrashDuringRecoveryIsNotReplayedAgain)
+{
+    {
+        Document doc{"base"};
+        Autosave autosave{doc, path};
+    }
+    {
+        Journal journal{Autosave::journal_base(path)};
+        journal.append(1, 4, 0, Rope{"!"});
+    }
+    {
+        Document doc;
+        Autosave autosave{doc, path};
+    }
+    {
+        // the recovered record again - as if the crash came before the old journal was deleted
+        Journal journal{Autosave::journal_base(path)};
+        journal.append(1, 4, 0, Rope{"!"});
+    }
+
+    Document doc;
+    Autosave autosave{doc, path};
+
+    ASSERT_THAT(doc.text(), StrEq("base!"));
+    ASSERT_THAT(autosave.recovered().replayed_edits, Eq(0u));
+}
+
+TEST_F(Autosave_Session, JournalRecordThatDoesNotFitStopsReplay)
+{
+    {
+        Document doc;
+        Autosave autosave{doc, path};
+    }
+    {
+        Journal journal{Autosave::journal_base(path)};
+        journal.append(1, 0, 0, Rope{"ok"});
+        journal.append(2, 100, 0, Rope{"out of range"});
+        journal.append(3, 0, 0, Rope{"after"});
+    }
+
+    Document doc;
+    Autosave autosave{doc, path};
+
+    ASSERT_THAT(doc.text(), StrEq("ok"));
+    ASSERT_THAT(autosave.recovered().replayed_edits, Eq(1u));
+}
+
+TEST_F(Autosave_Session, SecondSessionOnTheSameFilesIsRefused)
+{
+    {
+        Document doc{"first session"};
+        Autosave autosave{doc, path};
+
+        Document other;
+        ASSERT_THROW((Autosave{other, path}), std::system_error);
+        ASSERT_THAT(other.text(), IsEmpty());
+    }
+
+    Document doc;
+    Autosave autosave{doc, path};
+
+    ASSERT_THAT(doc.text(), StrEq("first session"));
+}
+
+TEST_F(Autosave_Session, ForeignSnapshotThrows)
+{
+    std::ofstream{path} << "not a snapshot";
+
+    Document doc;
+
+    ASSERT_THROW((Autosave{doc, path}), std::runtime_error);
+}
+
+TEST_F(Autosave_Session, SnapshotDeletesCoveredJournal)
+{
+    Document doc;
+    Autosave autosave{doc, path};
+    doc.add_text("abc");
+    autosave.sync();
+
+    ASSERT_THAT(Journal::read(Autosave::journal_base(path)), SizeIs(1));
+
+    autosave.snapshot_now();
+
+    ASSERT_THAT(Journal::read(Autosave::journal_base(path)), IsEmpty());
+    ASSERT_THAT(autosave.stats().saved_version, Eq(doc.version()));
+}
+
+TEST_F(Autosave_Session, BackgroundThreadWritesSnapshots)
+{
+    Document doc;
+    Autosave autosave{doc, path, std::chrono::milliseconds{1}};
+    doc.add_text("abc");
+
+    for (int i = 0; i < 5000 && autosave.stats().saved_version != doc.version(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+    ASSERT_THAT(autosave.stats().saved_version, Eq(doc.version()));
+    ASSERT_THAT(autosave.stats().snapshot_errors, Eq(0u));
+}
+
+TEST_F(Autosave_Session, LargeInsertTriggersSnapshot)
+{
+    Document doc;
+    Autosave autosave{doc, path, std::chrono::hours{1}};
+    doc.add_text(std::string(Autosave::snapshot_insert_size, 'x'));
+
+    for (int i = 0; i < 5000 && autosave.stats().snapshots < 2; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+    ASSERT_THAT(autosave.stats().snapshots, Eq(2u));
+}
+
+TEST_F(Autosave_Session, CloseDeletesTheFiles)
+{
+    {
+        Document doc;
+        Autosave autosave{doc, path};
+        doc.add_text("abc");
+        autosave.close();
+    }
+
+    ASSERT_FALSE(std::filesystem::exists(path));
+    ASSERT_THAT(Journal::segments(Autosave::journal_base(path)), IsEmpty());
+
+    Document doc;
+    Autosave autosave{doc, path};
+
+    ASSERT_THAT(doc.text(), IsEmpty());
+    ASSERT_FALSE(autosave.recovered().snapshot_loaded);
+}
@@ -0,0 +1,93 @@
+#include <sstream>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "application.hpp"
+#include "batch_console.hpp"
+
+using namespace ::testing;
+
+TEST(BatchConsole, ReadsLinesThenThrowsAtEndOfInput)
+{
+    std::istringstream in{"first\nsecond\r\n\nlast"};
+    std::ostringstream out;
+    BatchConsole console{in, out};
+
+    ASSERT_THAT(console.get_line(), StrEq("first"));
+    ASSERT_THAT(console.get_line(), StrEq("second"));
+    ASSERT_THAT(console.get_line(), StrEq(""));
+    ASSERT_THAT(console.get_line(), StrEq("last"));
+    ASSERT_THROW(console.get_line(), EndOfInput);
+    ASSERT_THROW(console.get_line(), EndOfInput);
+}
+
+TEST(BatchConsole, ReadsLinesSpanningBlocks)
+{
+    std::string script;
+    for (int i = 0; script.size() < 3 * BatchConsole::block_size; ++i)
+        script += "line " + std::to_string(i) + "\n";
+    script += std::string(2 * BatchConsole::block_size, 'x') + "\n"; // longer than a block
+
+    std::istringstream in{script};
+    std::ostringstream out;
+    BatchConsole console{in, out};
+
+    std::string read;
+    while (read.size() < script.size())
+        read += console.get_line() + "\n";
+
+    ASSERT_TRUE(read == script);
+}
+
+TEST(BatchConsole, BuffersOutputUntilFlush)
+{
+    std::istringstream in;
+    std::ostringstream out;
+
+    {
+        BatchConsole console{in, out};
+        console.print("one");
+        console.print("two");
+
+        ASSERT_THAT(out.str(), IsEmpty());
+
+        console.flush();
+        ASSERT_THAT(out.str(), StrEq("one\ntwo\n"));
+
+        console.print("three");
+    }
+
+    ASSERT_THAT(out.str(), StrEq("one\ntwo\nthree\n"));
+}
+
+TEST(BatchConsole, RunsScriptThroughApplication)
+{
+    std::istringstream in{"AddText\nhello\nCopy\nPaste\nToUpper\nPrint\n"};
+    std::ostringstream out;
+    BatchConsole console{in, out};
+
+    Document doc;
+    SharedClipboard clipboard;
+    Application app{console};
+    add_editor_commands(app, doc, clipboard);
+
+    ASSERT_THAT(app.run(), Eq(5));
+    ASSERT_THAT(out.str(), HasSubstr("[HELLOHELLO]\n"));
+}
+
+TEST(BatchConsole, CommandWaitingForArgumentAtEndOfInputIsAborted)
+{
+    std::istringstream in{"AddText\nhello\nAddText\n"};
+    std::ostringstream out;
+    BatchConsole console{in, out};
+
+    Document doc;
+    SharedClipboard clipboard;
+    Application app{console};
+    add_editor_commands(app, doc, clipboard);
+
+    ASSERT_THAT(app.run(), Eq(1));
+    ASSERT_THAT(doc.text(), StrEq("hello"));
+}
@@ -0,0 +1,71 @@
+#include <random>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "case_conversion.hpp"
+
+using namespace ::testing;
+
+struct CaseConversion : TestWithParam<SimdLevel>
+{
+    std::string convert_to_upper(const std::string& text)
+    {
+        std::string result(text.size(), '\0');
+        ascii_to_upper(text, result.data(), GetParam());
+        return result;
+    }
+
+    std::string convert_to_lower(const std::string& text)
+    {
+        std::string result(text.size(), '\0');
+        ascii_to_lower(text, result.data(), GetParam());
+        return result;
+    }
+};
+
+TEST_P(CaseConversion, ConvertsAsciiLetters)
+{
+    const std::string text = "The quick brown fox jumps over the lazy dog - 0123456789 [@`{]";
+
+    ASSERT_THAT(convert_to_upper(text), StrEq("THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG - 0123456789 [@`{]"));
+    ASSERT_THAT(convert_to_lower(text), StrEq("the quick brown fox jumps over the lazy dog - 0123456789 [@`{]"));
+}
+
+TEST_P(CaseConversion, PassesUtf8SequencesThrough)
+{
+    const std::string text = "Zażółć gęślą jaźń - Ünïcödé ✓ 日本語 😀 Zażółć gęślą jaźń";
+
+    ASSERT_THAT(convert_to_upper(text), StrEq("ZAżółć GęśLą JAźń - ÜNïCöDé ✓ 日本語 😀 ZAżółć GęśLą JAźń"));
+    ASSERT_THAT(convert_to_lower(text), StrEq("zażółć gęślą jaźń - Ünïcödé ✓ 日本語 😀 zażółć gęślą jaźń"));
+}
+
+TEST_P(CaseConversion, MatchesScalarReferenceForAllBytes)
+{
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> byte_distr(0, 255);
+
+    std::string text(1'000 + 31, '\0');
+    for (char& c : text)
+        c = static_cast<char>(byte_distr(gen));
+
+    std::string expected_upper = text, expected_lower = text;
+    for (char& c : expected_upper)
+        c = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    for (char& c : expected_lower)
+        c = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+
+    ASSERT_THAT(convert_to_upper(text), Eq(expected_upper));
+    ASSERT_THAT(convert_to_lower(text), Eq(expected_lower));
+}
+
+TEST_P(CaseConversion, ConvertsInPlace)
+{
+    std::string text = "in place conversion of a text longer than one vector";
+    ascii_to_upper(text, text.data(), GetParam());
+
+    ASSERT_THAT(text, StrEq("IN PLACE CONVERSION OF A TEXT LONGER THAN ONE VECTOR"));
+}
+
+INSTANTIATE_TEST_SUITE_P(SimdLevels, CaseConversion, Values(SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2));
@@ -0,0 +1,98 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "clipboard.hpp"
+
+using namespace ::testing;
+
+TEST(SharedClipboard, IsEmptyAtStart)
+{
+    SharedClipboard clipboard;
+
+    ASSERT_THAT(clipboard.content(), NotNull());
+    ASSERT_THAT(*clipboard.content(), IsEmpty());
+}
+
+TEST(SharedClipboard, InstanceIsShared)
+{
+    ASSERT_THAT(&SharedClipboard::instance(), Eq(&SharedClipboard::instance()));
+}
+
+TEST(SharedClipboard, ReadersShareBufferWithoutCopy)
+{
+    SharedClipboard clipboard;
+    clipboard.set_content(std::string(1'000, 'x'));
+
+    auto first = clipboard.content();
+    auto second = clipboard.content();
+
+    ASSERT_THAT(first.get(), Eq(second.get()));
+}
+
+TEST(SharedClipboard, HandleIsNotAffectedByLaterWrites)
+{
+    SharedClipboard clipboard;
+    clipboard.set_content("old");
+
+    auto handle = clipboard.content();
+    clipboard.set_content("new");
+
+    ASSERT_THAT(*handle, StrEq("old"));
+    ASSERT_THAT(*clipboard.content(), StrEq("new"));
+}
+
+TEST(SharedClipboard, PublishesExistingBuffer)
+{
+    SharedClipboard clipboard;
+    auto buffer = std::make_shared<const std::string>("shared");
+
+    clipboard.set_content(buffer);
+
+    ASSERT_THAT(clipboard.content(), Eq(buffer));
+}
+
+TEST(SharedClipboard, ConcurrentReadersSeeCompleteBuffers)
+{
+    SharedClipboard clipboard;
+    clipboard.set_content(std::string(100, 'a'));
+    std::atomic<bool> torn_read = false;
+
+    {
+        std::vector<std::jthread> readers;
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.emplace_back([&] {
+                for (int j = 0; j < 10'000; ++j)
+                {
+                    auto content = clipboard.content();
+                    if (content->size() != 100 || content->find_first_not_of(content->front()) != std::string::npos)
+                        torn_read = true;
+                }
+            });
+        }
+
+        for (int j = 0; j < 1'000; ++j)
+            clipboard.set_content(std::string(100, static_cast<char>('a' + j % 26)));
+    }
+
+    ASSERT_FALSE(torn_read);
+}
+
+TEST(SharedClipboard, RopeSharesBuffer)
+{
+    SharedClipboard clipboard;
+    clipboard.set_content(std::string(3 * Rope::max_chunk_size, 'x'));
+
+    const auto buffer = clipboard.content();
+    const Rope rope = clipboard.content_rope();
+
+    ASSERT_THAT(rope.str(), StrEq(*buffer));
+    rope.for_each_chunk([&](std::string_view chunk) {
+        ASSERT_THAT(chunk.data(), AllOf(Ge(buffer->data()), Lt(buffer->data() + buffer->size())));
+    });
+}
@@ -0,0 +1,157 @@
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "collab_hub.hpp"
+#include "sequence_crdt.hpp"
+#include "temp_path.hpp"
+
+using namespace ::testing;
+
+struct CollabHub_Session : Test
+{
+    std::filesystem::path path = test_temp_path(".sock");
+    CollabHub hub{path};
+
+    // frames received by the client until it has count of them or a second has passed
+    static std::vector<std::string> receive(CollabClient& client, size_t count)
+    {
+        std::vector<std::string> frames;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+        while (frames.size() < count && std::chrono::steady_clock::now() < deadline)
+        {
+            for (std::string& frame : client.receive(std::chrono::milliseconds{10}))
+                frames.push_back(std::move(frame));
+        }
+
+        return frames;
+    }
+};
+
+TEST_F(CollabHub_Session, ClientsGetDistinctSites)
+{
+    CollabClient first{path};
+    CollabClient second{path};
+
+    ASSERT_THAT(first.site(), Ne(0u));
+    ASSERT_THAT(second.site(), Ne(first.site()));
+    ASSERT_THAT(hub.clients(), Eq(2u));
+}
+
+TEST_F(CollabHub_Session, FramesReachTheOtherClients)
+{
+    CollabClient sender{path};
+    CollabClient receiver{path};
+
+    sender.send("first");
+    sender.send(std::string(100'000, 'x'));
+
+    ASSERT_THAT(receive(receiver, 2), ElementsAre("first", std::string(100'000, 'x')));
+    ASSERT_THAT(sender.receive(std::chrono::milliseconds{10}), IsEmpty());
+}
+
+TEST_F(CollabHub_Session, LateClientGetsEarlierFrames)
+{
+    CollabClient early{path};
+    early.send("before");
+    CollabClient other{path};
+    ASSERT_THAT(receive(other, 1), ElementsAre("before"));
+
+    CollabClient late{path};
+
+    ASSERT_THAT(receive(late, 1), ElementsAre("before"));
+}
+
+TEST_F(CollabHub_Session, LateClientIsTurnedAwayOnceHistoryIsTooLong)
+{
+    CollabHub small_hub{path.string() + ".2", 100};
+    CollabClient sender{small_hub.path()};
+    CollabClient receiver{small_hub.path()};
+
+    sender.send(std::string(200, 'x'));
+    ASSERT_THAT(receive(receiver, 1), ElementsAre(std::string(200, 'x')));
+    ASSERT_FALSE(small_hub.joinable());
+
+    ASSERT_THROW(CollabClient{small_hub.path()}, std::runtime_error);
+
+    sender.send("after");
+    ASSERT_THAT(receive(receiver, 1), ElementsAre("after"));
+}
+
+TEST_F(CollabHub_Session, ClientSeesHubClosing)
+{
+    auto hub_on_heap = std::make_unique<CollabHub>(path.string() + ".2");
+    CollabClient client{hub_on_heap->path()};
+
+    hub_on_heap.reset();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+    while (client.connected() && std::chrono::steady_clock::now() < deadline)
+        client.receive(std::chrono::milliseconds{10});
+
+    ASSERT_FALSE(client.connected());
+}
+
+TEST_F(CollabHub_Session, EditorsConverge)
+{
+    Document doc_a{"shared text"};
+    Document doc_b{"shared text"};
+    CollabClient client_a{path};
+    CollabClient client_b{path};
+    SequenceCrdt a{doc_a, client_a.site()};
+    SequenceCrdt b{doc_b, client_b.site()};
+
+    doc_a.insert(0, "A: ");
+    doc_b.add_text(" - B");
+    doc_b.erase(0, 7);
+    client_a.send(encode_ops(a.take_local_ops()));
+    client_b.send(encode_ops(b.take_local_ops()));
+
+    for (const std::string& frame : receive(client_a, 1))
+        a.merge(frame);
+    for (const std::string& frame : receive(client_b, 1))
+        b.merge(frame);
+
+    ASSERT_THAT(doc_a.text(), StrEq("A: text - B"));
+    ASSERT_THAT(doc_b.text(), StrEq(doc_a.text()));
+}
+
+TEST_F(CollabHub_Session, SecondHubDoesNotTakeOverTheSession)
+{
+    ASSERT_THROW(CollabHub{path}, std::system_error);
+
+    CollabClient client{path};
+    ASSERT_THAT(hub.clients(), Eq(1u));
+}
+
+TEST(CollabHub_StaleSocket, IsReplaced)
+{
+    const auto path = test_temp_path(".sock");
+    std::filesystem::remove(path);
+
+    // the socket file of a hub that crashed - nothing listens on it
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    path.string().copy(address.sun_path, sizeof(address.sun_path) - 1);
+    const int stale = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_THAT(::bind(stale, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), Eq(0));
+    ::close(stale);
+
+    CollabHub hub{path};
+    CollabClient client{path};
+
+    ASSERT_THAT(client.site(), Ne(0u));
+}
+
+TEST(CollabClient_NoHub, ConnectingFails)
+{
+    ASSERT_THROW(CollabClient{std::filesystem::temp_directory_path() / "document-editor-no-hub.sock"}, std::system_error);
+}
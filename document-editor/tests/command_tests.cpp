@@ -0,0 +1,218 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "command.hpp"
+#include "mocks/mocks.hpp"
+#include "temp_path.hpp"
+
+using namespace ::testing;
+
+struct FileCommands : Test
+{
+    Document doc{"document text"};
+    NiceMock<MockConsole> console;
+    std::filesystem::path path = test_temp_path(".txt");
+
+    ~FileCommands() override
+    {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+};
+
+TEST_F(FileCommands, OpenReplacesTextWithFileContent)
+{
+    std::ofstream{path} << "file text";
+    EXPECT_CALL(console, get_line()).WillOnce(Return(path.string()));
+
+    OpenCmd{doc, console}.execute();
+
+    ASSERT_THAT(doc.text(), StrEq("file text"));
+}
+
+TEST_F(FileCommands, OpenOfMissingFilePrintsError)
+{
+    EXPECT_CALL(console, print("Enter file name:"));
+    EXPECT_CALL(console, get_line()).WillOnce(Return(path.string()));
+    EXPECT_CALL(console, print(StartsWith("Error:")));
+
+    OpenCmd{doc, console}.execute();
+
+    ASSERT_THAT(doc.text(), StrEq("document text"));
+}
+
+TEST_F(FileCommands, SaveWritesText)
+{
+    EXPECT_CALL(console, get_line()).WillOnce(Return(path.string()));
+
+    SaveCmd{doc, console}.execute();
+
+    std::ifstream in{path};
+    std::string content;
+    std::getline(in, content);
+    ASSERT_THAT(content, StrEq("document text"));
+}
+
+TEST_F(FileCommands, DiffPrintsChangesSinceFile)
+{
+    std::ofstream{path} << "document text";
+    doc.replace(0, 8, "DOCUMENT");
+    EXPECT_CALL(console, get_line()).WillOnce(Return(path.string()));
+
+    {
+        InSequence printed;
+        EXPECT_CALL(console, print(StartsWith("Enter file name")));
+        EXPECT_CALL(console, print(AllOf(StartsWith("Found 1 change(s) in "), EndsWith("GB/s)"))));
+        EXPECT_CALL(console, print("line 1: -[document] +[DOCUMENT]"));
+    }
+
+    DiffCmd{doc, console}.execute();
+}
+
+TEST_F(FileCommands, DiffWithoutFileNamePrintsChangesSinceSave)
+{
+    doc.save(path);
+    doc.add_text("!");
+    EXPECT_CALL(console, get_line()).WillOnce(Return(""));
+    EXPECT_CALL(console, print(StartsWith("Enter file name")));
+    EXPECT_CALL(console, print(StartsWith("Found 1 change(s) in ")));
+    EXPECT_CALL(console, print("line 1: -[] +[!]"));
+
+    DiffCmd{doc, console}.execute();
+}
+
+TEST_F(FileCommands, DiffOfMissingFilePrintsError)
+{
+    EXPECT_CALL(console, print(StartsWith("Enter file name")));
+    EXPECT_CALL(console, get_line()).WillOnce(Return(path.string()));
+    EXPECT_CALL(console, print(StartsWith("Error:")));
+
+    DiffCmd{doc, console}.execute();
+}
+
+struct SearchCommands : Test
+{
+    Document doc{"abc\nxyz abc\n"};
+    NiceMock<MockConsole> console;
+
+    SearchCommands()
+    {
+        EXPECT_CALL(console, print(StartsWith("Enter "))).Times(AnyNumber());
+    }
+};
+
+TEST_F(SearchCommands, FindPrintsPositionAndLine)
+{
+    EXPECT_CALL(console, get_line()).WillOnce(Return("xyz"));
+    EXPECT_CALL(console, print("Found at 4 (line 2)"));
+
+    FindCmd{doc, console}.execute();
+}
+
+TEST_F(SearchCommands, FindPrintsNotFound)
+{
+    EXPECT_CALL(console, get_line()).WillOnce(Return("def"));
+    EXPECT_CALL(console, print("Not found"));
+
+    FindCmd{doc, console}.execute();
+}
+
+TEST_F(SearchCommands, FindAllPrintsCountWithThroughputAndOccurrences)
+{
+    EXPECT_CALL(console, get_line()).WillOnce(Return("abc"));
+    {
+        InSequence s;
+        EXPECT_CALL(console, print(AllOf(StartsWith("Found 2 occurrence(s) in "), EndsWith("GB/s)"))));
+        EXPECT_CALL(console, print("0 (line 1)"));
+        EXPECT_CALL(console, print("8 (line 2)"));
+    }
+
+    FindAllCmd{doc, console}.execute();
+}
+
+TEST_F(SearchCommands, ReplaceAllReplacesAndReportsThroughput)
+{
+    EXPECT_CALL(console, get_line()).WillOnce(Return("abc")).WillOnce(Return("#"));
+    EXPECT_CALL(console, print(AllOf(StartsWith("Replaced 2 occurrence(s) in "), EndsWith("GB/s)"))));
+
+    ReplaceAllCmd{doc, console}.execute();
+
+    ASSERT_THAT(doc.text(), StrEq("#\nxyz #\n"));
+}
+
+TEST(StatsCommand, PrintsCharactersWordsAndLines)
+{
+    Document doc{"two words\nand three more\n"};
+    NiceMock<MockConsole> console;
+    EXPECT_CALL(console, print("Characters: 25, words: 5, lines: 3"));
+
+    StatsCmd{doc, console}.execute();
+}
+
+TEST(IndexCommand, BuildsIndexAndReportsMemory)
+{
+    Document doc{"indexed text"};
+    NiceMock<MockConsole> console;
+
+    EXPECT_CALL(console, print(AllOf(StartsWith("Index built in "), EndsWith(" MiB"))));
+
+    IndexCmd{doc, console}.execute();
+
+    ASSERT_TRUE(doc.has_index());
+}
+
+struct ClipboardCommands : Test
+{
+    Document doc{"abc"};
+    SharedClipboard clipboard;
+};
+
+TEST_F(ClipboardCommands, CopySetsClipboardContent)
+{
+    CopyCmd{doc, clipboard}.execute();
+
+    ASSERT_THAT(*clipboard.content(), StrEq("abc"));
+}
+
+TEST_F(ClipboardCommands, PasteAddsClipboardContent)
+{
+    clipboard.set_content("def");
+
+    PasteCmd{doc, clipboard}.execute();
+
+    ASSERT_THAT(doc.text(), StrEq("abcdef"));
+}
+
+TEST_F(ClipboardCommands, PasteReferencesClipboardBuffer)
+{
+    clipboard.set_content(std::string(2 * Rope::max_chunk_size, 'p'));
+    const auto buffer = clipboard.content();
+
+    PasteCmd{doc, clipboard}.execute();
+    PasteCmd{doc, clipboard}.execute();
+
+    size_t shared_bytes = 0;
+    doc.for_each_chunk([&](std::string_view chunk) {
+        if (chunk.data() >= buffer->data() && chunk.data() < buffer->data() + buffer->size())
+            shared_bytes += chunk.size();
+    });
+
+    ASSERT_THAT(shared_bytes, Eq(2 * buffer->size()));
+    ASSERT_THAT(doc.length(), Eq(3 + 2 * buffer->size()));
+}
+
+TEST_F(ClipboardCommands, PastedTextCanBeChangedWithoutAffectingClipboard)
+{
+    clipboard.set_content("def");
+    PasteCmd{doc, clipboard}.execute();
+
+    doc.to_upper();
+
+    ASSERT_THAT(doc.text(), StrEq("ABCDEF"));
+    ASSERT_THAT(*clipboard.content(), StrEq("def"));
+}
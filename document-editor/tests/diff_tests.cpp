@@ -0,0 +1,176 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "diff.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    // applies the hunks to the old text - must give the new one
+    std::string patch(const std::string& old_text, const std::string& new_text, const std::vector<DiffHunk>& hunks)
+    {
+        std::string result;
+        size_t pos = 0;
+        for (const DiffHunk& hunk : hunks)
+        {
+            result += old_text.substr(pos, hunk.old_pos - pos);
+            result += new_text.substr(hunk.new_pos, hunk.new_count);
+            pos = hunk.old_pos + hunk.old_count;
+        }
+
+        return result + old_text.substr(pos);
+    }
+
+    size_t changed_characters(const std::vector<DiffHunk>& hunks)
+    {
+        size_t count = 0;
+        for (const DiffHunk& hunk : hunks)
+            count += hunk.old_count + hunk.new_count;
+
+        return count;
+    }
+} // namespace
+
+TEST(Diff, EqualTextsHaveNoHunks)
+{
+    ASSERT_THAT(diff(Rope{"same\ntext\n"}, Rope{"same\ntext\n"}), IsEmpty());
+    ASSERT_THAT(diff(Rope{}, Rope{}), IsEmpty());
+}
+
+TEST(Diff, InsertionIntoEmptyText)
+{
+    ASSERT_THAT(diff(Rope{}, Rope{"abc"}), ElementsAre(DiffHunk{0, 0, 0, 3}));
+    ASSERT_THAT(diff(Rope{"abc"}, Rope{}), ElementsAre(DiffHunk{0, 3, 0, 0}));
+}
+
+TEST(Diff, ChangedLineIsRefinedToCharacters)
+{
+    const auto hunks = diff(Rope{"first line\nsecond line\nthird line\n"}, Rope{"first line\nsecond lime\nthird line\n"});
+
+    ASSERT_THAT(hunks, ElementsAre(DiffHunk{20, 1, 20, 1}));
+}
+
+TEST(Diff, InsertedAndDeletedLines)
+{
+    const std::string old_text = "a\nb\nc\nd\n";
+    const std::string new_text = "a\nx\nc\nd\ne\n";
+
+    const auto hunks = diff(Rope{old_text}, Rope{new_text});
+
+    ASSERT_THAT(hunks, ElementsAre(DiffHunk{2, 1, 2, 1}, DiffHunk{8, 0, 8, 2}));
+    ASSERT_THAT(patch(old_text, new_text, hunks), StrEq(new_text));
+}
+
+TEST(Diff, LastLineWithoutNewline)
+{
+    const std::string old_text = "a\nbc";
+    const std::string new_text = "a\nbd";
+
+    ASSERT_THAT(diff(Rope{old_text}, Rope{new_text}), ElementsAre(DiffHunk{3, 1, 3, 1}));
+}
+
+TEST(Diff, MovedLineIsDeletedAndInserted)
+{
+    const std::string old_text = "1\n2\n3\n4\n";
+    const std::string new_text = "2\n3\n4\n1\n";
+
+    const auto hunks = diff(Rope{old_text}, Rope{new_text});
+
+    ASSERT_THAT(changed_characters(hunks), Eq(4u));
+    ASSERT_THAT(patch(old_text, new_text, hunks), StrEq(new_text));
+}
+
+TEST(Diff, VersionsOfDocument)
+{
+    Document doc{std::string(100000, 'a') + "\nmiddle\n" + std::string(100000, 'b')};
+    const auto before = doc.snapshot();
+
+    doc.replace(100001, 6, "MIDDLE");
+
+    ASSERT_THAT(diff(before, doc.snapshot()), ElementsAre(DiffHunk{100001, 6, 100001, 6}));
+}
+
+TEST(Diff, LinesSpanningChunks)
+{
+    const std::string line(3 * Rope::max_chunk_size, 'x');
+    const std::string old_text = line + "\n" + line + "\n";
+    std::string new_text = old_text;
+    new_text[line.size() + 1 + Rope::max_chunk_size] = 'y';
+
+    ASSERT_THAT(diff(Rope{old_text}, Rope{new_text}),
+        ElementsAre(DiffHunk{line.size() + 1 + Rope::max_chunk_size, 1, line.size() + 1 + Rope::max_chunk_size, 1}));
+}
+
+TEST(Diff, TotallyDifferentTextsAreOneHunk)
+{
+    std::string old_text, new_text;
+    for (int i = 0; i < 20000; ++i)
+    {
+        old_text += "old " + std::to_string(i) + "\n";
+        new_text += "new " + std::to_string(i * 7) + "\n";
+    }
+
+    const auto hunks = diff(Rope{old_text}, Rope{new_text});
+
+    ASSERT_THAT(patch(old_text, new_text, hunks), StrEq(new_text));
+}
+
+TEST(Diff, RandomEditsArePatchedBack)
+{
+    std::mt19937 rng{7};
+    const std::string alphabet = "ab\n";
+
+    for (int round = 0; round < 300; ++round)
+    {
+        std::string old_text;
+        for (size_t i = std::uniform_int_distribution<size_t>{0, 60}(rng); i > 0; --i)
+            old_text += alphabet[rng() % alphabet.size()];
+
+        std::string new_text = old_text;
+        for (int edit = std::uniform_int_distribution<int>{0, 5}(rng); edit > 0; --edit)
+        {
+            const size_t pos = std::uniform_int_distribution<size_t>{0, new_text.size()}(rng);
+            if (rng() % 2 && pos < new_text.size())
+                new_text.erase(pos, 1 + rng() % 3);
+            else
+                new_text.insert(pos, 1 + rng() % 3, alphabet[rng() % alphabet.size()]);
+        }
+
+        const auto hunks = diff(Rope{old_text}, Rope{new_text});
+
+        ASSERT_THAT(patch(old_text, new_text, hunks), StrEq(new_text)) << "old: " << old_text << "\nnew: " << new_text;
+        for (size_t i = 1; i < hunks.size(); ++i)
+            ASSERT_THAT(hunks[i].old_pos, Ge(hunks[i - 1].old_pos + hunks[i - 1].old_count));
+    }
+}
+
+TEST(Diff, RandomEditsOfDocumentArePatchedBack)
+{
+    std::mt19937 rng{11};
+    std::string text;
+    for (int line = 0; line < 20000; ++line)
+        text += "line " + std::to_string(line) + "\n";
+
+    for (int round = 0; round < 20; ++round)
+    {
+        Document doc{text};
+        const auto before = doc.snapshot();
+
+        for (int edit = std::uniform_int_distribution<int>{1, 10}(rng); edit > 0; --edit)
+        {
+            const size_t pos = std::uniform_int_distribution<size_t>{0, doc.length() - 20}(rng);
+            doc.replace(pos, rng() % 20, std::string(rng() % 20, "x\n"[rng() % 2]));
+        }
+
+        const auto after = doc.snapshot();
+        const auto hunks = diff(before, after);
+
+        ASSERT_THAT(patch(before.text(), after.text(), hunks), StrEq(after.text()));
+        ASSERT_THAT(changed_characters(hunks), Le(400u));
+    }
+}
@@ -1,4 +1,8 @@
 #include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -82,6 +86,15 @@ TEST_F(Document_CaseConversion, ToLowerCase)
     ASSERT_THAT(doc.text(), StrEq("abcdef"));
 }
 
+TEST(Document_Utf8CaseConversion, MultiByteSequencesAreKept)
+{
+    Document doc{"zażółć"};
+
+    doc.to_upper();
+
+    ASSERT_THAT(doc.text(), StrEq("ZAżółć"));
+}
+
 struct Document_ReplacingText : Document_ValueConstructed
 {
 };
@@ -93,6 +106,20 @@ TEST_F(Document_ReplacingText, TextIsReplaced)
     ASSERT_THAT(doc.text(), StrEq("xyzc"));
 }
 
+TEST_F(Document_ReplacingText, TextIsInserted)
+{
+    doc.insert(1, "xyz");
+
+    ASSERT_THAT(doc.text(), StrEq("axyzbc"));
+}
+
+TEST_F(Document_ReplacingText, TextIsErased)
+{
+    doc.erase(0, 2);
+
+    ASSERT_THAT(doc.text(), StrEq("c"));
+}
+
 struct Document_Memento : Document_ValueConstructed
 {
 };
@@ -104,4 +131,412 @@ TEST_F(Document_Memento, RestoresThePreviousState)
     doc.set_memento(snaphot);
 
     ASSERT_THAT(doc.text(), StrEq("abc"));
-}
\ No newline at end of file
+}
+
+TEST_F(Document_Memento, UndoesSeveralEdits)
+{
+    auto before_edits = doc.create_memento();
+    doc.add_text("def");
+    doc.replace(0, 1, "A");
+    doc.to_upper();
+
+    doc.set_memento(before_edits);
+
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(Document_Memento, RedoesAfterUndo)
+{
+    auto first = doc.create_memento();
+    doc.add_text("def");
+    auto second = doc.create_memento();
+    doc.erase(0, 1);
+
+    doc.set_memento(first);
+    doc.set_memento(second);
+
+    ASSERT_THAT(doc.text(), StrEq("abcdef"));
+}
+
+TEST_F(Document_Memento, RestoresStateFromAbandonedBranch)
+{
+    auto root = doc.create_memento();
+    doc.add_text("-branch1");
+    auto branch1 = doc.create_memento();
+
+    doc.set_memento(root);
+    doc.insert(0, "branch2-");
+    auto branch2 = doc.create_memento();
+
+    doc.set_memento(branch1);
+    ASSERT_THAT(doc.text(), StrEq("abc-branch1"));
+
+    doc.set_memento(branch2);
+    ASSERT_THAT(doc.text(), StrEq("branch2-abc"));
+}
+
+TEST_F(Document_Memento, OnlyEveryNthMementoIsKeyframe)
+{
+    doc.set_keyframe_interval(3);
+
+    std::vector<bool> keyframes;
+    for (int i = 0; i < 6; ++i)
+    {
+        doc.add_text("x");
+        keyframes.push_back(doc.create_memento().is_keyframe());
+    }
+
+    ASSERT_THAT(keyframes, ElementsAre(true, false, false, true, false, false));
+}
+
+TEST_F(Document_Memento, KeyframeCanBeSetOnOtherDocument)
+{
+    auto snapshot = doc.create_memento();
+    ASSERT_TRUE(snapshot.is_keyframe());
+
+    Document other{"xyz"};
+    other.set_memento(snapshot);
+
+    ASSERT_THAT(other.text(), StrEq("abc"));
+}
+
+TEST_F(Document_Memento, AdoptedHistoryDropsEditsOnceNoMementoIsAlive)
+{
+    Document other{"xyz"};
+    {
+        auto snapshot = doc.create_memento();
+        other.set_memento(snapshot);
+    }
+
+    for (int i = 0; i < 100; ++i)
+        doc.replace(0, 3, std::string(1'000, 'x'));
+
+    ASSERT_THAT(doc.create_delta_memento().memory_usage(), Eq(0u));
+}
+
+TEST_F(Document_Memento, DeltaMementoOfOtherDocumentIsRejected)
+{
+    doc.create_memento();
+    doc.add_text("d");
+    auto delta = doc.create_memento();
+    ASSERT_FALSE(delta.is_keyframe());
+
+    Document other{"xyz"};
+
+    ASSERT_THROW(other.set_memento(delta), std::invalid_argument);
+}
+
+TEST_F(Document_Memento, KeyframeCanBeWrittenWithCerealArchives)
+{
+    auto snapshot = doc.create_memento<cereal::BinaryOutputArchive>();
+
+    Document other{"xyz"};
+    other.set_memento<cereal::BinaryInputArchive>(snapshot);
+
+    ASSERT_THAT(other.text(), StrEq("abc"));
+}
+
+TEST_F(Document_Memento, CompressedKeyframeCanBeSetOnOtherDocument)
+{
+    doc.add_text(std::string(10'000, 'x'));
+    auto snapshot = doc.create_memento();
+    snapshot.compress();
+    ASSERT_TRUE(snapshot.is_compressed());
+    ASSERT_THAT(snapshot.memory_usage(), Lt(snapshot.uncompressed_size() / 10));
+
+    Document other{"xyz"};
+    other.set_memento(snapshot);
+
+    ASSERT_THAT(other.text(), StrEq(doc.text()));
+}
+
+TEST_F(Document_Memento, KeyframeSharesTheTextOfTheDocument)
+{
+    doc.add_text(std::string(10'000, 'x'));
+    auto snapshot = doc.create_memento();
+    ASSERT_TRUE(snapshot.is_keyframe());
+
+    ASSERT_THAT(snapshot.memory_usage(), Lt(100u));
+    ASSERT_FALSE(snapshot.is_compressed());
+}
+
+TEST_F(Document_Memento, LongPathIsReplayedFromKeyframe)
+{
+    doc.set_keyframe_interval(4);
+    std::vector<Document::Memento> mementos;
+    for (int i = 0; i < 20; ++i)
+    {
+        doc.insert(0, std::to_string(i));
+        mementos.push_back(doc.create_memento());
+    }
+    const std::string latest = doc.text();
+
+    doc.set_memento(mementos[1]);
+    ASSERT_THAT(doc.text(), StrEq("10abc"));
+
+    doc.set_memento(mementos[18]);
+    ASSERT_THAT(doc.text(), StrEq(latest.substr(2)));
+
+    doc.set_memento(mementos[6]); // a delta memento - replayed from the keyframe of mementos[4]
+    ASSERT_THAT(doc.text(), StrEq("6543210abc"));
+}
+
+TEST_F(Document_Memento, KeyframeBeforeTruncatedHistoryIsRestored)
+{
+    auto old_state = doc.create_memento();
+    ASSERT_TRUE(old_state.is_keyframe());
+    doc.add_text("d");
+    auto kept = doc.create_memento();
+    doc.add_text("e");
+
+    doc.truncate_history(kept);
+    doc.set_memento(old_state);
+
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(Document_Memento, MementoBeforeTruncatedHistoryIsRejected)
+{
+    auto old_state = doc.create_delta_memento();
+    doc.add_text("d");
+    auto kept = doc.create_memento();
+    doc.add_text("e");
+
+    doc.truncate_history(kept);
+
+    ASSERT_THROW(doc.set_memento(old_state), std::invalid_argument);
+    ASSERT_THAT(doc.text(), StrEq("abcde"));
+
+    doc.set_memento(kept);
+    ASSERT_THAT(doc.text(), StrEq("abcd"));
+}
+
+struct Document_Snapshot : Document_ValueConstructed
+{
+};
+
+TEST_F(Document_Snapshot, IsNotAffectedByLaterEdits)
+{
+    auto snapshot = doc.snapshot();
+    doc.add_text("def");
+    doc.to_upper();
+
+    ASSERT_THAT(snapshot.text(), StrEq("abc"));
+    ASSERT_THAT(doc.text(), StrEq("ABCDEF"));
+}
+
+TEST_F(Document_Snapshot, SharesUntouchedChunksWithDocument)
+{
+    Document large_doc{std::string(4 * Rope::max_chunk_size, 'a')};
+    auto snapshot = large_doc.snapshot();
+    large_doc.add_text("end");
+
+    std::vector<const char*> document_chunks, snapshot_chunks;
+    large_doc.for_each_chunk([&](std::string_view chunk) { document_chunks.push_back(chunk.data()); });
+    snapshot.for_each_chunk([&](std::string_view chunk) { snapshot_chunks.push_back(chunk.data()); });
+
+    ASSERT_THAT(document_chunks.front(), Eq(snapshot_chunks.front()));
+}
+
+TEST_F(Document_Snapshot, CanBeWrappedInMemento)
+{
+    Document::Memento memento{doc.snapshot()};
+    doc.clear();
+
+    doc.set_memento(memento);
+
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(Document_Snapshot, RestoringSnapshotCanBeUndone)
+{
+    Document::Memento snapshot_memento{Document{"xyz"}.snapshot()};
+    auto before = doc.create_memento();
+
+    doc.set_memento(snapshot_memento);
+    ASSERT_THAT(doc.text(), StrEq("xyz"));
+
+    doc.set_memento(before);
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(Document_Snapshot, CopiesTextIntoAnotherDocument)
+{
+    Document copy;
+    Document::Memento memento{doc.snapshot()};
+    copy.set_memento(memento);
+    doc.add_text("d");
+
+    ASSERT_THAT(copy.text(), StrEq("abc"));
+}
+
+struct Document_Copy : Document_ValueConstructed
+{
+};
+
+TEST_F(Document_Copy, IsNotAffectedByLaterEdits)
+{
+    Document copy{doc};
+    doc.add_text("d");
+    copy.erase(0, 1);
+
+    ASSERT_THAT(doc.text(), StrEq("abcd"));
+    ASSERT_THAT(copy.text(), StrEq("bc"));
+    ASSERT_THAT(copy.pin().text(), StrEq("bc"));
+}
+
+TEST_F(Document_Copy, StartsWithHistoryOfItsOwn)
+{
+    auto before = doc.create_delta_memento();
+    doc.add_text("d");
+
+    Document copy{doc};
+
+    ASSERT_THROW(copy.set_memento(before), std::invalid_argument);
+    doc.set_memento(before);
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(Document_Copy, HasNoEditListeners)
+{
+    size_t calls = 0;
+    doc.add_edit_listener([&](uint64_t, size_t, size_t, const Rope&) { ++calls; });
+
+    Document copy{doc};
+    copy.add_text("d");
+
+    ASSERT_THAT(calls, Eq(0u));
+}
+
+TEST_F(Document_Copy, MoveLeavesEmptyDocument)
+{
+    auto before = doc.create_delta_memento();
+    doc.add_text("d");
+
+    Document moved{std::move(doc)};
+
+    ASSERT_THAT(moved.text(), StrEq("abcd"));
+    ASSERT_THAT(doc.text(), StrEq(""));
+    ASSERT_THAT(doc.pin().text(), StrEq(""));
+    ASSERT_THROW(doc.set_memento(before), std::invalid_argument);
+}
+
+struct Document_Pinned : Document_ValueConstructed
+{
+};
+
+TEST_F(Document_Pinned, SeesLatestVersion)
+{
+    doc.add_text("d");
+    doc.erase(0, 1);
+
+    auto pinned = doc.pin();
+
+    ASSERT_THAT(pinned.text(), StrEq("bcd"));
+    ASSERT_THAT(pinned.version(), Eq(2));
+    ASSERT_THAT(doc.version(), Eq(2));
+}
+
+TEST_F(Document_Pinned, IsNotAffectedByLaterEdits)
+{
+    auto pinned = doc.pin();
+    doc.clear();
+
+    ASSERT_THAT(pinned.text(), StrEq("abc"));
+    ASSERT_THAT(doc.pin().text(), StrEq(""));
+}
+
+TEST_F(Document_Pinned, FollowsUndo)
+{
+    auto before = doc.create_memento();
+    doc.add_text("def");
+
+    doc.set_memento(before);
+
+    ASSERT_THAT(doc.pin().text(), StrEq("abc"));
+}
+
+TEST(Document_PinnedConcurrently, ReadersSeeConsistentVersionsWhileWriterEdits)
+{
+    constexpr uint64_t edits = 20'000;
+    Document doc;
+    std::atomic<bool> consistent = true;
+
+    // every edit appends one 'x' - a consistent version is version() x's
+    std::vector<std::jthread> readers;
+    for (int i = 0; i < 3; ++i)
+    {
+        readers.emplace_back([&] {
+            for (uint64_t version = 0; version < edits;)
+            {
+                auto pinned = doc.pin();
+                version = pinned.version();
+
+                size_t xs = 0;
+                pinned.for_each_chunk([&](std::string_view chunk) { xs += std::count(chunk.begin(), chunk.end(), 'x'); });
+                if (pinned.length() != version || xs != version)
+                    consistent = false;
+            }
+        });
+    }
+
+    for (uint64_t i = 0; i < edits; ++i)
+        doc.add_text("x");
+
+    readers.clear();
+
+    ASSERT_TRUE(consistent);
+}
+
+struct Document_Lines : Test
+{
+    Document doc{"line 0\nline 1\nline 2\n"};
+};
+
+TEST_F(Document_Lines, CountsLines)
+{
+    ASSERT_THAT(doc.line_count(), Eq(4)); // the last line is empty
+    ASSERT_THAT(Document{}.line_count(), Eq(1));
+}
+
+TEST_F(Document_Lines, CountsWords)
+{
+    ASSERT_THAT(doc.word_count(), Eq(6));
+
+    doc.replace(4, 1, "");
+    ASSERT_THAT(doc.word_count(), Eq(5));
+
+    doc.to_upper();
+    doc.add_text(" tail");
+    ASSERT_THAT(doc.word_count(), Eq(6));
+
+    doc.clear();
+    ASSERT_THAT(doc.word_count(), Eq(0));
+}
+
+TEST_F(Document_Lines, ReturnsRangeOfLines)
+{
+    ASSERT_THAT(doc.lines(1, 1), StrEq("line 1\n"));
+    ASSERT_THAT(doc.lines(0, 2), StrEq("line 0\nline 1\n"));
+    ASSERT_THAT(doc.lines(2, 100), StrEq("line 2\n"));
+    ASSERT_THAT(doc.lines(3, 1), StrEq(""));
+    ASSERT_THROW(doc.lines(4, 1), std::out_of_range);
+}
+
+TEST_F(Document_Lines, IndexIsUpdatedByEdits)
+{
+    doc.add_text("line 3\nline 4");
+    doc.replace(0, 7, "first\nline\n");
+
+    ASSERT_THAT(doc.line_count(), Eq(6));
+    ASSERT_THAT(doc.lines(1, 1), StrEq("line\n"));
+    ASSERT_THAT(doc.lines(5, 1), StrEq("line 4"));
+    ASSERT_THAT(doc.line_of(doc.line_start(4)), Eq(4));
+
+    auto memento = doc.create_memento();
+    doc.erase(doc.line_start(1), doc.line_start(3) - doc.line_start(1));
+    ASSERT_THAT(doc.lines(1, 1), StrEq("line 2\n"));
+
+    doc.set_memento(memento);
+    ASSERT_THAT(doc.lines(1, 1), StrEq("line\n"));
+}
@@ -0,0 +1,177 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "document.hpp"
+#include "file_io.hpp"
+#include "temp_path.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    std::string read_file(const std::filesystem::path& path)
+    {
+        std::ifstream in{path, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    }
+
+    void write_text(const std::filesystem::path& path, const std::string& text)
+    {
+        std::ofstream out{path, std::ios::binary};
+        out << text;
+    }
+} // namespace
+
+struct FileIO : Test
+{
+    std::filesystem::path path = test_temp_path(".txt");
+
+    ~FileIO() override
+    {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+};
+
+TEST_F(FileIO, MappedFileHoldsContent)
+{
+    write_text(path, "mapped text\n");
+
+    MappedFile file{path};
+
+    ASSERT_THAT(std::string(file.data(), file.size()), StrEq("mapped text\n"));
+}
+
+TEST_F(FileIO, EmptyFileIsMappedToEmptyRope)
+{
+    write_text(path, "");
+
+    ASSERT_TRUE(map_file(path).empty());
+}
+
+TEST_F(FileIO, MissingFileThrows)
+{
+    ASSERT_THROW(map_file(path), std::system_error);
+}
+
+TEST_F(FileIO, RopeOutlivesMappingOwner)
+{
+    const std::string text(3 * Rope::max_chunk_size + 11, 'm');
+    write_text(path, text);
+
+    Rope rope = map_file(path);
+    std::filesystem::remove(path);
+
+    ASSERT_THAT(rope.str(), StrEq(text));
+}
+
+TEST_F(FileIO, WriteFileStreamsAllChunks)
+{
+    std::string text;
+    for (int i = 0; text.size() < 3 * write_block_size + 123; ++i)
+        text += "line " + std::to_string(i) + "\n";
+
+    Rope rope;
+    for (size_t pos = 0; pos < text.size(); pos += 1000)
+        rope.append(Rope{text.substr(pos, 1000)});
+
+    write_file(path, rope);
+
+    ASSERT_TRUE(read_file(path) == text);
+}
+
+TEST_F(FileIO, WriteFileKeepsPermissions)
+{
+    using std::filesystem::perms;
+
+    write_text(path, "old");
+    std::filesystem::permissions(path, perms::owner_read | perms::owner_write | perms::owner_exec);
+
+    write_file(path, Rope{std::string{"new"}});
+
+    ASSERT_THAT(read_file(path), StrEq("new"));
+    ASSERT_EQ(std::filesystem::status(path).permissions(), perms::owner_read | perms::owner_write | perms::owner_exec);
+}
+
+TEST_F(FileIO, WriteFileReplacesTheTargetOfSymbolicLink)
+{
+    std::filesystem::path link = path;
+    link += ".link";
+    std::filesystem::remove(link);
+    write_text(path, "old");
+    std::filesystem::create_symlink(path, link);
+
+    write_file(link, Rope{std::string{"new"}});
+
+    const bool still_link = std::filesystem::is_symlink(link);
+    std::filesystem::remove(link);
+    ASSERT_TRUE(still_link);
+    ASSERT_THAT(read_file(path), StrEq("new"));
+}
+
+TEST_F(FileIO, ConcurrentWritesDoNotMix)
+{
+    const std::string first(3 * write_block_size, 'a');
+    const std::string second(2 * write_block_size, 'b');
+    {
+        std::jthread writer{[&] {
+            for (int i = 0; i < 20; ++i)
+                write_file(path, Rope{first});
+        }};
+        for (int i = 0; i < 20; ++i)
+            write_file(path, Rope{second});
+    }
+
+    const std::string text = read_file(path);
+    ASSERT_TRUE(text == first || text == second);
+}
+
+TEST_F(FileIO, DocumentOpenedFromFileCanBeEditedAndSavedOverIt)
+{
+    write_text(path, "first line\nsecond line\n");
+
+    Document doc;
+    doc.open(path);
+    doc.insert(0, "new ");
+    doc.add_text("third line\n");
+    doc.save(path);
+
+    ASSERT_THAT(doc.text(), StrEq("new first line\nsecond line\nthird line\n"));
+    ASSERT_THAT(read_file(path), StrEq("new first line\nsecond line\nthird line\n"));
+}
+
+TEST_F(FileIO, OpeningCanBeUndone)
+{
+    write_text(path, "from file");
+
+    Document doc{"before"};
+    auto memento = doc.create_memento();
+    doc.open(path);
+    ASSERT_THAT(doc.text(), StrEq("from file"));
+
+    doc.set_memento(memento);
+    ASSERT_THAT(doc.text(), StrEq("before"));
+}
+
+TEST_F(FileIO, DocumentKeepsTheTextLastOpenedOrSaved)
+{
+    write_text(path, "from file");
+
+    Document doc{"before"};
+    ASSERT_THAT(doc.saved().text(), StrEq("before"));
+
+    doc.open(path);
+    doc.add_text(" edited");
+    ASSERT_THAT(doc.saved().text(), StrEq("from file"));
+
+    doc.save(path);
+    doc.clear();
+    ASSERT_THAT(doc.saved().text(), StrEq("from file edited"));
+}
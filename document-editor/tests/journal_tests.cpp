@@ -0,0 +1,196 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "journal.hpp"
+#include "temp_path.hpp"
+
+using namespace ::testing;
+
+struct Journal_Segments : Test
+{
+    std::filesystem::path base = test_temp_path(".journal");
+
+    Journal_Segments()
+    {
+        remove_segments();
+    }
+
+    ~Journal_Segments() override
+    {
+        remove_segments();
+    }
+
+    void remove_segments()
+    {
+        std::error_code ignored;
+        for (const auto& segment : Journal::segments(base))
+            std::filesystem::remove(segment, ignored);
+    }
+};
+
+TEST_F(Journal_Segments, RecordsAreReadBackInOrder)
+{
+    {
+        Journal journal{base};
+        journal.append(1, 0, 0, Rope{"abc"});
+        journal.append(2, 1, 1, Rope{});
+        journal.append(3, 2, 0, Rope{std::string(5000, 'x')});
+    }
+
+    const auto records = Journal::read(base);
+
+    ASSERT_THAT(records, SizeIs(3));
+    ASSERT_THAT(records[0].version, Eq(1u));
+    ASSERT_THAT(records[0].inserted, StrEq("abc"));
+    ASSERT_THAT(records[1].pos, Eq(1u));
+    ASSERT_THAT(records[1].count, Eq(1u));
+    ASSERT_THAT(records[1].inserted, IsEmpty());
+    ASSERT_THAT(records[2].inserted, StrEq(std::string(5000, 'x')));
+}
+
+TEST_F(Journal_Segments, InsertSpanningManyChunksIsReadBack)
+{
+    Rope inserted{std::string(200'000, 'a')};
+    inserted.insert(100'000, Rope{"middle"});
+    {
+        Journal journal{base};
+        journal.append(1, 0, 0, inserted);
+    }
+
+    const auto records = Journal::read(base);
+
+    ASSERT_THAT(records, SizeIs(1));
+    ASSERT_THAT(records[0].inserted, StrEq(inserted.str()));
+}
+
+TEST_F(Journal_Segments, ReadSkipsVersionsUpToTheGivenOne)
+{
+    {
+        Journal journal{base};
+        for (uint64_t version = 1; version <= 5; ++version)
+            journal.append(version, 0, 0, Rope{"v"});
+    }
+
+    const auto records = Journal::read(base, 3);
+
+    ASSERT_THAT(records, SizeIs(2));
+    ASSERT_THAT(records[0].version, Eq(4u));
+}
+
+TEST_F(Journal_Segments, SyncGroupsRecordsIntoOneCommit)
+{
+    Journal journal{base, std::chrono::hours{1}};
+    for (uint64_t version = 1; version <= 100; ++version)
+        journal.append(version, 0, 0, Rope{"edit"});
+
+    journal.sync();
+
+    ASSERT_THAT(journal.commits(), Eq(1u));
+    ASSERT_THAT(Journal::read(base), SizeIs(100));
+}
+
+TEST_F(Journal_Segments, TornRecordEndsTheJournal)
+{
+    {
+        Journal journal{base};
+        journal.append(1, 0, 0, Rope{"kept"});
+        journal.append(2, 0, 0, Rope{"torn"});
+    }
+
+    const auto segment = Journal::segments(base).front();
+    std::filesystem::resize_file(segment, std::filesystem::file_size(segment) - 2);
+
+    const auto records = Journal::read(base);
+
+    ASSERT_THAT(records, SizeIs(1));
+    ASSERT_THAT(records[0].inserted, StrEq("kept"));
+}
+
+TEST_F(Journal_Segments, CorruptedRecordEndsTheJournal)
+{
+    {
+        Journal journal{base};
+        journal.append(1, 0, 0, Rope{"kept"});
+        journal.append(2, 0, 0, Rope{"flipped"});
+    }
+
+    {
+        std::fstream file{Journal::segments(base).front(), std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(-6, std::ios::end);
+        file.put('F');
+    }
+
+    ASSERT_THAT(Journal::read(base), SizeIs(1));
+}
+
+TEST_F(Journal_Segments, RotateStartsNewSegment)
+{
+    Journal journal{base};
+    journal.append(1, 0, 0, Rope{"a"});
+    journal.rotate();
+    journal.append(2, 0, 0, Rope{"b"});
+    journal.sync();
+
+    ASSERT_THAT(Journal::segments(base), SizeIs(2));
+    ASSERT_THAT(Journal::read(base), SizeIs(2));
+}
+
+TEST_F(Journal_Segments, RemovesSegmentsCoveredByVersion)
+{
+    Journal journal{base};
+    journal.append(1, 0, 0, Rope{"a"});
+    journal.rotate();
+    journal.append(2, 0, 0, Rope{"b"});
+    journal.rotate();
+    journal.append(3, 0, 0, Rope{"c"});
+
+    journal.remove_segments_up_to(1);
+
+    const auto records = Journal::read(base);
+    ASSERT_THAT(records, SizeIs(2));
+    ASSERT_THAT(records[0].version, Eq(2u));
+
+    journal.remove_segments_up_to(3); // the current segment is kept
+    ASSERT_THAT(Journal::read(base), SizeIs(1));
+}
+
+TEST_F(Journal_Segments, NewJournalContinuesAfterExistingSegments)
+{
+    {
+        Journal journal{base};
+        journal.append(1, 0, 0, Rope{"a"});
+    }
+    {
+        Journal journal{base};
+        journal.append(2, 0, 0, Rope{"b"});
+    }
+
+    ASSERT_THAT(Journal::segments(base), SizeIs(2));
+    ASSERT_THAT(Journal::read(base), SizeIs(2));
+}
+
+TEST_F(Journal_Segments, FailedWriteIsRetried)
+{
+    const std::filesystem::path directory = base.string() + ".dir";
+    std::filesystem::remove_all(directory);
+
+    Journal journal{directory / "journal"};
+    journal.append(1, 0, 0, Rope{"a"});
+    ASSERT_THROW(journal.sync(), std::system_error);
+
+    std::filesystem::create_directory(directory);
+    journal.append(2, 0, 0, Rope{"b"});
+    journal.sync();
+
+    const auto records = Journal::read(directory / "journal");
+    std::filesystem::remove_all(directory);
+
+    ASSERT_THAT(records, SizeIs(2));
+    ASSERT_THAT(records[0].inserted, StrEq("a"));
+    ASSERT_THAT(records[1].inserted, StrEq("b"));
+}
@@ -0,0 +1,69 @@
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "lz_codec.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    std::string random_text(size_t size, unsigned seed)
+    {
+        std::mt19937 rng{seed};
+        std::uniform_int_distribution<int> byte{0, 255};
+
+        std::string text(size, '\0');
+        for (char& c : text)
+            c = static_cast<char>(byte(rng));
+
+        return text;
+    }
+} // namespace
+
+TEST(LzCodec, RoundTripsEmptyInput)
+{
+    ASSERT_THAT(lz_decompress(lz_compress("")), StrEq(""));
+}
+
+TEST(LzCodec, RoundTripsShortInputs)
+{
+    for (const std::string text : {"a", "abc", "abcd", "abcdabcd", "aaaaaaaaaaaaaaaaaaaaa"})
+        ASSERT_THAT(lz_decompress(lz_compress(text)), StrEq(text));
+}
+
+TEST(LzCodec, CompressesRepeatedText)
+{
+    std::string text;
+    for (int i = 0; i < 1000; ++i)
+        text += "line of text " + std::to_string(i % 10) + "\n";
+
+    const std::string compressed = lz_compress(text);
+
+    ASSERT_THAT(compressed.size(), Lt(text.size() / 10));
+    ASSERT_THAT(lz_decompress(compressed), StrEq(text));
+}
+
+TEST(LzCodec, RoundTripsLongMatchesAndLiteralRuns)
+{
+    const std::string text = random_text(100'000, 1) + std::string(100'000, 'z') + random_text(300, 2) + random_text(100'000, 1);
+
+    ASSERT_TRUE(lz_decompress(lz_compress(text)) == text);
+}
+
+TEST(LzCodec, RejectsTruncatedInput)
+{
+    const std::string compressed = lz_compress(std::string(1000, 'a') + "tail");
+
+    ASSERT_THROW(lz_decompress(compressed.substr(0, compressed.size() - 2)), std::runtime_error);
+}
+
+TEST(LzCodec, RejectsMatchBeforeStartOfOutput)
+{
+    const std::string compressed = {4, 0x00, 0x10, 0x00}; // size 4, no literals, offset 16
+
+    ASSERT_THROW(lz_decompress(compressed), std::runtime_error);
+}
@@ -0,0 +1,102 @@
+#include <map>
+#include <memory>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "command.hpp"
+#include "macro.hpp"
+#include "mocks/mocks.hpp"
+
+using namespace ::testing;
+
+struct Macro_Compiled : Test
+{
+    NiceMock<MockConsole> terminal;
+    MacroConsole console{terminal};
+    Document doc;
+    std::map<std::string, std::shared_ptr<Command>, std::less<>> commands = {
+        {"AddText", std::make_shared<AddTextCmd>(doc, console)},
+        {"ToUpper", std::make_shared<ToUpperCmd>(doc)},
+        {"Find", std::make_shared<FindCmd>(doc, console)}};
+
+    Macro compile(const std::vector<MacroStep>& steps)
+    {
+        return Macro{steps, [this](std::string_view name) {
+            auto it = commands.find(name);
+            return it != commands.end() ? it->second : nullptr;
+        }, "AddText"};
+    }
+};
+
+TEST_F(Macro_Compiled, MergesAdjacentAppends)
+{
+    Macro macro = compile({{"AddText", {"a"}}, {"AddText", {"b"}}, {"ToUpper", {}}, {"AddText", {"c"}}});
+
+    ASSERT_THAT(macro.instructions().size(), Eq(3));
+    ASSERT_TRUE(macro.instructions()[0].append);
+    ASSERT_FALSE(macro.instructions()[1].append);
+}
+
+TEST_F(Macro_Compiled, SkipsUnknownCommands)
+{
+    Macro macro = compile({{"Dance", {}}, {"ToUpper", {}}});
+
+    ASSERT_THAT(macro.instructions().size(), Eq(1));
+}
+
+TEST_F(Macro_Compiled, ReplaysCommandsInOrder)
+{
+    Macro macro = compile({{"AddText", {"ab"}}, {"ToUpper", {}}, {"AddText", {"c"}}});
+
+    macro.play(console, 2);
+
+    ASSERT_THAT(doc.text(), StrEq("ABCABc"));
+}
+
+TEST_F(Macro_Compiled, ReplaysRecordedArguments)
+{
+    doc.add_text("abc");
+    Macro macro = compile({{"Find", {"c"}}});
+    EXPECT_CALL(terminal, get_line()).Times(0);
+    EXPECT_CALL(terminal, print(_)).Times(AnyNumber());
+    EXPECT_CALL(terminal, print("Found at 2 (line 1)")).Times(3);
+
+    macro.play(console, 3);
+}
+
+TEST_F(Macro_Compiled, ReplaysRepeatedAppendsAsOneEdit)
+{
+    Macro macro = compile({{"AddText", {"x"}}, {"AddText", {"y"}}});
+    EXPECT_CALL(terminal, print("Enter text:")).Times(1);
+
+    macro.play(console, 1000);
+
+    ASSERT_THAT(doc.length(), Eq(2000));
+    ASSERT_THAT(doc.text(0, 4), StrEq("xyxy"));
+}
+
+TEST_F(Macro_Compiled, ReadsFromConsoleAfterReplay)
+{
+    Macro macro = compile({{"ToUpper", {}}});
+    EXPECT_CALL(terminal, get_line()).WillOnce(Return("line"));
+
+    macro.play(console);
+
+    ASSERT_THAT(console.get_line(), StrEq("line"));
+}
+
+TEST(MacroConsole, CapturesLinesReadFromConsole)
+{
+    NiceMock<MockConsole> terminal;
+    MacroConsole console{terminal};
+    EXPECT_CALL(terminal, get_line()).WillOnce(Return("one")).WillOnce(Return("two")).WillOnce(Return("three"));
+
+    console.get_line();
+    console.start_capture();
+    console.get_line();
+    console.get_line();
+
+    ASSERT_THAT(console.stop_capture(), ElementsAre("two", "three"));
+}
@@ -9,6 +9,7 @@ class MockConsole : public Console
 public:
     MOCK_METHOD(std::string, get_line, (), (override));
     MOCK_METHOD(void, print, (const std::string&), (override));
+    MOCK_METHOD(void, flush, (), (override));
 };
 
 #endif // MOCK_CLIPBOARD_HPP
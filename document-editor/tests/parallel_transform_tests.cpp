@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "document.hpp"
+#include "parallel_transform.hpp"
+#include "thread_pool.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    // ASCII mixed with 2, 3 & 4-byte UTF-8 sequences
+    std::string sample_text(size_t size, unsigned seed = 42)
+    {
+        const std::string words[] = {"Lorem ", "IPSUM ", "dolor ", "zażółć ", "GĘŚLĄ ", "jaźń ", "✓ ", "日本語 ", "😀 ", "\n"};
+
+        std::mt19937 gen{seed};
+        std::uniform_int_distribution<size_t> word_distr(0, std::size(words) - 1);
+
+        std::string text;
+        while (text.size() < size)
+            text += words[word_distr(gen)];
+
+        return text;
+    }
+
+    // rope with many leaves of random sizes - ranges start in the middle of chunks
+    Rope fragmented_rope(const std::string& text)
+    {
+        std::mt19937 gen{665};
+        std::uniform_int_distribution<size_t> size_distr(1, 700);
+
+        Rope rope;
+        for (size_t pos = 0; pos < text.size();)
+        {
+            const size_t count = std::min(size_distr(gen), text.size() - pos);
+            rope.append(Rope{text.substr(pos, count)});
+            pos += count;
+        }
+
+        return rope;
+    }
+
+    bool is_utf8_continuation(char c)
+    {
+        return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+    }
+} // namespace
+
+TEST(ThreadPool, RunsSubmittedTasks)
+{
+    ThreadPool pool{4};
+    std::atomic<int> counter = 0;
+
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; ++i)
+        results.push_back(pool.submit([&counter, i] {
+            ++counter;
+            return i * i;
+        }));
+
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(results[i].get(), i * i);
+
+    ASSERT_EQ(counter, 100);
+}
+
+TEST(ThreadPool, PassesExceptionsToFuture)
+{
+    ThreadPool pool{2};
+
+    auto result = pool.submit([]() -> int { throw std::runtime_error("task failed"); });
+
+    ASSERT_THROW(result.get(), std::runtime_error);
+}
+
+TEST(ParallelTransform, NextUtf8BoundarySkipsContinuationBytes)
+{
+    const Rope text{std::string{"a😀b"}};
+
+    ASSERT_EQ(next_utf8_boundary(text, 0), 0);
+    ASSERT_EQ(next_utf8_boundary(text, 1), 1);
+    ASSERT_EQ(next_utf8_boundary(text, 2), 5);
+    ASSERT_EQ(next_utf8_boundary(text, 4), 5);
+    ASSERT_EQ(next_utf8_boundary(text, 6), 6);
+}
+
+TEST(ParallelTransform, UserTransformSeesWholeUtf8Sequences)
+{
+    const std::string text = sample_text(8 * 1024); // single leaf - every call of f gets a whole range
+    ThreadPool pool{3};
+
+    for (size_t chunk_size : {1, 2, 3, 5, 7, 64, 1000})
+    {
+        std::atomic<size_t> split_sequences = 0;
+        Document doc{text};
+
+        doc.transform(
+            [&](std::string_view chunk, char* out) {
+                if (is_utf8_continuation(chunk.front())) // ranges end where the next one starts
+                    ++split_sequences;
+                std::copy(chunk.begin(), chunk.end(), out);
+            },
+            pool, chunk_size);
+
+        ASSERT_EQ(split_sequences, 0) << "chunk size: " << chunk_size;
+        ASSERT_EQ(doc.text(), text) << "chunk size: " << chunk_size;
+    }
+}
+
+TEST(ParallelTransform, ToUpperMatchesSequentialPath)
+{
+    const std::string text = sample_text(3 * 1024 * 1024 + 17);
+    ThreadPool pool{4};
+
+    Document sequential{text};
+    sequential.to_upper();
+
+    Document parallel{text};
+    parallel.to_upper(pool);
+
+    ASSERT_EQ(parallel.length(), sequential.length());
+    ASSERT_TRUE(parallel.text() == sequential.text());
+}
+
+TEST(ParallelTransform, ToLowerMatchesSequentialPath)
+{
+    const std::string text = sample_text(3 * 1024 * 1024 + 17);
+    ThreadPool pool{4};
+
+    Document sequential{text};
+    sequential.to_lower();
+
+    Document parallel{text};
+    parallel.to_lower(pool);
+
+    ASSERT_TRUE(parallel.text() == sequential.text());
+}
+
+TEST(ParallelTransform, MatchesSequentialPathForFragmentedRopesAndSmallChunks)
+{
+    const std::string text = sample_text(200 * 1024, 7);
+    const Rope rope = fragmented_rope(text);
+    ThreadPool pool{4};
+
+    const auto rot13 = [](std::string_view chunk, char* out) {
+        for (char c : chunk)
+        {
+            if (c >= 'a' && c <= 'z')
+                c = static_cast<char>('a' + (c - 'a' + 13) % 26);
+            else if (c >= 'A' && c <= 'Z')
+                c = static_cast<char>('A' + (c - 'A' + 13) % 26);
+            *out++ = c;
+        }
+    };
+
+    const std::string expected = rope.transformed(rot13).str();
+
+    for (size_t chunk_size : {1, 3, 4, 511, 4096, 1 << 20})
+        ASSERT_EQ(parallel_transformed(rope, rot13, pool, chunk_size).str(), expected) << "chunk size: " << chunk_size;
+}
+
+TEST(ParallelTransform, ThrowsOnceEveryRangeHasFinished)
+{
+    ThreadPool pool{4};
+    std::atomic<bool> thrown = false;
+    std::atomic<int> finished = 0;
+
+    // the first range to start throws, the others are still writing when it does
+    const auto slow_or_throwing = [&](std::string_view chunk, char* out) {
+        if (!thrown.exchange(true))
+            throw std::runtime_error("transform failed");
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        std::copy(chunk.begin(), chunk.end(), out);
+        ++finished;
+    };
+
+    ASSERT_THROW(parallel_transformed(Rope{std::string(64, 'a')}, slow_or_throwing, pool, 8), std::runtime_error);
+    ASSERT_THAT(finished.load(), Eq(7));
+}
+
+TEST(ParallelTransform, EmptyText)
+{
+    ThreadPool pool{2};
+
+    Document doc;
+    doc.to_upper(pool);
+
+    ASSERT_EQ(doc.text(), "");
+}
+
+TEST(ParallelTransform, CanBeUndoneWithMemento)
+{
+    const std::string text = sample_text(512 * 1024);
+    ThreadPool pool{2};
+
+    Document doc{text};
+    auto memento = doc.create_memento();
+
+    doc.to_upper(pool);
+    doc.set_memento(memento);
+
+    ASSERT_TRUE(doc.text() == text);
+}
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "perfect_hash.hpp"
+
+using namespace ::testing;
+using namespace std::literals;
+
+namespace
+{
+    constexpr std::array<std::string_view, 5> keys = {"Print", "Paste", "Find", "FindAll", "F"};
+    constexpr PerfectHashTable<keys.size()> table{keys};
+
+    static_assert(table.find("FindAll") == 3);
+    static_assert(table.find("Replace") == table.npos);
+} // namespace
+
+TEST(PerfectHashTable, FindsEveryKey)
+{
+    for (size_t i = 0; i < keys.size(); ++i)
+        ASSERT_THAT(table.find(keys[i]), Eq(i));
+}
+
+TEST(PerfectHashTable, RejectsUnknownNames)
+{
+    ASSERT_THAT(table.find(""), Eq(table.npos));
+    ASSERT_THAT(table.find("Fin"), Eq(table.npos));
+    ASSERT_THAT(table.find("FindAllX"), Eq(table.npos));
+    ASSERT_THAT(table.find("print"), Eq(table.npos));
+}
+
+TEST(PerfectHashTable, FindsKeysInDynamicStrings)
+{
+    const std::string name = "Fi"s + "nd";
+
+    ASSERT_THAT(table.find(name), Eq(2));
+}
+
+TEST(PerfectHashTable, ThrowsOnDuplicateKeys)
+{
+    const std::array<std::string_view, 3> duplicates = {"Copy", "Paste", "Copy"};
+
+    ASSERT_THROW(PerfectHashTable<3>{duplicates}, std::invalid_argument);
+}
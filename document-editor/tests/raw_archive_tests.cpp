@@ -0,0 +1,56 @@
+#include <stdexcept>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "raw_archive.hpp"
+
+using namespace ::testing;
+
+TEST(RawArchive, RoundTripsStrings)
+{
+    std::string buffer;
+    RawOutputArchive oarchive{buffer};
+    oarchive(std::string{"first"}, std::string{}, std::string("with\0zero", 9));
+
+    std::string first, empty, third;
+    RawInputArchive iarchive{buffer};
+    iarchive(first, empty, third);
+
+    ASSERT_THAT(first, StrEq("first"));
+    ASSERT_THAT(empty, IsEmpty());
+    ASSERT_THAT(third, Eq(std::string("with\0zero", 9)));
+}
+
+TEST(RawArchive, WritesLengthPrefixedValues)
+{
+    std::string buffer;
+    RawOutputArchive{buffer}(std::string{"ab"});
+
+    ASSERT_THAT(buffer, Eq(std::string("\x02\0\0\0\0\0\0\0ab", 10)));
+}
+
+TEST(RawArchive, WritesRopeWithoutFlattening)
+{
+    Rope rope{std::string(100'000, 'a')};
+    rope.replace(50'000, 0, Rope{std::string{"middle"}});
+
+    std::string buffer;
+    RawOutputArchive{buffer}(rope);
+
+    std::string text;
+    RawInputArchive{buffer}(text);
+
+    ASSERT_TRUE(text == rope.str());
+}
+
+TEST(RawArchive, RejectsTruncatedBuffer)
+{
+    std::string buffer;
+    RawOutputArchive{buffer}(std::string{"text"});
+
+    std::string text;
+    ASSERT_THROW(RawInputArchive{std::string_view{buffer}.substr(0, 10)}(text), std::runtime_error);
+    ASSERT_THROW(RawInputArchive{std::string_view{buffer}.substr(0, 4)}(text), std::runtime_error);
+}
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "rope.hpp"
+
+using namespace ::testing;
+
+TEST(Rope_DefaultConstructed, IsEmpty)
+{
+    Rope rope;
+
+    ASSERT_THAT(rope.size(), Eq(0));
+    ASSERT_THAT(rope.str(), IsEmpty());
+}
+
+struct Rope_ValueConstructed : Test
+{
+    Rope rope{"abcdef"};
+};
+
+TEST_F(Rope_ValueConstructed, HoldsText)
+{
+    ASSERT_THAT(rope.str(), StrEq("abcdef"));
+    ASSERT_THAT(rope.size(), Eq(6));
+}
+
+TEST_F(Rope_ValueConstructed, Append)
+{
+    rope.append(Rope{"gh"});
+
+    ASSERT_THAT(rope.str(), StrEq("abcdefgh"));
+}
+
+TEST_F(Rope_ValueConstructed, InsertInTheMiddle)
+{
+    rope.insert(3, Rope{"XYZ"});
+
+    ASSERT_THAT(rope.str(), StrEq("abcXYZdef"));
+}
+
+TEST_F(Rope_ValueConstructed, Erase)
+{
+    rope.erase(1, 3);
+
+    ASSERT_THAT(rope.str(), StrEq("aef"));
+}
+
+TEST_F(Rope_ValueConstructed, EraseClampsCount)
+{
+    rope.erase(4, 100);
+
+    ASSERT_THAT(rope.str(), StrEq("abcd"));
+}
+
+TEST_F(Rope_ValueConstructed, Replace)
+{
+    rope.replace(0, 2, Rope{"xyz"});
+
+    ASSERT_THAT(rope.str(), StrEq("xyzcdef"));
+}
+
+TEST_F(Rope_ValueConstructed, PositionOutOfRangeThrows)
+{
+    ASSERT_THROW(rope.replace(7, 0, Rope{"x"}), std::out_of_range);
+    ASSERT_THROW(rope.at(6), std::out_of_range);
+}
+
+TEST_F(Rope_ValueConstructed, Substr)
+{
+    ASSERT_THAT(rope.substr(2, 3), StrEq("cde"));
+    ASSERT_THAT(rope.at(5), Eq('f'));
+}
+
+TEST_F(Rope_ValueConstructed, CopiesAreIndependent)
+{
+    Rope copy = rope;
+    copy.erase(0, 3);
+
+    ASSERT_THAT(rope.str(), StrEq("abcdef"));
+    ASSERT_THAT(copy.str(), StrEq("def"));
+}
+
+TEST(Rope_LargeText, IsSplitIntoChunks)
+{
+    std::string text(10 * Rope::max_chunk_size + 7, 'a');
+    Rope rope{text};
+
+    size_t chunks = 0;
+    rope.for_each_chunk([&](std::string_view chunk) {
+        ++chunks;
+        ASSERT_THAT(chunk.size(), Le(Rope::max_chunk_size));
+    });
+
+    ASSERT_THAT(chunks, Eq(11));
+    ASSERT_THAT(rope.str(), StrEq(text));
+}
+
+TEST(Rope_RandomEdits, MatchesStdString)
+{
+    std::mt19937 gen{665};
+    std::string expected;
+    Rope rope;
+
+    for (int i = 0; i < 5'000; ++i)
+    {
+        const size_t pos = std::uniform_int_distribution<size_t>(0, expected.size())(gen);
+        const size_t count = std::uniform_int_distribution<size_t>(0, 64)(gen);
+        const std::string text(std::uniform_int_distribution<size_t>(0, 2'000)(gen), static_cast<char>('a' + i % 26));
+
+        switch (i % 3)
+        {
+        case 0:
+            expected.insert(pos, text);
+            rope.insert(pos, Rope{text});
+            break;
+        case 1:
+            expected.erase(pos, count);
+            rope.erase(pos, count);
+            break;
+        case 2:
+            expected.replace(pos, count, text);
+            rope.replace(pos, count, Rope{text});
+            break;
+        }
+    }
+
+    ASSERT_THAT(rope.str(), StrEq(expected));
+    ASSERT_THAT(rope.height(), Le(40)); // stays balanced
+}
+
+TEST(Rope_Lines, LineStartAndLineOf)
+{
+    Rope rope{"first\nsecond\n\nfourth"};
+
+    ASSERT_THAT(rope.newlines(), Eq(3));
+    ASSERT_THAT(rope.line_start(0), Eq(0));
+    ASSERT_THAT(rope.line_start(1), Eq(6));
+    ASSERT_THAT(rope.line_start(2), Eq(13));
+    ASSERT_THAT(rope.line_start(3), Eq(14));
+    ASSERT_THROW(rope.line_start(4), std::out_of_range);
+
+    ASSERT_THAT(rope.line_of(0), Eq(0));
+    ASSERT_THAT(rope.line_of(5), Eq(0)); // the newline belongs to its line
+    ASSERT_THAT(rope.line_of(6), Eq(1));
+    ASSERT_THAT(rope.line_of(13), Eq(2));
+    ASSERT_THAT(rope.line_of(rope.size()), Eq(3));
+    ASSERT_THROW(rope.line_of(rope.size() + 1), std::out_of_range);
+}
+
+TEST(Rope_Lines, EmptyRopeHasSingleLine)
+{
+    Rope rope;
+
+    ASSERT_THAT(rope.newlines(), Eq(0));
+    ASSERT_THAT(rope.line_start(0), Eq(0));
+    ASSERT_THAT(rope.line_of(0), Eq(0));
+}
+
+TEST(Rope_Lines, IndexFollowsRandomEdits)
+{
+    std::mt19937 gen{665};
+    std::string expected;
+    Rope rope;
+
+    const auto line_starts = [](const std::string& text) {
+        std::vector<size_t> starts{0};
+        for (size_t pos = 0; pos < text.size(); ++pos)
+            if (text[pos] == '\n')
+                starts.push_back(pos + 1);
+        return starts;
+    };
+
+    for (int i = 0; i < 2'000; ++i)
+    {
+        const size_t pos = std::uniform_int_distribution<size_t>(0, expected.size())(gen);
+        const size_t count = std::uniform_int_distribution<size_t>(0, 300)(gen);
+
+        std::string text(std::uniform_int_distribution<size_t>(0, 1'000)(gen), 'x');
+        for (char& c : text)
+            if (std::uniform_int_distribution<int>(0, 20)(gen) == 0)
+                c = '\n';
+
+        expected.replace(pos, count, text);
+        rope.replace(pos, count, Rope{text});
+
+        if (i % 50 == 0)
+        {
+            const auto starts = line_starts(expected);
+            ASSERT_THAT(rope.newlines(), Eq(starts.size() - 1));
+
+            for (size_t line = 0; line < starts.size(); ++line)
+                ASSERT_THAT(rope.line_start(line), Eq(starts[line]));
+
+            for (size_t p = 0; p <= expected.size(); p += 37)
+            {
+                const size_t line = std::upper_bound(starts.begin(), starts.end(), p) - starts.begin() - 1;
+                ASSERT_THAT(rope.line_of(p), Eq(line));
+            }
+        }
+    }
+}
+
+TEST(Rope_Words, CountsWordsAcrossChunks)
+{
+    const std::string word(Rope::max_chunk_size + 5, 'w');
+    const Rope rope{word + " " + word + "\n" + word};
+
+    ASSERT_THAT(rope.words(), Eq(3));
+    ASSERT_THAT(Rope{}.words(), Eq(0));
+}
+
+TEST(Rope_Words, FollowRandomEdits)
+{
+    std::mt19937 gen{17};
+    std::string expected;
+    Rope rope;
+
+    const auto count_words = [](const std::string& text) {
+        size_t words = 0;
+        for (size_t pos = 0; pos < text.size(); ++pos)
+        {
+            const bool space = text[pos] == ' ' || text[pos] == '\n';
+            const bool previous_space = pos == 0 || text[pos - 1] == ' ' || text[pos - 1] == '\n';
+            words += (!space && previous_space);
+        }
+        return words;
+    };
+
+    for (int i = 0; i < 2'000; ++i)
+    {
+        const size_t pos = std::uniform_int_distribution<size_t>(0, expected.size())(gen);
+        const size_t count = std::uniform_int_distribution<size_t>(0, 300)(gen);
+
+        std::string text(std::uniform_int_distribution<size_t>(0, 1'000)(gen), 'x');
+        for (char& c : text)
+        {
+            const int kind = std::uniform_int_distribution<int>(0, 20)(gen);
+            c = (kind == 0) ? '\n' : (kind < 4) ? ' ' : c;
+        }
+
+        expected.replace(pos, count, text);
+        rope.replace(pos, count, Rope{text});
+
+        if (i % 50 == 0)
+        {
+            ASSERT_THAT(rope.words(), Eq(count_words(expected)));
+        }
+    }
+}
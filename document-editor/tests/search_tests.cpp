@@ -0,0 +1,166 @@
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "document.hpp"
+#include "search.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    // small alphabet - many partial matches & candidates rejected by memcmp
+    std::string random_text(std::mt19937& gen, size_t size, char last_letter = 'c')
+    {
+        std::uniform_int_distribution<int> letter_distr('a', last_letter);
+
+        std::string text(size, '\0');
+        for (char& c : text)
+            c = static_cast<char>(letter_distr(gen));
+
+        return text;
+    }
+
+    std::vector<size_t> naive_find_all(const std::string& text, const std::string& pattern)
+    {
+        std::vector<size_t> occurrences;
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + pattern.size()))
+            occurrences.push_back(pos);
+
+        return occurrences;
+    }
+
+    Rope fragmented_rope(std::mt19937& gen, const std::string& text)
+    {
+        std::uniform_int_distribution<size_t> size_distr(1, 40);
+
+        Rope rope;
+        for (size_t pos = 0; pos < text.size();)
+        {
+            const size_t count = std::min(size_distr(gen), text.size() - pos);
+            rope.append(Rope{text.substr(pos, count)});
+            pos += count;
+        }
+
+        return rope;
+    }
+} // namespace
+
+struct Search : TestWithParam<SimdLevel>
+{
+    std::mt19937 gen{665};
+};
+
+TEST_P(Search, FindsFirstOccurrence)
+{
+    const std::string text = "The quick brown fox jumps over the lazy dog - the end";
+    const Searcher searcher{"the", GetParam()};
+
+    ASSERT_THAT(searcher.find(text), Eq(31));
+    ASSERT_THAT(searcher.find(text, 32), Eq(46));
+    ASSERT_THAT(searcher.find(text, 47), Eq(std::string::npos));
+    ASSERT_THAT(Searcher("cat", GetParam()).find(text), Eq(std::string::npos));
+    ASSERT_THAT(Searcher(text + "!", GetParam()).find(text), Eq(std::string::npos));
+}
+
+TEST_P(Search, EmptyPatternThrows)
+{
+    ASSERT_THROW(Searcher("", GetParam()), std::invalid_argument);
+}
+
+TEST_P(Search, MatchesStdStringFind)
+{
+    for (int i = 0; i < 300; ++i)
+    {
+        const std::string text = random_text(gen, std::uniform_int_distribution<size_t>(0, 300)(gen));
+        const std::string pattern = random_text(gen, std::uniform_int_distribution<size_t>(1, 8)(gen));
+        const size_t from = std::uniform_int_distribution<size_t>(0, text.size())(gen);
+
+        ASSERT_THAT(Searcher(pattern, GetParam()).find(text, from), Eq(text.find(pattern, from)))
+            << "text: " << text << " pattern: " << pattern << " from: " << from;
+    }
+}
+
+TEST_P(Search, FindsOccurrencesSpanningChunks)
+{
+    for (int i = 0; i < 200; ++i)
+    {
+        const std::string text = random_text(gen, std::uniform_int_distribution<size_t>(0, 2'000)(gen));
+        const std::string pattern = random_text(gen, std::uniform_int_distribution<size_t>(1, 60)(gen), 'b');
+        const Rope rope = fragmented_rope(gen, text);
+        const Searcher searcher{pattern, GetParam()};
+
+        ASSERT_THAT(searcher.find_all(rope), ContainerEq(naive_find_all(text, pattern))) << "pattern: " << pattern;
+
+        const size_t from = std::uniform_int_distribution<size_t>(0, text.size())(gen);
+        ASSERT_THAT(searcher.find(rope, from), Eq(text.find(pattern, from))) << "pattern: " << pattern;
+    }
+}
+
+TEST_P(Search, OccurrencesDoNotOverlap)
+{
+    const Searcher searcher{"aa", GetParam()};
+
+    ASSERT_THAT(searcher.find_all(Rope{"aaaaa"}), ElementsAre(0, 2));
+}
+
+INSTANTIATE_TEST_SUITE_P(SimdLevels, Search, Values(SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2));
+
+struct Document_Search : Test
+{
+    Document doc{"error: disk full\ninfo: retry\nerror: disk full\n"};
+};
+
+TEST_F(Document_Search, Find)
+{
+    ASSERT_THAT(doc.find("disk"), Eq(7));
+    ASSERT_THAT(doc.find("disk", 8), Eq(36));
+    ASSERT_THAT(doc.find("warning"), Eq(std::string::npos));
+}
+
+TEST_F(Document_Search, FindAll)
+{
+    ASSERT_THAT(doc.find_all("error"), ElementsAre(0, 29));
+}
+
+TEST_F(Document_Search, ReplaceAll)
+{
+    ASSERT_THAT(doc.replace_all("disk full", "ok"), Eq(2));
+    ASSERT_THAT(doc.text(), StrEq("error: ok\ninfo: retry\nerror: ok\n"));
+
+    ASSERT_THAT(doc.replace_all("missing", "x"), Eq(0));
+}
+
+TEST_F(Document_Search, ReplaceAllCanBeUndone)
+{
+    auto memento = doc.create_memento();
+
+    doc.replace_all("error", "ERROR!");
+    doc.set_memento(memento);
+
+    ASSERT_THAT(doc.text(), StrEq("error: disk full\ninfo: retry\nerror: disk full\n"));
+}
+
+TEST(Document_ReplaceAll, MatchesNaiveReplacement)
+{
+    std::mt19937 gen{42};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        std::string text = random_text(gen, std::uniform_int_distribution<size_t>(0, 5'000)(gen));
+        const std::string pattern = random_text(gen, std::uniform_int_distribution<size_t>(1, 4)(gen));
+        const std::string replacement = random_text(gen, std::uniform_int_distribution<size_t>(0, 6)(gen), 'z');
+
+        Document doc{text};
+        doc.replace_all(pattern, replacement);
+
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + replacement.size()))
+            text.replace(pos, pattern.size(), replacement);
+
+        ASSERT_THAT(doc.text(), StrEq(text));
+    }
+}
@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "sequence_crdt.hpp"
+#include "undo_history.hpp"
+
+using namespace ::testing;
+
+struct SequenceCrdt_LocalEdits : Test
+{
+    Document doc{"abc"};
+    SequenceCrdt crdt{doc, 1};
+};
+
+TEST_F(SequenceCrdt_LocalEdits, InsertBecomesOpAfterPrecedingCharacter)
+{
+    doc.insert(1, "xy");
+
+    const auto ops = crdt.take_local_ops();
+
+    ASSERT_THAT(ops, SizeIs(1));
+    ASSERT_THAT(ops[0].kind, Eq(CrdtOp::Kind::Insert));
+    ASSERT_THAT(ops[0].id, Eq(CrdtId{4, 1})); // after the base text ids 1..3
+    ASSERT_THAT(ops[0].origin, Eq(CrdtId{1, 0}));
+    ASSERT_THAT(ops[0].text, StrEq("xy"));
+    ASSERT_THAT(crdt.take_local_ops(), IsEmpty());
+}
+
+TEST_F(SequenceCrdt_LocalEdits, TypingIsCoalescedIntoOneOp)
+{
+    for (char c : std::string{"hello"})
+        doc.add_text(std::string(1, c));
+
+    const auto ops = crdt.take_local_ops();
+
+    ASSERT_THAT(ops, SizeIs(1));
+    ASSERT_THAT(ops[0].text, StrEq("hello"));
+    ASSERT_THAT(crdt.run_count(), Eq(3u)); // head, base text & the typed run
+}
+
+TEST_F(SequenceCrdt_LocalEdits, BackspacingIsCoalescedIntoOneOp)
+{
+    doc.erase(2, 1);
+    doc.erase(1, 1);
+    doc.erase(0, 1);
+
+    const auto ops = crdt.take_local_ops();
+
+    ASSERT_THAT(ops, ElementsAre(CrdtOp{CrdtOp::Kind::Erase, CrdtId{1, 0}, CrdtId{}, 3, {}}));
+}
+
+TEST_F(SequenceCrdt_LocalEdits, ReplaceIsEraseAndInsert)
+{
+    doc.replace(1, 1, "B");
+
+    const auto ops = crdt.take_local_ops();
+
+    ASSERT_THAT(ops, SizeIs(2));
+    ASSERT_THAT(ops[0], Eq(CrdtOp{CrdtOp::Kind::Erase, CrdtId{2, 0}, CrdtId{}, 1, {}}));
+    ASSERT_THAT(ops[1].kind, Eq(CrdtOp::Kind::Insert));
+    ASSERT_THAT(ops[1].origin, Eq(CrdtId{1, 0}));
+}
+
+TEST(SequenceCrdt_SiteZero, IsRejected)
+{
+    Document doc;
+
+    ASSERT_THROW(SequenceCrdt(doc, 0), std::invalid_argument);
+}
+
+struct SequenceCrdt_TwoReplicas : Test
+{
+    Document doc_a{"abc"};
+    Document doc_b{"abc"};
+    SequenceCrdt a{doc_a, 1};
+    SequenceCrdt b{doc_b, 2};
+
+    void exchange()
+    {
+        const auto from_a = a.take_local_ops();
+        const auto from_b = b.take_local_ops();
+        a.merge(encode_ops(from_b));
+        b.merge(encode_ops(from_a));
+    }
+};
+
+TEST_F(SequenceCrdt_TwoReplicas, ConcurrentInsertsAtOnePlaceConverge)
+{
+    doc_a.insert(1, "XX");
+    doc_b.insert(1, "YY");
+
+    exchange();
+
+    ASSERT_THAT(doc_a.text(), StrEq(doc_b.text()));
+    ASSERT_THAT(doc_a.text(), StrEq("aYYXXbc")); // the higher id goes first
+}
+
+TEST_F(SequenceCrdt_TwoReplicas, InsertIntoConcurrentlyErasedTextIsKept)
+{
+    doc_a.erase(0, 3);
+    doc_b.insert(2, "-");
+
+    exchange();
+
+    ASSERT_THAT(doc_a.text(), StrEq("-"));
+    ASSERT_THAT(doc_b.text(), StrEq("-"));
+}
+
+TEST_F(SequenceCrdt_TwoReplicas, MergedOpsAreNotSentBack)
+{
+    doc_a.add_text("d");
+    exchange();
+
+    ASSERT_THAT(b.take_local_ops(), IsEmpty());
+    ASSERT_THAT(doc_b.text(), StrEq("abcd"));
+}
+
+TEST_F(SequenceCrdt_TwoReplicas, MergingTwiceChangesNothing)
+{
+    doc_a.insert(0, ">");
+    doc_a.erase(2, 1);
+    const std::string batch = encode_ops(a.take_local_ops());
+
+    b.merge(batch);
+    b.merge(batch);
+
+    ASSERT_THAT(doc_b.text(), StrEq(">ac"));
+}
+
+TEST_F(SequenceCrdt_TwoReplicas, OpWaitsForTheCharactersItRefersTo)
+{
+    doc_a.add_text("de");
+    const auto insert = a.take_local_ops();
+    doc_a.erase(3, 1);
+    const auto erase = a.take_local_ops();
+
+    b.merge(erase);
+    ASSERT_THAT(b.waiting_ops(), Eq(1u));
+    ASSERT_THAT(doc_b.text(), StrEq("abc"));
+
+    b.merge(insert);
+    ASSERT_THAT(b.waiting_ops(), Eq(0u));
+    ASSERT_THAT(doc_b.text(), StrEq("abce"));
+}
+
+TEST_F(SequenceCrdt_TwoReplicas, UndoIsSentAsEdit)
+{
+    auto before = doc_a.create_memento();
+    doc_a.add_text("def");
+    exchange();
+
+    doc_a.set_memento(before);
+    exchange();
+
+    ASSERT_THAT(doc_b.text(), StrEq("abc"));
+}
+
+TEST_F(SequenceCrdt_TwoReplicas, UndoAfterMergeKeepsRemoteEdits)
+{
+    UndoHistory history_a{doc_a};
+    history_a.checkpoint();
+    doc_a.add_text("A-line\n");
+
+    doc_b.add_text("B's long paragraph\n");
+    if (a.merge(encode_ops(b.take_local_ops())))
+        history_a.clear(); // as the editor does after merging
+
+    ASSERT_FALSE(history_a.undo());
+    b.merge(encode_ops(a.take_local_ops()));
+
+    ASSERT_THAT(doc_a.text(), HasSubstr("B's long paragraph\n"));
+    ASSERT_THAT(doc_b.text(), StrEq(doc_a.text()));
+}
+
+TEST_F(SequenceCrdt_TwoReplicas, MergingKnownOpsLeavesTheDocumentUnchanged)
+{
+    doc_a.add_text("d");
+    const std::string batch = encode_ops(a.take_local_ops());
+
+    ASSERT_TRUE(b.merge(batch));
+    ASSERT_FALSE(b.merge(batch));
+}
+
+TEST(SequenceCrdt_ShuffledDelivery, ReplicasConverge)
+{
+    constexpr int replica_count = 4;
+    constexpr int rounds = 300;
+    std::mt19937 rng{7};
+
+    struct Replica
+    {
+        Document doc{"the quick brown fox"};
+        std::unique_ptr<SequenceCrdt> crdt;
+        std::vector<std::string> inbox;
+    };
+
+    std::vector<Replica> replicas(replica_count);
+    for (int i = 0; i < replica_count; ++i)
+        replicas[i].crdt = std::make_unique<SequenceCrdt>(replicas[i].doc, i + 1);
+
+    auto deliver_one = [&](Replica& replica) {
+        const size_t i = std::uniform_int_distribution<size_t>{0, replica.inbox.size() - 1}(rng);
+        replica.crdt->merge(replica.inbox[i]);
+        if (rng() % 4 != 0) // some batches are delivered twice
+            replica.inbox.erase(replica.inbox.begin() + static_cast<std::ptrdiff_t>(i));
+    };
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (int i = 0; i < replica_count; ++i)
+        {
+            Document& doc = replicas[i].doc;
+            const size_t pos = std::uniform_int_distribution<size_t>{0, doc.length()}(rng);
+            if (rng() % 3 == 0 && pos < doc.length())
+                doc.erase(pos, 1 + rng() % 4);
+            else
+                doc.insert(pos, std::string(1 + rng() % 3, static_cast<char>('a' + rng() % 26)));
+
+            const std::string batch = encode_ops(replicas[i].crdt->take_local_ops());
+            for (int j = 0; j < replica_count; ++j)
+            {
+                if (j != i)
+                    replicas[j].inbox.push_back(batch);
+            }
+        }
+
+        for (Replica& replica : replicas)
+        {
+            for (int k = rng() % 3; k > 0 && !replica.inbox.empty(); --k)
+                deliver_one(replica);
+        }
+    }
+
+    for (Replica& replica : replicas)
+    {
+        while (!replica.inbox.empty())
+            deliver_one(replica);
+    }
+
+    for (const Replica& replica : replicas)
+    {
+        ASSERT_THAT(replica.crdt->waiting_ops(), Eq(0u));
+        ASSERT_THAT(replica.doc.text(), StrEq(replicas[0].doc.text()));
+    }
+}
+
+TEST(SequenceCrdt_Codec, OpsRoundTrip)
+{
+    const std::vector<CrdtOp> ops{
+        {CrdtOp::Kind::Insert, CrdtId{1000, 3}, CrdtId{999, 3}, 5, "hello"},
+        {CrdtOp::Kind::Erase, CrdtId{12, 0}, CrdtId{}, 300, {}},
+        {CrdtOp::Kind::Insert, CrdtId{1ull << 40, UINT32_MAX}, CrdtId{}, 1, "x"},
+    };
+
+    const std::string batch = encode_ops(ops);
+
+    ASSERT_THAT(decode_ops(batch), ContainerEq(ops));
+    ASSERT_THAT(encode_ops({ops[0]}).size(), Le(ops[0].text.size() + 8)); // typed text costs a few bytes more
+}
+
+TEST(SequenceCrdt_Codec, MalformedBatchIsRejected)
+{
+    const std::string batch = encode_ops({{CrdtOp::Kind::Insert, CrdtId{5, 1}, CrdtId{4, 1}, 3, "abc"}});
+
+    ASSERT_THROW(decode_ops(batch.substr(0, batch.size() - 1)), std::runtime_error);
+    ASSERT_THROW(decode_ops(batch + "x"), std::runtime_error);
+    ASSERT_THROW(decode_ops("\x01\x07"), std::runtime_error);
+}
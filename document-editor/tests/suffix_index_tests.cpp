@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "document.hpp"
+#include "suffix_index.hpp"
+#include "thread_pool.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    std::string random_text(std::mt19937& gen, size_t size, char last_letter)
+    {
+        std::uniform_int_distribution<int> letter_distr('a', last_letter);
+
+        std::string text(size, '\0');
+        for (char& c : text)
+            c = static_cast<char>(letter_distr(gen));
+
+        return text;
+    }
+
+    std::vector<size_t> naive_occurrences(const std::string& text, const std::string& pattern)
+    {
+        std::vector<size_t> occurrences;
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+            occurrences.push_back(pos);
+
+        return occurrences;
+    }
+} // namespace
+
+TEST(SuffixIndex, SortsSuffixes)
+{
+    SuffixIndex index{Rope{"banana"}};
+
+    ASSERT_THAT(index.suffixes(), ElementsAre(5, 3, 1, 0, 4, 2));
+}
+
+TEST(SuffixIndex, MatchesNaiveSuffixSort)
+{
+    std::mt19937 gen{665};
+
+    for (int i = 0; i < 300; ++i)
+    {
+        const std::string text = random_text(gen, std::uniform_int_distribution<size_t>(0, 3'000)(gen), i % 2 ? 'b' : 'z');
+
+        std::vector<int32_t> expected(text.size());
+        for (size_t pos = 0; pos < text.size(); ++pos)
+            expected[pos] = static_cast<int32_t>(pos);
+        std::sort(expected.begin(), expected.end(), [&text](int32_t l, int32_t r) {
+            return std::string_view{text}.substr(l) < std::string_view{text}.substr(r);
+        });
+
+        ASSERT_THAT(SuffixIndex{Rope{text}}.suffixes(), ContainerEq(expected)) << "text: " << text;
+    }
+}
+
+TEST(SuffixIndex, TreatsBytesAsUnsigned)
+{
+    const std::string text = "a\xC3\xA9" "b\x7F\xFF" "z";
+    SuffixIndex index{Rope{text}};
+
+    ASSERT_THAT(index.count("\xC3\xA9"), Eq(1));
+    ASSERT_THAT(index.occurrences("\xFF"), ElementsAre(5));
+}
+
+TEST(SuffixIndex, FindsAllOccurrences)
+{
+    std::mt19937 gen{42};
+    const std::string text = random_text(gen, 20'000, 'c');
+    SuffixIndex index{Rope{text}};
+
+    for (int i = 0; i < 200; ++i)
+    {
+        const std::string pattern = random_text(gen, std::uniform_int_distribution<size_t>(1, 8)(gen), 'c');
+        const auto expected = naive_occurrences(text, pattern);
+
+        ASSERT_THAT(index.count(pattern), Eq(expected.size()));
+        ASSERT_THAT(index.occurrences(pattern), ContainerEq(expected));
+
+        const size_t from = std::uniform_int_distribution<size_t>(0, text.size())(gen);
+        ASSERT_THAT(index.find(pattern, from), Eq(text.find(pattern, from)));
+    }
+}
+
+TEST(SuffixIndex, ReportsMemory)
+{
+    SuffixIndex index{Rope{std::string(1000, 'x')}};
+
+    ASSERT_THAT(index.memory_usage(), Ge(1000 + 1000 * sizeof(int32_t)));
+}
+
+struct Document_Index : Test
+{
+    Document doc{"one two three two one\n"};
+};
+
+TEST_F(Document_Index, IsBuiltOnRequest)
+{
+    ASSERT_FALSE(doc.has_index());
+    ASSERT_THAT(doc.index_memory(), Eq(0));
+
+    doc.build_index();
+
+    ASSERT_TRUE(doc.has_index());
+    ASSERT_THAT(doc.index_memory(), Gt(0));
+    ASSERT_THAT(doc.count("two"), Eq(2));
+    ASSERT_THAT(doc.find("one", 1), Eq(18));
+    ASSERT_THAT(doc.find_all("o"), ElementsAre(0, 6, 16, 18));
+}
+
+TEST_F(Document_Index, SurvivesAppends)
+{
+    doc.build_index();
+
+    doc.add_text("three o");
+    doc.add_text("ne");
+
+    ASSERT_TRUE(doc.has_index());
+    ASSERT_THAT(doc.count("three"), Eq(2));
+    ASSERT_THAT(doc.find_all("one"), ElementsAre(0, 18, 28));
+    ASSERT_THAT(doc.find("one", 19), Eq(28));
+    ASSERT_THAT(doc.count("\nthree"), Eq(1)); // spans the end of the indexed text
+}
+
+TEST_F(Document_Index, IsDroppedByEditsOfIndexedText)
+{
+    doc.build_index();
+
+    doc.insert(0, "zero ");
+
+    ASSERT_FALSE(doc.has_index());
+    ASSERT_THAT(doc.find_all("one"), ElementsAre(5, 23));
+}
+
+TEST_F(Document_Index, IsDroppedByLongAppends)
+{
+    doc.build_index();
+
+    doc.add_text(std::string(Document::max_unindexed_tail + 1, 'x'));
+
+    ASSERT_FALSE(doc.has_index());
+}
+
+TEST_F(Document_Index, IsDroppedWhenMementoIsRestored)
+{
+    auto memento = doc.create_memento();
+    doc.add_text("four");
+    doc.build_index();
+
+    doc.set_memento(memento);
+
+    ASSERT_FALSE(doc.has_index());
+    ASSERT_THAT(doc.count("four"), Eq(0));
+}
+
+TEST(Document_IndexedSearch, MatchesScanningSearch)
+{
+    std::mt19937 gen{7};
+    Document indexed{random_text(gen, 50'000, 'c')};
+    indexed.build_index();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        if (i % 10 == 0)
+            indexed.add_text(random_text(gen, 100, 'c'));
+
+        Document scanned{indexed.text()};
+        const std::string pattern = random_text(gen, std::uniform_int_distribution<size_t>(1, 6)(gen), 'c');
+        const size_t from = std::uniform_int_distribution<size_t>(0, scanned.length())(gen);
+
+        ASSERT_TRUE(indexed.has_index());
+        ASSERT_THAT(indexed.find_all(pattern), ContainerEq(scanned.find_all(pattern)));
+        ASSERT_THAT(indexed.count(pattern), Eq(scanned.count(pattern)));
+        ASSERT_THAT(indexed.find(pattern, from), Eq(scanned.find(pattern, from)));
+    }
+}
+
+TEST(Document_IndexedSearch, IndexIsBuiltOnThreadPool)
+{
+    ThreadPool pool{2};
+    Document doc{std::string(100'000, 'a') + "needle"};
+
+    doc.build_index(pool);
+
+    ASSERT_THAT(doc.find("needle"), Eq(100'000)); // correct before and after the index is ready
+
+    while (!doc.has_index())
+        std::this_thread::yield();
+
+    ASSERT_THAT(doc.find("needle"), Eq(100'000));
+    ASSERT_THAT(doc.count("aa"), Eq(99'999));
+}
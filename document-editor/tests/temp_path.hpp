@@ -0,0 +1,17 @@
+#ifndef TEMP_PATH_HPP
+#define TEMP_PATH_HPP
+
+#include <filesystem>
+#include <string>
+
+#include <gtest/gtest.h>
+
+// file in the temporary directory named after the running test - extension e.g. ".txt"
+inline std::filesystem::path test_temp_path(const std::string& extension)
+{
+    const std::string test_name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+
+    return std::filesystem::temp_directory_path() / ("document-editor-" + test_name + extension);
+}
+
+#endif // TEMP_PATH_HPP
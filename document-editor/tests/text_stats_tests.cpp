@@ -0,0 +1,78 @@
+#include <random>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "text_stats.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    size_t count_words(const std::string& text)
+    {
+        size_t words = 0;
+        bool previous_space = true;
+        for (char c : text)
+        {
+            const bool space = c == ' ' || (c >= '\t' && c <= '\r');
+            words += (!space && previous_space);
+            previous_space = space;
+        }
+
+        return words;
+    }
+} // namespace
+
+struct TextStatsCounting : TestWithParam<SimdLevel>
+{
+};
+
+TEST_P(TextStatsCounting, CountsWordsAndNewlines)
+{
+    const TextStats stats = count_text_stats("The quick  brown\tfox\njumps over\r\nthe lazy dog\n", GetParam());
+
+    ASSERT_THAT(stats.words, Eq(9));
+    ASSERT_THAT(stats.newlines, Eq(3));
+    ASSERT_TRUE(stats.starts_in_word);
+    ASSERT_FALSE(stats.ends_in_word);
+}
+
+TEST_P(TextStatsCounting, Utf8SequencesArePartsOfWords)
+{
+    const TextStats stats = count_text_stats("Zażółć gęślą jaźń - Ünïcödé ✓ 日本語 😀 Zażółć gęślą jaźń", GetParam());
+
+    ASSERT_THAT(stats.words, Eq(11));
+}
+
+TEST_P(TextStatsCounting, MatchesScalarCountOnRandomText)
+{
+    std::mt19937 gen{42};
+    const std::string alphabet = "ab \n\t\x80\xff\v\f\r!";
+
+    for (size_t size : {1, 15, 16, 17, 31, 32, 33, 100, 1000})
+    {
+        std::string text(size, ' ');
+        for (char& c : text)
+            c = alphabet[std::uniform_int_distribution<size_t>(0, alphabet.size() - 1)(gen)];
+
+        const TextStats stats = count_text_stats(text, GetParam());
+
+        ASSERT_THAT(stats.words, Eq(count_words(text))) << "size " << size;
+        ASSERT_THAT(stats.newlines, Eq(std::count(text.begin(), text.end(), '\n'))) << "size " << size;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(SimdLevels, TextStatsCounting, Values(SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2));
+
+TEST(TextStats, CombiningCountsWordSpanningBoundaryOnce)
+{
+    const TextStats joined = count_text_stats("one tw") + count_text_stats("o three");
+    const TextStats separate = count_text_stats("one two ") + count_text_stats("three");
+
+    ASSERT_THAT(joined.words, Eq(3));
+    ASSERT_THAT(separate.words, Eq(3));
+    ASSERT_TRUE(joined.starts_in_word);
+    ASSERT_TRUE(joined.ends_in_word);
+}
@@ -0,0 +1,144 @@
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "undo_history.hpp"
+
+using namespace ::testing;
+
+struct UndoHistory_Editing : Test
+{
+    Document doc{"abc"};
+    UndoHistory history{doc};
+
+    void edit(const std::string& text)
+    {
+        history.checkpoint();
+        doc.add_text(text);
+    }
+};
+
+TEST_F(UndoHistory_Editing, UndoesAndRedoesEdits)
+{
+    edit("d");
+    edit("e");
+
+    ASSERT_TRUE(history.undo());
+    ASSERT_THAT(doc.text(), StrEq("abcd"));
+    ASSERT_TRUE(history.undo());
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+    ASSERT_FALSE(history.undo());
+
+    ASSERT_TRUE(history.redo());
+    ASSERT_TRUE(history.redo());
+    ASSERT_THAT(doc.text(), StrEq("abcde"));
+    ASSERT_FALSE(history.redo());
+}
+
+TEST_F(UndoHistory_Editing, CheckpointDropsRedoEntries)
+{
+    edit("d");
+    history.undo();
+    edit("x");
+
+    ASSERT_FALSE(history.can_redo());
+    ASSERT_TRUE(history.undo());
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(UndoHistory_Editing, ClearDropsAllEntries)
+{
+    edit("d");
+    edit("e");
+    history.undo();
+
+    history.clear();
+
+    ASSERT_FALSE(history.can_undo());
+    ASSERT_FALSE(history.can_redo());
+    ASSERT_THAT(history.stats().bytes_used, Eq(0u));
+    ASSERT_THAT(doc.text(), StrEq("abcd"));
+}
+
+TEST_F(UndoHistory_Editing, SkipsCheckpointsWithoutChanges)
+{
+    edit("d");
+    history.checkpoint();
+
+    ASSERT_TRUE(history.undo());
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(UndoHistory_Editing, ReportsEntriesAndLatency)
+{
+    edit("d");
+    history.checkpoint();
+    doc.erase(0, 2);
+    history.undo();
+
+    const UndoHistoryStats stats = history.stats();
+
+    ASSERT_THAT(stats.entries, Eq(2));
+    ASSERT_THAT(stats.bytes_used, Gt(0));
+    ASSERT_THAT(stats.undo_p50, Gt(std::chrono::nanoseconds{0}));
+    ASSERT_THAT(stats.undo_p99, Ge(stats.undo_p50));
+}
+
+TEST(UndoHistory, CompressesOlderEntries)
+{
+    Document doc;
+    UndoHistory history{doc, UndoHistory::default_byte_budget, 2};
+
+    for (int i = 0; i < 10; ++i)
+    {
+        history.checkpoint();
+        doc.replace(0, doc.length(), std::string(1000, 'a' + i));
+    }
+
+    const UndoHistoryStats stats = history.stats();
+
+    ASSERT_THAT(stats.entries, Eq(10));
+    ASSERT_THAT(stats.compression_ratio, Gt(2.0));
+}
+
+TEST(UndoHistory, DropsOldestEntriesOverBudget)
+{
+    Document doc{std::string(1000, 'a')};
+    UndoHistory history{doc, 5'000};
+
+    for (int i = 1; i < 100; ++i)
+    {
+        history.checkpoint();
+        doc.replace(0, doc.length(), std::string(1000, 'a' + i % 26));
+    }
+
+    ASSERT_THAT(history.stats().bytes_used, Le(5'000));
+
+    size_t undone = 0;
+    while (history.undo())
+        ++undone;
+
+    ASSERT_THAT(undone, Lt(99));
+    ASSERT_THAT(doc.text(), StrEq(std::string(1000, 'a' + (99 - undone) % 26)));
+}
+
+TEST(UndoHistory, UndoesAcrossCompressedEntries)
+{
+    Document doc{"start"};
+    UndoHistory history{doc, UndoHistory::default_byte_budget, 1};
+
+    for (int i = 0; i < 5; ++i)
+    {
+        history.checkpoint();
+        doc.replace(0, doc.length(), std::string(100, 'a' + i));
+    }
+
+    ASSERT_THAT(history.stats().compression_ratio, Gt(1.0));
+
+    while (history.undo())
+    {
+    }
+
+    ASSERT_THAT(doc.text(), StrEq("start"));
+}
@@ -0,0 +1,99 @@
+#include <snake/batch_kernel.hpp>
+#include <snake/snake.hpp>
+
+#include <bit>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t snakes_count = 4096;
+    constexpr size_t rounds = 2'000;
+    constexpr int board_size = 1000;
+
+    struct Batch
+    {
+        std::vector<int> head_x;
+        std::vector<int> head_y;
+        std::vector<Direction> directions;
+    };
+
+    Batch random_batch()
+    {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<> coord_distr(1, board_size - 1);
+        std::uniform_int_distribution<> direction_distr(0, 3);
+
+        Batch batch;
+        for (size_t i = 0; i < snakes_count; ++i)
+        {
+            batch.head_x.push_back(coord_distr(gen));
+            batch.head_y.push_back(coord_distr(gen));
+            batch.directions.push_back(static_cast<Direction>(direction_distr(gen)));
+        }
+
+        return batch;
+    }
+
+    template <typename F>
+    void report(const char* name, F step)
+    {
+        auto start = std::chrono::steady_clock::now();
+        size_t deaths = step();
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+        cout << name << ": " << static_cast<size_t>(snakes_count * rounds / elapsed.count() / 1e6)
+             << " M snake-steps/s (deaths: " << deaths << ")\n";
+    }
+} // namespace
+
+int main()
+{
+    const Batch batch = random_batch();
+
+    ObstacleMap obstacles(board_size, board_size);
+    for (int i = 1; i < board_size; i += 7)
+        obstacles.set({i, (i * 13) % board_size});
+
+    report("Snake::move (walls only)", [&] {
+        Board board(board_size, board_size);
+        size_t deaths = 0;
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            for (size_t i = 0; i < snakes_count; ++i)
+            {
+                Snake snake{Point(batch.head_x[i], batch.head_y[i])};
+                snake.set_board(board);
+                snake.move(batch.directions[i]);
+                deaths += !snake.is_alive();
+            }
+        }
+        return deaths;
+    });
+
+    for (auto [level, name] : {std::pair{SimdLevel::Scalar, "step_heads (scalar)"},
+             std::pair{SimdLevel::SSE2, "step_heads (SSE2)"}, std::pair{SimdLevel::AVX2, "step_heads (AVX2)"}})
+    {
+        if (level > detect_simd_level())
+            continue;
+
+        report(name, [&, level = level] {
+            std::vector<std::uint8_t> death_mask((snakes_count + 7) / 8);
+            size_t deaths = 0;
+            for (size_t r = 0; r < rounds; ++r)
+            {
+                std::vector<int> head_x = batch.head_x;
+                std::vector<int> head_y = batch.head_y;
+                step_heads(head_x, head_y, batch.directions, obstacles, death_mask, level);
+
+                for (std::uint8_t bits : death_mask)
+                    deaths += std::popcount(bits);
+            }
+            return deaths;
+        });
+    }
+}
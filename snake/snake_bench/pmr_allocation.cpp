@@ -0,0 +1,99 @@
+#include <snake/scripted_terminal.hpp>
+#include <snake/snake.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t games_per_thread = 200'000;
+    constexpr size_t games_per_batch = 1'000;
+    constexpr size_t arena_size = 1024 * 1024;
+
+    constexpr size_t max_ticks = 100; // the snake hits the wall long before
+
+    // short-lived game: the snake eats a row of fruits (grows) and keeps moving until it hits the wall
+    size_t play_game(std::pmr::memory_resource* resource, ScriptedTerminal& terminal)
+    {
+        Board board(20, 20, resource);
+        for (int x = 11; x < 16; ++x)
+            board.add_fruit({x, 10});
+
+        SnakeGame game(std::move(board)); // the snake starts in the middle, allocated from the same resource
+        game.set_terminal(terminal);
+        game.run(max_ticks);
+
+        return game.snake().segments().size();
+    }
+
+    using Workload = void (*)(size_t& checksum);
+
+    void run_with_default_allocator(size_t& checksum)
+    {
+        ScriptedTerminal terminal({Terminal::Key::Right}, ScriptedTerminal::Replay::Loop);
+
+        for (size_t i = 0; i < games_per_thread; ++i)
+            checksum += play_game(std::pmr::get_default_resource(), terminal);
+    }
+
+    void run_with_monotonic_arena(size_t& checksum)
+    {
+        std::vector<std::byte> buffer(arena_size);
+        std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size()};
+        ScriptedTerminal terminal({Terminal::Key::Right}, ScriptedTerminal::Replay::Loop);
+
+        for (size_t i = 0; i < games_per_thread; ++i)
+        {
+            checksum += play_game(&arena, terminal);
+
+            if ((i + 1) % games_per_batch == 0)
+                arena.release(); // whole batch of games is freed at once
+        }
+    }
+
+    double measure(Workload workload, unsigned threads_count)
+    {
+        std::vector<size_t> checksums(threads_count);
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::jthread> threads;
+            for (unsigned i = 0; i < threads_count; ++i)
+                threads.emplace_back(workload, std::ref(checksums[i]));
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+        for (size_t checksum : checksums)
+            if (checksum == 0)
+                std::cerr << "Unexpected checksum\n";
+
+        return (games_per_thread * threads_count) / elapsed.count();
+    }
+} // namespace
+
+int main()
+{
+    const unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+
+    cout << "Games per second (" << games_per_thread << " games per thread)\n";
+    cout << setw(8) << "threads" << setw(20) << "default allocator" << setw(20) << "monotonic arena" << setw(10) << "speedup" << "\n";
+
+    for (unsigned threads_count = 1; threads_count <= max_threads; threads_count *= 2)
+    {
+        double default_rate = measure(run_with_default_allocator, threads_count);
+        double arena_rate = measure(run_with_monotonic_arena, threads_count);
+
+        cout << setw(8) << threads_count
+             << setw(20) << fixed << setprecision(0) << default_rate
+             << setw(20) << arena_rate
+             << setw(9) << setprecision(2) << arena_rate / default_rate << "x\n";
+    }
+}
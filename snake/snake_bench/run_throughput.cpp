@@ -0,0 +1,56 @@
+#include <snake/scripted_terminal.hpp>
+#include <snake/snake.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <stop_token>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+    using Key = Terminal::Key;
+
+    constexpr size_t ticks_limit = 20'000'000;
+    constexpr auto stop_after = std::chrono::seconds(1);
+} // namespace
+
+int main()
+{
+    // snake circles forever - the loop ends only on the tick limit or a stop request
+    const std::vector<Key> circle = {Key::Up, Key::Right, Key::Down, Key::Left};
+
+    {
+        ScriptedTerminal terminal(circle, ScriptedTerminal::Replay::Loop);
+        SnakeGame game(80, 40);
+        game.set_terminal(terminal);
+
+        auto start = std::chrono::steady_clock::now();
+        size_t ticks = game.run(ticks_limit);
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+        cout << "Tick limit:   " << ticks << " ticks in " << elapsed.count() << " s - "
+             << static_cast<size_t>(ticks / elapsed.count()) << " ticks/s\n";
+    }
+
+    {
+        ScriptedTerminal terminal(circle, ScriptedTerminal::Replay::Loop);
+        SnakeGame game(80, 40);
+        game.set_terminal(terminal);
+
+        size_t ticks = 0;
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::jthread game_thread([&](std::stop_token stop_token) {
+                ticks = game.run(std::numeric_limits<size_t>::max(), stop_token);
+            });
+
+            std::this_thread::sleep_for(stop_after);
+        } // stop is requested & thread is joined
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+        cout << "Stop token:   " << ticks << " ticks in " << elapsed.count() << " s - "
+             << static_cast<size_t>(ticks / elapsed.count()) << " ticks/s\n";
+    }
+}
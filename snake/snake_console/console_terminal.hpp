@@ -68,7 +68,7 @@ public:
         }
     }
 
-    void render_fruits(const std::vector<Point>& fruits) override
+    void render_fruits(std::span<const Point> fruits) override
     {
         for (const auto& fruit : fruits)
         {
@@ -1,18 +1,54 @@
 #include "console_terminal.hpp"
 
+#include <exception>
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <snake/autopilot.hpp>
 #include <snake/snake.hpp>
 
 using namespace std;
 
-int main()
+// usage: snake-console [genome-file] - with a genome trained by snake-trainer the snake runs on autopilot
+int main(int argc, char* argv[])
 {
+    std::optional<MlpPolicy> autopilot_policy;
+    if (argc > 1)
+    {
+        std::ifstream genome_file(argv[1], std::ios::binary);
+        if (!genome_file.is_open())
+        {
+            cerr << "Cannot open genome file " << argv[1] << "\nusage: snake-console [genome-file]\n";
+            return 1;
+        }
+
+        try
+        {
+            autopilot_policy.emplace(load_genome(genome_file));
+        }
+        catch (const std::exception& e)
+        {
+            cerr << "Cannot load genome file " << argv[1] << ": " << e.what() << "\n";
+            return 1;
+        }
+    }
+
     Term::Screen term_size = Term::screen_size();
     const size_t width = term_size.columns();
     const size_t height = term_size.rows();
     ConsoleTerminal terminal(width, height);
     SnakeGame snake_game(width, height);
     snake_game.populate_with_fruits(30);
-    snake_game.set_terminal(terminal);
-    snake_game.run();
-}
\ No newline at end of file
+
+    if (autopilot_policy)
+    {
+        AutopilotTerminal autopilot(terminal, snake_game, std::move(*autopilot_policy));
+        snake_game.set_terminal(autopilot);
+        snake_game.run();
+    }
+    else
+    {
+        snake_game.set_terminal(terminal);
+        snake_game.run();
+    }
+}
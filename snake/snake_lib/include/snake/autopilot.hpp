@@ -0,0 +1,89 @@
+#ifndef AUTOPILOT_HPP
+#define AUTOPILOT_HPP
+
+#include <snake/snake.hpp>
+
+#include <array>
+#include <cstddef>
+#include <iosfwd>
+#include <span>
+#include <vector>
+
+// Fixed-size multilayer perceptron steering the snake
+//   inputs:  danger in 4 directions, direction to the nearest fruit, current direction (one-hot)
+//   outputs: score for each Direction - the highest one wins
+class MlpPolicy
+{
+public:
+    static constexpr size_t input_size = 12;
+    static constexpr size_t hidden_size = 16;
+    static constexpr size_t output_size = 4;
+    static constexpr size_t genome_size = input_size * hidden_size + hidden_size + hidden_size * output_size + output_size;
+
+    using Features = std::array<float, input_size>;
+    using Genome = std::vector<float>;
+
+private:
+    Genome genome_;
+
+public:
+    explicit MlpPolicy(Genome genome);
+
+    const Genome& genome() const
+    {
+        return genome_;
+    }
+
+    // batched forward pass: inputs are batch x input_size, outputs are batch x output_size (row-major)
+    void forward(std::span<const float> inputs, std::span<float> outputs) const;
+
+    Direction decide(const Features& features) const;
+
+    static Features observe(const Board& board, const Snake& snake);
+
+    static Direction best_direction(std::span<const float> scores);
+};
+
+// Binary genome file: "SNKG", format version, layer sizes (uint16 each), weights (float32, little-endian)
+void save_genome(std::ostream& out, const MlpPolicy::Genome& genome);
+MlpPolicy::Genome load_genome(std::istream& in);
+
+// Terminal decorator - the policy chooses the keys, the user can still quit with Ctrl_Q
+class AutopilotTerminal : public Terminal
+{
+    Terminal& terminal_;
+    const SnakeGame& game_;
+    MlpPolicy policy_;
+
+public:
+    AutopilotTerminal(Terminal& terminal, const SnakeGame& game, MlpPolicy policy)
+        : terminal_{terminal}
+        , game_{game}
+        , policy_{std::move(policy)}
+    {
+    }
+
+    Key read_key() override;
+
+    void render_snake(const Snake& snake) override
+    {
+        terminal_.render_snake(snake);
+    }
+
+    void render_fruits(std::span<const Point> fruits) override
+    {
+        terminal_.render_fruits(fruits);
+    }
+
+    void render_text(int x, int y, const std::string& text) override
+    {
+        terminal_.render_text(x, y, text);
+    }
+
+    void flush() override
+    {
+        terminal_.flush();
+    }
+};
+
+#endif // AUTOPILOT_HPP
@@ -0,0 +1,93 @@
+#ifndef BATCH_KERNEL_HPP
+#define BATCH_KERNEL_HPP
+
+#include <snake/snake.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Obstacle bits of a board - one bit per cell of the (width + 1) x (height + 1) grid (walls included)
+class ObstacleMap
+{
+    int w_;
+    int h_;
+    int stride_;
+    std::vector<std::uint32_t> bits_;
+
+public:
+    ObstacleMap(int w, int h)
+        : w_{w}
+        , h_{h}
+        , stride_{w + 1}
+        , bits_((static_cast<size_t>(w + 1) * (h + 1) + 31) / 32)
+    {
+        if (w <= 0 || h <= 0)
+            throw std::invalid_argument("Invalid dimensions of the board");
+    }
+
+    int width() const
+    {
+        return w_;
+    }
+
+    int height() const
+    {
+        return h_;
+    }
+
+    int stride() const
+    {
+        return stride_;
+    }
+
+    const std::uint32_t* data() const
+    {
+        return bits_.data();
+    }
+
+    void set(Point pt)
+    {
+        assert(contains(pt));
+        size_t index = static_cast<size_t>(pt.y) * stride_ + pt.x;
+        bits_[index / 32] |= 1u << (index % 32);
+    }
+
+    bool test(Point pt) const
+    {
+        if (!contains(pt))
+            return false;
+
+        size_t index = static_cast<size_t>(pt.y) * stride_ + pt.x;
+        return (bits_[index / 32] >> (index % 32)) & 1u;
+    }
+
+    void clear()
+    {
+        std::fill(bits_.begin(), bits_.end(), 0u);
+    }
+
+    bool contains(Point pt) const
+    {
+        return pt.x >= 0 && pt.y >= 0 && pt.x <= w_ && pt.y <= h_;
+    }
+};
+
+enum class SimdLevel
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+SimdLevel detect_simd_level();
+
+// Steps a batch of snakes stored as arrays of head coordinates & directions:
+//  - heads are moved one cell in place (direction-delta lookup - same result as Snake::move)
+//  - bit (i % 8) of death_mask[i / 8] is set when head i hits a wall or an obstacle bit
+// The obstacle map must hold the bodies without the tails that move away in this tick
+// (for a snake that eats a fruit the tail stays and has to be marked as well).
+void step_heads(std::span<int> head_x, std::span<int> head_y, std::span<const Direction> directions,
+    const ObstacleMap& obstacles, std::span<std::uint8_t> death_mask, SimdLevel level = detect_simd_level());
+
+#endif // BATCH_KERNEL_HPP
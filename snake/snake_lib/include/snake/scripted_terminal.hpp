@@ -0,0 +1,66 @@
+#ifndef SCRIPTED_TERMINAL_HPP
+#define SCRIPTED_TERMINAL_HPP
+
+#include <snake/snake.hpp>
+#include <vector>
+
+// Headless terminal - feeds keys from a script and discards rendering
+class ScriptedTerminal : public Terminal
+{
+public:
+    enum class Replay
+    {
+        Once, // Ctrl_Q is returned when the script is exhausted
+        Loop  // script is restarted from the first key
+    };
+
+private:
+    std::vector<Key> keys_;
+    Replay replay_;
+    size_t next_key_{};
+    size_t frames_{};
+
+public:
+    explicit ScriptedTerminal(std::vector<Key> keys, Replay replay = Replay::Once)
+        : keys_{std::move(keys)}
+        , replay_{replay}
+    {
+    }
+
+    Key read_key() override
+    {
+        if (next_key_ == keys_.size())
+        {
+            if (replay_ == Replay::Once || keys_.empty())
+                return Key::Ctrl_Q;
+
+            next_key_ = 0;
+        }
+
+        return keys_[next_key_++];
+    }
+
+    void render_snake(const Snake&) override
+    {
+    }
+
+    void render_fruits(std::span<const Point>) override
+    {
+    }
+
+    void render_text(int, int, const std::string&) override
+    {
+    }
+
+    void flush() override
+    {
+        ++frames_;
+    }
+
+    size_t frames() const
+    {
+        return frames_;
+    }
+};
+
+#endif // SCRIPTED_TERMINAL_HPP
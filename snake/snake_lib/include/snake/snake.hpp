@@ -5,7 +5,11 @@
 #include <array>
 #include <cassert>
 #include <iostream>
+#include <limits>
+#include <memory_resource>
 #include <random>
+#include <span>
+#include <stop_token>
 #include <string>
 #include <thread>
 #include <vector>
@@ -45,17 +49,31 @@ class Board
 private:
     int w_;
     int h_;
-    std::vector<Point> fruits_;
+    std::pmr::vector<Point> fruits_;
 
 public:
-    Board(int w, int h)
+    Board(int w, int h, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
         : w_{w}
         , h_{h}
+        , fruits_{resource}
     {
         if (w <= 0 || h <= 0)
             throw std::invalid_argument("Invalid dimensions of the board");
     }
 
+    // a plain copy allocates from the default resource (pmr copy semantics) - this one from the given resource
+    Board(const Board& other, std::pmr::memory_resource* resource)
+        : w_{other.w_}
+        , h_{other.h_}
+        , fruits_{other.fruits_, resource}
+    {
+    }
+
+    Board(const Board&) = default;
+    Board(Board&&) = default;
+    Board& operator=(const Board&) = default;
+    Board& operator=(Board&&) = default;
+
     int width() const
     {
         return w_;
@@ -66,7 +84,7 @@ public:
         return h_;
     }
 
-    bool is_hitting_wall(Point head)
+    bool is_hitting_wall(Point head) const
     {
         return head.x == 0 || head.y == 0 || head.x == w_ || head.y == h_;
     }
@@ -76,11 +94,16 @@ public:
         fruits_.push_back(point);
     }
 
-    const std::vector<Point>& fruits() const
+    const std::pmr::vector<Point>& fruits() const
     {
         return fruits_;
     }
 
+    std::pmr::memory_resource* resource() const
+    {
+        return fruits_.get_allocator().resource();
+    }
+
     [[nodiscard]] bool try_eat_fruit(Point fruit)
     {
         auto it = std::find(fruits_.begin(), fruits_.end(), fruit);
@@ -96,22 +119,36 @@ public:
 class Snake
 {
 private:
-    std::vector<Point> segments_;
+    std::pmr::vector<Point> segments_;
     Direction direction_ = Direction::Up;
     Board* board_{};
     bool is_alive_ = true;
 
 public:
-    explicit Snake(Point head)
-        : segments_{head}
+    explicit Snake(Point head, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : segments_({head}, resource)
     {
     }
 
-    Snake(std::initializer_list<Point> segments)
-        : segments_{segments}
+    Snake(std::initializer_list<Point> segments, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : segments_(segments, resource)
     {
     }
 
+    // a plain copy allocates from the default resource (pmr copy semantics) - this one from the given resource
+    Snake(const Snake& other, std::pmr::memory_resource* resource)
+        : segments_(other.segments_, resource)
+        , direction_{other.direction_}
+        , board_{other.board_}
+        , is_alive_{other.is_alive_}
+    {
+    }
+
+    Snake(const Snake&) = default;
+    Snake(Snake&&) = default;
+    Snake& operator=(const Snake&) = default;
+    Snake& operator=(Snake&&) = default;
+
     void set_board(Board& board)
     {
         board_ = &board;
@@ -127,7 +164,7 @@ public:
         return segments_.front();
     }
 
-    const std::vector<Point>& segments() const
+    const std::pmr::vector<Point>& segments() const
     {
         return segments_;
     }
@@ -218,7 +255,7 @@ public:
     };
 
     virtual void render_snake(const Snake& snake) = 0;
-    virtual void render_fruits(const std::vector<Point>& fruits) = 0;
+    virtual void render_fruits(std::span<const Point> fruits) = 0;
     virtual void render_text(int x, int y, const std::string& text) = 0;
     virtual Key read_key() = 0;
     virtual void flush() = 0;
@@ -233,27 +270,39 @@ private:
     Terminal* terminal_;
 
 public:
-    SnakeGame(int width, int height)
-        : board_{width, height}
-        , snake_{Point(board_.width() / 2, board_.height() / 2)}
+    SnakeGame(int width, int height, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : board_{width, height, resource}
+        , snake_{Point(board_.width() / 2, board_.height() / 2), resource}
     {
         snake_.set_board(board_);
     }
 
-    SnakeGame(Board board)
+    // the game allocates from the resource of the board - a moved board keeps its resource
+    SnakeGame(Board&& board)
         : board_{std::move(board)}
-        , snake_{Point(board_.width() / 2, board_.height() / 2)}
+        , snake_{Point(board_.width() / 2, board_.height() / 2), board_.resource()}
     {
         snake_.set_board(board_);
     }
 
-    SnakeGame(Board board, Snake snake)
+    SnakeGame(const Board& board)
+        : SnakeGame(Board{board, board.resource()})
+    {
+    }
+
+    // moved board & snake keep their resources, copies are allocated from the resource of the board
+    SnakeGame(Board&& board, Snake&& snake)
         : board_{std::move(board)}
         , snake_{std::move(snake)}
     {
         snake_.set_board(board_);
     }
 
+    SnakeGame(const Board& board, const Snake& snake)
+        : SnakeGame(Board{board, board.resource()}, Snake{snake, board.resource()})
+    {
+    }
+
     void set_terminal(Terminal& terminal)
     {
         terminal_ = &terminal;
@@ -288,10 +337,18 @@ public:
     }
 
     void run()
+    {
+        run(std::numeric_limits<size_t>::max());
+    }
+
+    // runs at most max_ticks ticks of the game loop or until stop is requested; returns number of completed ticks
+    size_t run(size_t max_ticks, std::stop_token stop_token = {})
     {
         assert(terminal_);
 
-        while (!is_over())
+        size_t ticks = 0;
+
+        while (!is_over() && ticks < max_ticks && !stop_token.stop_requested())
         {
             terminal_->render_fruits(board_.fruits());
             terminal_->render_snake(snake_);
@@ -313,7 +370,7 @@ public:
                     snake_.move(Direction::Down);
                     break;
                 case Terminal::Key::Ctrl_Q:
-                    return;                
+                    return ticks;
             }
 
             if (is_over())
@@ -323,7 +380,10 @@ public:
             }
 
             terminal_->flush();
+            ++ticks;
         }
+
+        return ticks;
     }
 };
 
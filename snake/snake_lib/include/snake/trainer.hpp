@@ -0,0 +1,101 @@
+#ifndef TRAINER_HPP
+#define TRAINER_HPP
+
+#include <snake/autopilot.hpp>
+#include <snake/snake.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct TrainerSettings
+{
+    size_t population_size = 256;
+    size_t elite_count = 8;
+    size_t tournament_size = 4;
+    size_t games_per_genome = 32;
+    int board_width = 20;
+    int board_height = 20;
+    size_t fruits_per_game = 20;
+    size_t max_steps = 2'000;
+    size_t starvation_steps = 200;
+    float mutation_rate = 0.1f;
+    float mutation_sigma = 0.2f;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::uint32_t seed = 42;
+};
+
+struct GenerationStats
+{
+    size_t generation;
+    float best_fitness;
+    float mean_fitness;
+};
+
+// runs f(i) for every i in [0, count) on a set of worker threads
+template <typename F>
+void parallel_for(size_t count, unsigned threads, F f)
+{
+    std::atomic<size_t> next_index{0};
+
+    std::vector<std::jthread> workers;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&] {
+            for (size_t i = next_index++; i < count; i = next_index++)
+                f(i);
+        });
+    }
+}
+
+class Trainer
+{
+    using Genome = MlpPolicy::Genome;
+
+    TrainerSettings settings_;
+    std::vector<Genome> population_;
+    std::vector<float> fitness_;
+    Genome best_;
+    float best_fitness_ = -1.0f;
+    size_t generation_ = 0;
+
+public:
+    explicit Trainer(TrainerSettings settings);
+
+    const Genome& best() const
+    {
+        return best_;
+    }
+
+    float best_fitness() const
+    {
+        return best_fitness_;
+    }
+
+    const std::vector<Genome>& population() const
+    {
+        return population_;
+    }
+
+    // scores of the population the last next_generation() evaluated & replaced - by index in that population
+    const std::vector<float>& fitness() const
+    {
+        return fitness_;
+    }
+
+    // scores the current population and breeds the next one
+    GenerationStats next_generation();
+
+    // average score of the policy over seeded games played in lockstep (one batched forward pass per tick)
+    static float evaluate(const MlpPolicy& policy, const TrainerSettings& settings, std::uint32_t seed);
+
+private:
+    std::uint32_t game_seed(size_t generation) const;
+    Genome breed(size_t index) const;
+    const Genome& tournament(std::mt19937& gen) const;
+};
+
+#endif // TRAINER_HPP
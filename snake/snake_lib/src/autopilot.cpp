@@ -0,0 +1,202 @@
+#include "snake/autopilot.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace
+{
+    constexpr std::array<char, 4> genome_magic = {'S', 'N', 'K', 'G'};
+    constexpr std::uint16_t genome_version = 1;
+
+    constexpr std::array<Direction, 4> directions = {Direction::Up, Direction::Down, Direction::Left, Direction::Right};
+
+    Point step(Point pt, Direction direction)
+    {
+        switch (direction)
+        {
+        case Direction::Up:
+            return {pt.x, pt.y - 1};
+        case Direction::Down:
+            return {pt.x, pt.y + 1};
+        case Direction::Left:
+            return {pt.x - 1, pt.y};
+        case Direction::Right:
+            return {pt.x + 1, pt.y};
+        }
+
+        return pt;
+    }
+
+    template <typename T>
+    void write_le(std::ostream& out, T value)
+    {
+        static_assert(std::endian::native == std::endian::little, "genome files are little-endian");
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    T read_le(std::istream& in)
+    {
+        T value{};
+        if (!in.read(reinterpret_cast<char*>(&value), sizeof(value)))
+            throw std::runtime_error("Truncated genome file");
+        return value;
+    }
+} // namespace
+
+MlpPolicy::MlpPolicy(Genome genome)
+    : genome_{std::move(genome)}
+{
+    if (genome_.size() != genome_size)
+        throw std::invalid_argument("Invalid size of the genome");
+}
+
+void MlpPolicy::forward(std::span<const float> inputs, std::span<float> outputs) const
+{
+    assert(inputs.size() % input_size == 0);
+    assert(outputs.size() == inputs.size() / input_size * output_size);
+
+    // layer weights are stored input-major, so the inner loops run over contiguous memory and vectorize
+    const float* w1 = genome_.data();
+    const float* b1 = w1 + input_size * hidden_size;
+    const float* w2 = b1 + hidden_size;
+    const float* b2 = w2 + hidden_size * output_size;
+
+    const size_t batch_size = inputs.size() / input_size;
+
+    for (size_t b = 0; b < batch_size; ++b)
+    {
+        const float* x = inputs.data() + b * input_size;
+
+        std::array<float, hidden_size> hidden;
+        std::copy(b1, b1 + hidden_size, hidden.begin());
+
+        for (size_t i = 0; i < input_size; ++i)
+            for (size_t j = 0; j < hidden_size; ++j)
+                hidden[j] += x[i] * w1[i * hidden_size + j];
+
+        for (float& h : hidden)
+            h = std::max(h, 0.0f);
+
+        float* y = outputs.data() + b * output_size;
+        std::copy(b2, b2 + output_size, y);
+
+        for (size_t j = 0; j < hidden_size; ++j)
+            for (size_t k = 0; k < output_size; ++k)
+                y[k] += hidden[j] * w2[j * output_size + k];
+    }
+}
+
+Direction MlpPolicy::decide(const Features& features) const
+{
+    std::array<float, output_size> scores;
+    forward(features, scores);
+
+    return best_direction(scores);
+}
+
+Direction MlpPolicy::best_direction(std::span<const float> scores)
+{
+    assert(scores.size() == output_size);
+
+    return directions[std::distance(scores.begin(), std::max_element(scores.begin(), scores.end()))];
+}
+
+MlpPolicy::Features MlpPolicy::observe(const Board& board, const Snake& snake)
+{
+    Features features{};
+
+    const Point head = snake.head();
+    const auto& segments = snake.segments();
+
+    for (size_t d = 0; d < directions.size(); ++d)
+    {
+        Point next = step(head, directions[d]);
+
+        // the tail moves away in the same tick, so it is not a danger
+        bool hits_body = std::find(segments.begin(), segments.end() - 1, next) != segments.end() - 1;
+        features[d] = (board.is_hitting_wall(next) || hits_body) ? 1.0f : 0.0f;
+    }
+
+    const auto& fruits = board.fruits();
+    auto nearest = std::min_element(fruits.begin(), fruits.end(), [head](const Point& a, const Point& b) {
+        return std::abs(a.x - head.x) + std::abs(a.y - head.y) < std::abs(b.x - head.x) + std::abs(b.y - head.y);
+    });
+
+    if (nearest != fruits.end())
+    {
+        features[4] = nearest->y < head.y ? 1.0f : 0.0f;
+        features[5] = nearest->y > head.y ? 1.0f : 0.0f;
+        features[6] = nearest->x < head.x ? 1.0f : 0.0f;
+        features[7] = nearest->x > head.x ? 1.0f : 0.0f;
+    }
+
+    features[8 + static_cast<size_t>(snake.direction())] = 1.0f;
+
+    return features;
+}
+
+void save_genome(std::ostream& out, const MlpPolicy::Genome& genome)
+{
+    if (genome.size() != MlpPolicy::genome_size)
+        throw std::invalid_argument("Invalid size of the genome");
+
+    out.write(genome_magic.data(), genome_magic.size());
+    write_le<std::uint16_t>(out, genome_version);
+    write_le<std::uint16_t>(out, MlpPolicy::input_size);
+    write_le<std::uint16_t>(out, MlpPolicy::hidden_size);
+    write_le<std::uint16_t>(out, MlpPolicy::output_size);
+
+    for (float weight : genome)
+        write_le(out, weight);
+
+    if (!out)
+        throw std::runtime_error("Cannot write genome");
+}
+
+MlpPolicy::Genome load_genome(std::istream& in)
+{
+    std::array<char, 4> magic{};
+    if (!in.read(magic.data(), magic.size()) || magic != genome_magic)
+        throw std::runtime_error("Not a genome file");
+
+    if (read_le<std::uint16_t>(in) != genome_version)
+        throw std::runtime_error("Unsupported version of genome file");
+
+    const auto input_size = read_le<std::uint16_t>(in);
+    const auto hidden_size = read_le<std::uint16_t>(in);
+    const auto output_size = read_le<std::uint16_t>(in);
+
+    if (input_size != MlpPolicy::input_size || hidden_size != MlpPolicy::hidden_size || output_size != MlpPolicy::output_size)
+        throw std::runtime_error("Genome does not match the policy layout");
+
+    MlpPolicy::Genome genome(MlpPolicy::genome_size);
+    for (float& weight : genome)
+        weight = read_le<float>(in);
+
+    return genome;
+}
+
+Terminal::Key AutopilotTerminal::read_key()
+{
+    if (terminal_.read_key() == Key::Ctrl_Q)
+        return Key::Ctrl_Q;
+
+    switch (policy_.decide(MlpPolicy::observe(game_.board(), game_.snake())))
+    {
+    case Direction::Up:
+        return Key::Up;
+    case Direction::Down:
+        return Key::Down;
+    case Direction::Left:
+        return Key::Left;
+    case Direction::Right:
+        return Key::Right;
+    }
+
+    return Key::Up;
+}
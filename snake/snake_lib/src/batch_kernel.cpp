@@ -0,0 +1,199 @@
+#include "snake/batch_kernel.hpp"
+
+#include <algorithm>
+#include <array>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SNAKE_BATCH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SNAKE_TARGET_AVX2
+#else
+#define SNAKE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+static_assert(sizeof(Direction) == sizeof(int), "directions are loaded as 32-bit lanes");
+static_assert(static_cast<int>(Direction::Up) == 0 && static_cast<int>(Direction::Down) == 1
+        && static_cast<int>(Direction::Left) == 2 && static_cast<int>(Direction::Right) == 3,
+    "delta tables are indexed by Direction");
+
+namespace
+{
+    constexpr std::array<int, 4> delta_x = {0, 0, -1, 1};
+    constexpr std::array<int, 4> delta_y = {-1, 1, 0, 0};
+
+    bool is_dead(int x, int y, const ObstacleMap& obstacles)
+    {
+        // same rule as Board::is_hitting_wall
+        bool hits_wall = x == 0 || y == 0 || x == obstacles.width() || y == obstacles.height();
+        return hits_wall || obstacles.test({x, y});
+    }
+
+    void step_heads_scalar(size_t first, size_t last, int* xs, int* ys, const Direction* directions,
+        const ObstacleMap& obstacles, std::uint8_t* death_mask)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            const auto d = static_cast<size_t>(directions[i]);
+            xs[i] += delta_x[d];
+            ys[i] += delta_y[d];
+
+            if (is_dead(xs[i], ys[i], obstacles))
+                death_mask[i / 8] |= static_cast<std::uint8_t>(1u << (i % 8));
+        }
+    }
+
+#if defined(SNAKE_BATCH_X86)
+    // 4 lanes - SSE2 has no gather, so obstacle bits are tested per lane
+    size_t step_heads_sse2(size_t count, int* xs, int* ys, const Direction* directions,
+        const ObstacleMap& obstacles, std::uint8_t* death_mask)
+    {
+        const __m128i up = _mm_set1_epi32(static_cast<int>(Direction::Up));
+        const __m128i down = _mm_set1_epi32(static_cast<int>(Direction::Down));
+        const __m128i left = _mm_set1_epi32(static_cast<int>(Direction::Left));
+        const __m128i right = _mm_set1_epi32(static_cast<int>(Direction::Right));
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i width = _mm_set1_epi32(obstacles.width());
+        const __m128i height = _mm_set1_epi32(obstacles.height());
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            unsigned mask = 0;
+
+            for (size_t half = 0; half < 8; half += 4)
+            {
+                int* x_ptr = xs + i + half;
+                int* y_ptr = ys + i + half;
+                const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(directions + i + half));
+
+                // comparisons yield -1 for true lanes: dx = [Left] - [Right], dy = [Up] - [Down]
+                const __m128i dx = _mm_sub_epi32(_mm_cmpeq_epi32(d, left), _mm_cmpeq_epi32(d, right));
+                const __m128i dy = _mm_sub_epi32(_mm_cmpeq_epi32(d, up), _mm_cmpeq_epi32(d, down));
+
+                const __m128i x = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x_ptr)), dx);
+                const __m128i y = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y_ptr)), dy);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(x_ptr), x);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(y_ptr), y);
+
+                const __m128i wall = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi32(x, zero), _mm_cmpeq_epi32(y, zero)),
+                    _mm_or_si128(_mm_cmpeq_epi32(x, width), _mm_cmpeq_epi32(y, height)));
+
+                unsigned lanes = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(wall)));
+                for (int lane = 0; lane < 4; ++lane)
+                    if (obstacles.test({x_ptr[lane], y_ptr[lane]}))
+                        lanes |= 1u << lane;
+
+                mask |= lanes << half;
+            }
+
+            death_mask[i / 8] |= static_cast<std::uint8_t>(mask);
+        }
+
+        return i;
+    }
+
+    // 8 lanes - delta lookup with a lane permute, obstacle bits fetched with a masked gather
+    SNAKE_TARGET_AVX2 size_t step_heads_avx2(size_t count, int* xs, int* ys, const Direction* directions,
+        const ObstacleMap& obstacles, std::uint8_t* death_mask)
+    {
+        const __m256i dx_table = _mm256_setr_epi32(delta_x[0], delta_x[1], delta_x[2], delta_x[3], 0, 0, 0, 0);
+        const __m256i dy_table = _mm256_setr_epi32(delta_y[0], delta_y[1], delta_y[2], delta_y[3], 0, 0, 0, 0);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i minus_one = _mm256_set1_epi32(-1);
+        const __m256i width = _mm256_set1_epi32(obstacles.width());
+        const __m256i height = _mm256_set1_epi32(obstacles.height());
+        const __m256i width_end = _mm256_set1_epi32(obstacles.width() + 1);
+        const __m256i height_end = _mm256_set1_epi32(obstacles.height() + 1);
+        const __m256i stride = _mm256_set1_epi32(obstacles.stride());
+        const __m256i bit_mask = _mm256_set1_epi32(31);
+        const int* bits = reinterpret_cast<const int*>(obstacles.data());
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(directions + i));
+
+            const __m256i x = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(xs + i)),
+                _mm256_permutevar8x32_epi32(dx_table, d));
+            const __m256i y = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ys + i)),
+                _mm256_permutevar8x32_epi32(dy_table, d));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(xs + i), x);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(ys + i), y);
+
+            const __m256i wall = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi32(x, zero), _mm256_cmpeq_epi32(y, zero)),
+                _mm256_or_si256(_mm256_cmpeq_epi32(x, width), _mm256_cmpeq_epi32(y, height)));
+
+            const __m256i in_map = _mm256_and_si256(
+                _mm256_and_si256(_mm256_cmpgt_epi32(x, minus_one), _mm256_cmpgt_epi32(width_end, x)),
+                _mm256_and_si256(_mm256_cmpgt_epi32(y, minus_one), _mm256_cmpgt_epi32(height_end, y)));
+
+            const __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(y, stride), x);
+            const __m256i words = _mm256_mask_i32gather_epi32(zero, bits, _mm256_srli_epi32(index, 5), in_map, 4);
+            const __m256i bit = _mm256_and_si256(_mm256_srlv_epi32(words, _mm256_and_si256(index, bit_mask)), one);
+            const __m256i obstacle = _mm256_and_si256(_mm256_cmpeq_epi32(bit, one), in_map);
+
+            const __m256i dead = _mm256_or_si256(wall, obstacle);
+            death_mask[i / 8] |= static_cast<std::uint8_t>(_mm256_movemask_ps(_mm256_castsi256_ps(dead)));
+        }
+
+        return i;
+    }
+
+    bool cpu_supports_avx2()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        const bool os_saves_ymm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+        __cpuidex(info, 7, 0);
+        return os_saves_ymm && (info[1] & (1 << 5));
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+} // namespace
+
+SimdLevel detect_simd_level()
+{
+#if defined(SNAKE_BATCH_X86)
+    static const SimdLevel level = cpu_supports_avx2() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+void step_heads(std::span<int> head_x, std::span<int> head_y, std::span<const Direction> directions,
+    const ObstacleMap& obstacles, std::span<std::uint8_t> death_mask, SimdLevel level)
+{
+    const size_t count = directions.size();
+
+    if (head_x.size() != count || head_y.size() != count)
+        throw std::invalid_argument("Heads and directions differ in size");
+
+    if (death_mask.size() < (count + 7) / 8)
+        throw std::invalid_argument("Death mask is too small");
+
+    std::fill(death_mask.begin(), death_mask.end(), std::uint8_t{0});
+
+    // a level that the CPU does not support falls back to the best available one
+    level = std::min(level, detect_simd_level());
+
+    size_t done = 0;
+
+#if defined(SNAKE_BATCH_X86)
+    if (level == SimdLevel::AVX2)
+        done = step_heads_avx2(count, head_x.data(), head_y.data(), directions.data(), obstacles, death_mask.data());
+    else if (level == SimdLevel::SSE2)
+        done = step_heads_sse2(count, head_x.data(), head_y.data(), directions.data(), obstacles, death_mask.data());
+#endif
+
+    step_heads_scalar(done, count, head_x.data(), head_y.data(), directions.data(), obstacles, death_mask.data());
+}
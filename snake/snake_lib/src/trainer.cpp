@@ -0,0 +1,172 @@
+#include "snake/trainer.hpp"
+
+#include <deque>
+#include <memory_resource>
+#include <numeric>
+#include <span>
+
+Trainer::Trainer(TrainerSettings settings)
+    : settings_{settings}
+    , population_(settings.population_size)
+    , fitness_(settings.population_size)
+{
+    std::mt19937 gen(settings_.seed);
+    std::normal_distribution<float> weight_distr(0.0f, 0.5f);
+
+    for (Genome& genome : population_)
+    {
+        genome.resize(MlpPolicy::genome_size);
+        std::generate(genome.begin(), genome.end(), [&] { return weight_distr(gen); });
+    }
+}
+
+GenerationStats Trainer::next_generation()
+{
+    parallel_for(population_.size(), settings_.threads, [this](size_t i) {
+        fitness_[i] = evaluate(MlpPolicy{population_[i]}, settings_, game_seed(generation_));
+    });
+
+    std::vector<size_t> ranking(population_.size());
+    std::iota(ranking.begin(), ranking.end(), 0);
+    // equally fit genomes keep their order in the population - training is the same with every standard library
+    std::stable_sort(ranking.begin(), ranking.end(), [this](size_t a, size_t b) { return fitness_[a] > fitness_[b]; });
+
+    GenerationStats stats{generation_, fitness_[ranking.front()],
+        std::accumulate(fitness_.begin(), fitness_.end(), 0.0f) / fitness_.size()};
+
+    if (stats.best_fitness > best_fitness_)
+    {
+        best_fitness_ = stats.best_fitness;
+        best_ = population_[ranking.front()];
+    }
+
+    std::vector<Genome> next_population(population_.size());
+
+    parallel_for(next_population.size(), settings_.threads, [&](size_t i) {
+        if (i < settings_.elite_count)
+            next_population[i] = population_[ranking[i]];
+        else
+            next_population[i] = breed(i);
+    });
+
+    population_ = std::move(next_population);
+    ++generation_;
+
+    return stats;
+}
+
+float Trainer::evaluate(const MlpPolicy& policy, const TrainerSettings& settings, std::uint32_t seed)
+{
+    struct Episode
+    {
+        Board board;
+        Snake snake;
+        size_t steps = 0;
+        size_t steps_since_fruit = 0;
+
+        Episode(const TrainerSettings& settings, std::uint32_t seed, std::pmr::memory_resource* resource)
+            : board{settings.board_width, settings.board_height, resource}
+            , snake{Point(settings.board_width / 2, settings.board_height / 2), resource}
+        {
+            std::mt19937 gen(seed);
+            std::uniform_int_distribution<> x_distr(1, board.width() - 1);
+            std::uniform_int_distribution<> y_distr(1, board.height() - 1);
+
+            for (size_t i = 0; i < settings.fruits_per_game; ++i)
+                board.add_fruit({x_distr(gen), y_distr(gen)});
+
+            snake.set_board(board);
+        }
+    };
+
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::deque<Episode> episodes{&arena};
+    for (size_t g = 0; g < settings.games_per_genome; ++g)
+        episodes.emplace_back(settings, seed + static_cast<std::uint32_t>(g), &arena);
+
+    std::vector<Episode*> active;
+    for (Episode& episode : episodes)
+        active.push_back(&episode);
+
+    std::vector<float> inputs(active.size() * MlpPolicy::input_size);
+    std::vector<float> outputs(active.size() * MlpPolicy::output_size);
+
+    while (!active.empty())
+    {
+        for (size_t k = 0; k < active.size(); ++k)
+        {
+            auto features = MlpPolicy::observe(active[k]->board, active[k]->snake);
+            std::copy(features.begin(), features.end(), inputs.begin() + k * MlpPolicy::input_size);
+        }
+
+        policy.forward(std::span{inputs}.first(active.size() * MlpPolicy::input_size),
+            std::span{outputs}.first(active.size() * MlpPolicy::output_size));
+
+        for (size_t k = 0; k < active.size(); ++k)
+        {
+            Episode& episode = *active[k];
+            const size_t length = episode.snake.segments().size();
+
+            episode.snake.move(MlpPolicy::best_direction(std::span{outputs}.subspan(k * MlpPolicy::output_size, MlpPolicy::output_size)));
+            ++episode.steps;
+            episode.steps_since_fruit = episode.snake.segments().size() > length ? 0 : episode.steps_since_fruit + 1;
+        }
+
+        std::erase_if(active, [&](Episode* episode) {
+            return !episode->snake.is_alive()
+                || episode->board.fruits().empty()
+                || episode->steps == settings.max_steps
+                || episode->steps_since_fruit == settings.starvation_steps;
+        });
+    }
+
+    float total = 0.0f;
+    for (const Episode& episode : episodes)
+        total += 100.0f * (episode.snake.segments().size() - 1) + 0.1f * episode.steps;
+
+    return total / episodes.size();
+}
+
+std::uint32_t Trainer::game_seed(size_t generation) const
+{
+    return settings_.seed ^ static_cast<std::uint32_t>(generation * 2'654'435'761u);
+}
+
+Trainer::Genome Trainer::breed(size_t index) const
+{
+    // every child has its own deterministic stream - results do not depend on thread scheduling
+    std::seed_seq seq{settings_.seed, static_cast<std::uint32_t>(generation_), static_cast<std::uint32_t>(index)};
+    std::mt19937 gen(seq);
+
+    const Genome& mother = tournament(gen);
+    const Genome& father = tournament(gen);
+
+    std::bernoulli_distribution coin(0.5);
+    std::bernoulli_distribution mutation(settings_.mutation_rate);
+    std::normal_distribution<float> noise(0.0f, settings_.mutation_sigma);
+
+    Genome child(MlpPolicy::genome_size);
+    for (size_t w = 0; w < child.size(); ++w)
+    {
+        child[w] = coin(gen) ? mother[w] : father[w];
+        if (mutation(gen))
+            child[w] += noise(gen);
+    }
+
+    return child;
+}
+
+const Trainer::Genome& Trainer::tournament(std::mt19937& gen) const
+{
+    std::uniform_int_distribution<size_t> index_distr(0, population_.size() - 1);
+
+    size_t winner = index_distr(gen);
+    for (size_t round = 1; round < settings_.tournament_size; ++round)
+    {
+        size_t challenger = index_distr(gen);
+        if (fitness_[challenger] > fitness_[winner])
+            winner = challenger;
+    }
+
+    return population_[winner];
+}
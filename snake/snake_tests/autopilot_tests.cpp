@@ -0,0 +1,130 @@
+#include "snake/autopilot.hpp"
+#include "snake/scripted_terminal.hpp"
+#include "snake_game_builder.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <numeric>
+#include <sstream>
+#include <utility>
+
+namespace
+{
+    MlpPolicy::Genome sample_genome()
+    {
+        MlpPolicy::Genome genome(MlpPolicy::genome_size);
+        std::iota(genome.begin(), genome.end(), -100.0f);
+        return genome;
+    }
+} // namespace
+
+TEST_CASE("Genome file", "[Autopilot][Genome]")
+{
+    std::stringstream stream;
+
+    SECTION("saved genome is loaded back")
+    {
+        save_genome(stream, sample_genome());
+
+        REQUIRE(load_genome(stream) == sample_genome());
+    }
+
+    SECTION("loading a file that is not a genome throws")
+    {
+        stream << "not a genome";
+
+        REQUIRE_THROWS_AS(load_genome(stream), std::runtime_error);
+    }
+
+    SECTION("loading a truncated genome throws")
+    {
+        save_genome(stream, sample_genome());
+        std::stringstream truncated{stream.str().substr(0, 100)};
+
+        REQUIRE_THROWS_AS(load_genome(truncated), std::runtime_error);
+    }
+}
+
+TEST_CASE("MlpPolicy", "[Autopilot][Policy]")
+{
+    SECTION("genome of invalid size is rejected")
+    {
+        REQUIRE_THROWS_AS(MlpPolicy(MlpPolicy::Genome(3)), std::invalid_argument);
+    }
+
+    SECTION("batched forward pass gives the same scores as single passes")
+    {
+        MlpPolicy policy{sample_genome()};
+
+        MlpPolicy::Features a{1, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0};
+        MlpPolicy::Features b{0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1};
+
+        std::vector<float> batch(a.begin(), a.end());
+        batch.insert(batch.end(), b.begin(), b.end());
+        std::vector<float> batch_scores(2 * MlpPolicy::output_size);
+        policy.forward(batch, batch_scores);
+
+        std::array<float, MlpPolicy::output_size> scores_a, scores_b;
+        policy.forward(a, scores_a);
+        policy.forward(b, scores_b);
+
+        REQUIRE(std::equal(scores_a.begin(), scores_a.end(), batch_scores.begin()));
+        REQUIRE(std::equal(scores_b.begin(), scores_b.end(), batch_scores.begin() + MlpPolicy::output_size));
+    }
+}
+
+TEST_CASE("Observing the board", "[Autopilot][Features]")
+{
+    Board board(10, 10);
+    board.add_fruit({8, 2});
+    Snake snake = {Point(1, 5), Point(2, 5), Point(3, 5)};
+    snake.set_direction(Direction::Left);
+
+    auto features = MlpPolicy::observe(board, snake);
+
+    SECTION("danger - wall on the left, body on the right")
+    {
+        REQUIRE(features[0] == 0.0f); // up
+        REQUIRE(features[1] == 0.0f); // down
+        REQUIRE(features[2] == 1.0f); // left
+        REQUIRE(features[3] == 1.0f); // right
+    }
+
+    SECTION("fruit is up and right")
+    {
+        REQUIRE(features[4] == 1.0f);
+        REQUIRE(features[5] == 0.0f);
+        REQUIRE(features[6] == 0.0f);
+        REQUIRE(features[7] == 1.0f);
+    }
+
+    SECTION("current direction is one-hot encoded")
+    {
+        REQUIRE(features[8 + static_cast<size_t>(Direction::Left)] == 1.0f);
+        REQUIRE(features[8] + features[9] + features[10] + features[11] == 1.0f);
+    }
+}
+
+TEST_CASE("AutopilotTerminal", "[Autopilot][Terminal]")
+{
+    SnakeGame game = SnakeGameBuilder{}.with_board(20, 20).build();
+
+    SECTION("policy steers the snake")
+    {
+        // only the output bias of Down is set - the policy prefers it whatever it observes
+        MlpPolicy::Genome genome(MlpPolicy::genome_size);
+        genome[MlpPolicy::genome_size - MlpPolicy::output_size + static_cast<size_t>(Direction::Down)] = 1.0f;
+
+        ScriptedTerminal terminal({Terminal::Key::Up}, ScriptedTerminal::Replay::Loop);
+        AutopilotTerminal autopilot(terminal, game, MlpPolicy{std::move(genome)});
+
+        REQUIRE(autopilot.read_key() == Terminal::Key::Down);
+    }
+
+    SECTION("user can quit with Ctrl_Q")
+    {
+        ScriptedTerminal terminal({});
+        AutopilotTerminal autopilot(terminal, game, MlpPolicy{sample_genome()});
+
+        REQUIRE(autopilot.read_key() == Terminal::Key::Ctrl_Q);
+    }
+}
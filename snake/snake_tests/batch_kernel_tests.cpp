@@ -0,0 +1,142 @@
+#include "snake/batch_kernel.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <random>
+#include <vector>
+
+CATCH_REGISTER_ENUM(SimdLevel, SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2);
+
+namespace
+{
+    constexpr int tile_size = 10;
+    constexpr int tiles_per_row = 10;
+    constexpr int board_size = tile_size * tiles_per_row - 1; // heads of the last tiles can reach the wall
+
+    // random self-avoiding path inside the interior of a tile - tiles are separated by one free cell,
+    // so a head moved by one cell never reaches a body of a snake from other tile
+    std::vector<Point> random_body(int tile, std::mt19937& gen)
+    {
+        const int min_x = (tile % tiles_per_row) * tile_size + 1;
+        const int min_y = (tile / tiles_per_row) * tile_size + 1;
+        const int max_x = min_x + tile_size - 3;
+        const int max_y = min_y + tile_size - 3;
+
+        std::uniform_int_distribution<> x_distr(min_x, max_x);
+        std::uniform_int_distribution<> y_distr(min_y, max_y);
+        std::uniform_int_distribution<size_t> length_distr(1, 8);
+
+        std::vector<Point> body{Point(x_distr(gen), y_distr(gen))};
+        const size_t length = length_distr(gen);
+
+        while (body.size() < length)
+        {
+            std::vector<Point> candidates;
+            for (Point next : {Point(body.back().x + 1, body.back().y), Point(body.back().x - 1, body.back().y),
+                     Point(body.back().x, body.back().y + 1), Point(body.back().x, body.back().y - 1)})
+            {
+                bool inside = next.x >= min_x && next.x <= max_x && next.y >= min_y && next.y <= max_y;
+                if (inside && std::find(body.begin(), body.end(), next) == body.end())
+                    candidates.push_back(next);
+            }
+
+            if (candidates.empty())
+                break;
+
+            body.push_back(candidates[std::uniform_int_distribution<size_t>(0, candidates.size() - 1)(gen)]);
+        }
+
+        return body;
+    }
+
+    // the snake grows along the body eating fruits - head ends at body.front()
+    Snake grow_snake(const std::vector<Point>& body)
+    {
+        Board board(board_size, board_size);
+        for (auto it = body.rbegin() + 1; it != body.rend(); ++it)
+            board.add_fruit(*it);
+
+        Snake snake{body.back()};
+        snake.set_board(board);
+
+        for (auto it = body.rbegin() + 1; it != body.rend(); ++it)
+        {
+            Point head = snake.head();
+            snake.move(it->x < head.x ? Direction::Left : it->x > head.x ? Direction::Right
+                                                        : it->y < head.y ? Direction::Up
+                                                                         : Direction::Down);
+        }
+
+        return snake;
+    }
+} // namespace
+
+TEST_CASE("Batch kernel gives the same results as Snake::move", "[BatchKernel]")
+{
+    auto level = GENERATE(SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2);
+    auto seed = GENERATE(range(0u, 20u));
+
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> direction_distr(0, 3);
+
+    const int snakes_count = tiles_per_row * tiles_per_row - static_cast<int>(seed % 8); // tails of batch vary
+
+    std::vector<Snake> snakes;
+    std::vector<int> head_x, head_y;
+    std::vector<Direction> directions;
+    ObstacleMap obstacles(board_size, board_size);
+
+    for (int tile = 0; tile < snakes_count; ++tile)
+    {
+        Snake snake = grow_snake(random_body(tile, gen));
+        REQUIRE(snake.is_alive());
+
+        // bodies without tails - they move away in this tick
+        for (auto it = snake.segments().begin(); it != snake.segments().end() - 1; ++it)
+            obstacles.set(*it);
+
+        head_x.push_back(snake.head().x);
+        head_y.push_back(snake.head().y);
+        directions.push_back(static_cast<Direction>(direction_distr(gen)));
+        snakes.push_back(snake);
+    }
+
+    std::vector<std::uint8_t> death_mask((snakes.size() + 7) / 8);
+    step_heads(head_x, head_y, directions, obstacles, death_mask, level);
+
+    DYNAMIC_SECTION("level " << Catch::StringMaker<SimdLevel>::convert(level) << ", seed " << seed)
+    {
+        for (size_t i = 0; i < snakes.size(); ++i)
+        {
+            Board board(board_size, board_size);
+            Snake snake = snakes[i];
+            snake.set_board(board);
+            snake.move(directions[i]);
+
+            INFO("snake " << i << ": " << snakes[i] << " moving " << Catch::StringMaker<Direction>::convert(directions[i]));
+            REQUIRE(Point(head_x[i], head_y[i]) == snake.head());
+            REQUIRE(((death_mask[i / 8] >> (i % 8)) & 1) == !snake.is_alive());
+        }
+    }
+}
+
+TEST_CASE("Batch kernel detects walls and obstacles", "[BatchKernel]")
+{
+    auto level = GENERATE(SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2);
+
+    ObstacleMap obstacles(10, 10);
+    obstacles.set({5, 4});
+
+    std::vector<int> head_x = {1, 9, 5, 5, 1, 9, 5, 5, 3};
+    std::vector<int> head_y = {5, 5, 1, 9, 5, 5, 5, 8, 3};
+    std::vector<Direction> directions = {Direction::Left, Direction::Right, Direction::Up, Direction::Down,
+        Direction::Right, Direction::Left, Direction::Up, Direction::Up, Direction::Down};
+    std::vector<std::uint8_t> death_mask(2);
+
+    step_heads(head_x, head_y, directions, obstacles, death_mask, level);
+
+    REQUIRE(death_mask[0] == 0b0100'1111); // 4 walls & obstacle at {5, 4}
+    REQUIRE(death_mask[1] == 0);
+    REQUIRE(head_x == std::vector{0, 10, 5, 5, 2, 8, 5, 5, 3});
+    REQUIRE(head_y == std::vector{5, 5, 0, 10, 5, 5, 4, 7, 4});
+}
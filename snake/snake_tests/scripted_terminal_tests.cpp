@@ -0,0 +1,71 @@
+#include "snake/scripted_terminal.hpp"
+#include "snake_game_builder.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <stop_token>
+
+using Key = Terminal::Key;
+
+TEST_CASE("ScriptedTerminal", "[ScriptedTerminal]")
+{
+    SECTION("feeds keys in the order of the script")
+    {
+        ScriptedTerminal terminal({Key::Left, Key::Down});
+
+        REQUIRE(terminal.read_key() == Key::Left);
+        REQUIRE(terminal.read_key() == Key::Down);
+    }
+
+    SECTION("when script is exhausted - returns Ctrl_Q")
+    {
+        ScriptedTerminal terminal({Key::Left});
+        terminal.read_key();
+
+        REQUIRE(terminal.read_key() == Key::Ctrl_Q);
+    }
+
+    SECTION("in loop mode - restarts the script")
+    {
+        ScriptedTerminal terminal({Key::Left, Key::Down}, ScriptedTerminal::Replay::Loop);
+        terminal.read_key();
+        terminal.read_key();
+
+        REQUIRE(terminal.read_key() == Key::Left);
+    }
+}
+
+TEST_CASE("Running the game with a scripted terminal", "[SnakeGame][Run][ScriptedTerminal]")
+{
+    ScriptedTerminal terminal({Key::Up, Key::Right, Key::Down, Key::Left}, ScriptedTerminal::Replay::Loop);
+
+    SnakeGame game = SnakeGameBuilder{}
+                         .with_board(10, 10)
+                         .with_terminal(terminal)
+                         .build();
+
+    SECTION("run stops after the tick limit")
+    {
+        size_t ticks = game.run(1'000);
+
+        REQUIRE(ticks == 1'000);
+        REQUIRE(terminal.frames() == 1'000);
+        REQUIRE(game.snake() == Snake{Point(5, 5)});
+    }
+
+    SECTION("run does not start when stop is requested")
+    {
+        std::stop_source stop_source;
+        stop_source.request_stop();
+
+        REQUIRE(game.run(1'000, stop_source.get_token()) == 0);
+    }
+
+    SECTION("run ends earlier when the game is over")
+    {
+        ScriptedTerminal deadly_terminal({Key::Left}, ScriptedTerminal::Replay::Loop);
+        game.set_terminal(deadly_terminal);
+
+        REQUIRE(game.run(1'000) == 5);
+        REQUIRE(game.is_over());
+    }
+}
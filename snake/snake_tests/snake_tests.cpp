@@ -25,7 +25,7 @@ TEST_CASE("Snake", "[Snake][Construction]")
 
         SECTION("has one segment")
         {
-            REQUIRE(snake.segments() == std::vector{Point(10, 5)});
+            REQUIRE(std::ranges::equal(snake.segments(), std::vector{Point(10, 5)}));
         }
     }
 
@@ -40,7 +40,7 @@ TEST_CASE("Snake", "[Snake][Construction]")
 
         SECTION("has multiple segments")
         {
-            REQUIRE(snake.segments() == std::vector{Point(10, 5), Point(10, 6), Point(10, 7)});
+            REQUIRE(std::ranges::equal(snake.segments(), std::vector{Point(10, 5), Point(10, 6), Point(10, 7)}));
         }
     }
 }
@@ -176,7 +176,7 @@ class MockTerminal : public Terminal
 {
 public:
     MAKE_MOCK1(render_snake, void(const Snake&), override);
-    MAKE_MOCK1(render_fruits, void(const std::vector<Point>& fruits), override);
+    MAKE_MOCK1(render_fruits, void(std::span<const Point> fruits), override);
     MAKE_MOCK3(render_text, void(int x, int y, const std::string& text), override);
     MAKE_MOCK0(read_key, Terminal::Key(), override);
     MAKE_MOCK0(flush, void(), override);
@@ -218,7 +218,7 @@ TEST_CASE("Rendering apples", "[ConsoleGame][Terminal][Run]")
     ALLOW_CALL(terminal, render_snake(trompeloeil::_));
     ALLOW_CALL(terminal, flush());
     ALLOW_CALL(terminal, read_key()).RETURN(Terminal::Key::Ctrl_Q);
-    REQUIRE_CALL(terminal, render_fruits(std::vector{Point{2, 2}, Point{3, 3}}));
+    REQUIRE_CALL(terminal, render_fruits(trompeloeil::_)).WITH(std::ranges::equal(_1, std::vector{Point{2, 2}, Point{3, 3}}));
     game.run();
 }
 
@@ -341,4 +341,58 @@ TEST_CASE("Populate the game with fruits", "[SnakeGame]")
     game.populate_with_fruits(5);
 
     REQUIRE(game.board().fruits().size() == 5);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Game allocated from a memory resource", "[SnakeGame][Allocation]")
+{
+    std::array<std::byte, 1024> buffer;
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+    SnakeGame game(20, 20, &arena);
+
+    SECTION("board and snake use the given resource")
+    {
+        REQUIRE(game.board().resource() == &arena);
+        REQUIRE(game.snake().segments().get_allocator().resource() == &arena);
+    }
+
+    SECTION("snake is at the center of the board")
+    {
+        REQUIRE(game.snake() == Snake{Point(10, 10)});
+    }
+}
+
+TEST_CASE("Game of a board & snake keeps their memory resource", "[SnakeGame][Allocation]")
+{
+    std::array<std::byte, 1024> buffer;
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+    Board board(20, 20, &arena);
+    board.add_fruit({3, 3});
+    Snake snake({Point(5, 5), Point(5, 6)}, &arena);
+
+    SECTION("copied")
+    {
+        SnakeGame game(board, snake);
+
+        REQUIRE(game.board().resource() == &arena);
+        REQUIRE(game.snake().segments().get_allocator().resource() == &arena);
+        REQUIRE(std::ranges::equal(game.board().fruits(), std::vector{Point(3, 3)}));
+        REQUIRE(game.snake() == snake);
+    }
+
+    SECTION("moved")
+    {
+        SnakeGame game(std::move(board), std::move(snake));
+
+        REQUIRE(game.board().resource() == &arena);
+        REQUIRE(game.snake().segments().get_allocator().resource() == &arena);
+    }
+
+    SECTION("board only")
+    {
+        SnakeGame game(board);
+
+        REQUIRE(game.snake().segments().get_allocator().resource() == &arena);
+    }
+}
@@ -0,0 +1,97 @@
+#include "snake/trainer.hpp"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <numeric>
+
+namespace
+{
+    TrainerSettings small_settings(unsigned threads = 1)
+    {
+        TrainerSettings settings;
+        settings.population_size = 16;
+        settings.elite_count = 3;
+        settings.games_per_genome = 4;
+        settings.board_width = 10;
+        settings.board_height = 10;
+        settings.fruits_per_game = 5;
+        settings.max_steps = 100;
+        settings.starvation_steps = 30;
+        settings.threads = threads;
+        settings.seed = 7;
+        return settings;
+    }
+} // namespace
+
+TEST_CASE("Trainer evaluates a policy", "[Trainer][Evaluate]")
+{
+    const TrainerSettings settings = small_settings();
+    Trainer trainer{settings};
+    const MlpPolicy policy{trainer.population().front()};
+
+    SECTION("same seed gives the same score")
+    {
+        REQUIRE(Trainer::evaluate(policy, settings, 123) == Trainer::evaluate(policy, settings, 123));
+    }
+
+    SECTION("game without fruits ends after the first step")
+    {
+        TrainerSettings no_fruits = settings;
+        no_fruits.fruits_per_game = 0;
+
+        REQUIRE(Trainer::evaluate(policy, no_fruits, 123) == 0.1f);
+    }
+}
+
+TEST_CASE("Trainer breeds the next generation", "[Trainer][Generation]")
+{
+    const TrainerSettings settings = small_settings();
+    Trainer trainer{settings};
+    const auto previous_population = trainer.population();
+
+    const GenerationStats stats = trainer.next_generation();
+    const std::vector<float>& fitness = trainer.fitness();
+
+    std::vector<size_t> ranking(fitness.size());
+    std::iota(ranking.begin(), ranking.end(), 0);
+    std::stable_sort(ranking.begin(), ranking.end(), [&](size_t a, size_t b) { return fitness[a] > fitness[b]; });
+
+    SECTION("stats follow the fitness ordering")
+    {
+        REQUIRE(stats.generation == 0);
+        REQUIRE(stats.best_fitness == *std::max_element(fitness.begin(), fitness.end()));
+        REQUIRE(stats.best_fitness >= stats.mean_fitness);
+        REQUIRE(trainer.best_fitness() == stats.best_fitness);
+    }
+
+    SECTION("elites survive unchanged")
+    {
+        // the fittest genomes in order - equally fit ones in their order in the population
+        for (size_t i = 0; i < settings.elite_count; ++i)
+            REQUIRE(trainer.population()[i] == previous_population[ranking[i]]);
+
+        REQUIRE(trainer.best() == previous_population[ranking.front()]);
+    }
+
+    SECTION("population keeps its size")
+    {
+        REQUIRE(trainer.population().size() == settings.population_size);
+    }
+}
+
+TEST_CASE("Training does not depend on the number of threads", "[Trainer][Generation]")
+{
+    Trainer single{small_settings(1)};
+    Trainer parallel{small_settings(4)};
+
+    for (int generation = 0; generation < 3; ++generation)
+    {
+        const GenerationStats single_stats = single.next_generation();
+        const GenerationStats parallel_stats = parallel.next_generation();
+
+        REQUIRE(single_stats.best_fitness == parallel_stats.best_fitness);
+        REQUIRE(single_stats.mean_fitness == parallel_stats.mean_fitness);
+    }
+
+    REQUIRE(single.population() == parallel.population());
+}
@@ -0,0 +1,77 @@
+#include <charconv>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <snake/trainer.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+using namespace std;
+
+// usage: snake-trainer [generations] [output-genome-file]
+int main(int argc, char* argv[])
+{
+    size_t generations = 100;
+    if (argc > 1)
+    {
+        const std::string_view arg = argv[1];
+        const auto [end, error] = std::from_chars(arg.data(), arg.data() + arg.size(), generations);
+        if (error != std::errc{} || end != arg.data() + arg.size() || generations == 0)
+        {
+            cerr << "Invalid number of generations " << arg << "\nusage: snake-trainer [generations] [output-genome-file]\n";
+            return 1;
+        }
+    }
+
+    const std::filesystem::path output_path = argc > 2 ? argv[2] : "best.genome";
+
+    TrainerSettings settings;
+    Trainer trainer(settings);
+
+    cout << "Population: " << settings.population_size << ", games per genome: " << settings.games_per_genome
+         << ", threads: " << settings.threads << "\n";
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < generations; ++i)
+    {
+        GenerationStats stats = trainer.next_generation();
+
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+        cout << "Generation " << stats.generation
+             << " - best: " << stats.best_fitness
+             << ", mean: " << stats.mean_fitness
+             << ", " << (i + 1) / elapsed.count() << " generations/s\n";
+    }
+
+    // written next to the output & renamed over it - an interrupted or failed write keeps the previous genome
+    std::filesystem::path temp_path = output_path;
+    temp_path += ".tmp";
+    try
+    {
+        std::ofstream out(temp_path, std::ios::binary);
+        if (!out.is_open())
+            throw std::runtime_error("Cannot open " + temp_path.string());
+
+        save_genome(out, trainer.best());
+        out.close();
+        if (!out)
+            throw std::runtime_error("Cannot close " + temp_path.string());
+
+        std::filesystem::rename(temp_path, output_path);
+    }
+    catch (const std::exception& e)
+    {
+        std::error_code ignored;
+        std::filesystem::remove(temp_path, ignored);
+
+        cerr << "Cannot write genome file " << output_path.string() << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    cout << "Best genome (fitness " << trainer.best_fitness() << ") saved to " << output_path.string() << "\n";
+}